@@ -6,6 +6,20 @@
 
 #include "fips202.h"
 #include "fips202x2.h"
+#include "fips202x3.h"
+#include "fips202x4.h"
+#include "fips202xN.h"
+#include "fips202batch.h"
+#include "fips202pool.h"
+#include "kangarootwelve.h"
+#include "sp800185.h"
+#include "mlkem.h"
+#include "mldsa.h"
+#include "slhdsa.h"
+#include "merkle.h"
+#include <cstring>
+#include <thread>
+#include <vector>
 
 
 static void BM_F1600x2(benchmark::State& state) {
@@ -16,6 +30,84 @@ static void BM_F1600x2(benchmark::State& state) {
     }
 }
 
+static void BM_F1600x2_kernel(benchmark::State& state, const char *name) {
+    v128 a[25] = {0};
+    const char *active = keccakx2_get_kernel();
+    if (keccakx2_set_kernel(name)) {
+        state.SkipWithError("kernel not supported on this CPU");
+        return;
+    }
+    for (auto _ : state) {
+        KeccakF1600_StatePermutex2(&a[0]);
+        benchmark::DoNotOptimize(a);
+    }
+    keccakx2_set_kernel(active);
+}
+
+// sha3_256x2 on range(0)-byte inputs on one kernel, e.g. sha3 vs sha3_asm
+static void BM_SHA3_256x2_kernel(benchmark::State& state, const char *name) {
+    std::vector<uint8_t> in0(state.range(0)), in1(state.range(0));
+    static uint8_t h0[32], h1[32];
+    const char *active = keccakx2_get_kernel();
+    if (keccakx2_set_kernel(name)) {
+        state.SkipWithError("kernel not supported on this CPU");
+        return;
+    }
+    for (auto _ : state) {
+        sha3_256x2(h0, h1, in0.data(), in1.data(), state.range(0));
+        benchmark::DoNotOptimize(h0);
+        benchmark::DoNotOptimize(h1);
+    }
+    keccakx2_set_kernel(active);
+    state.SetBytesProcessed(state.iterations() * 2 * state.range(0));
+}
+
+// shake128x2 from 32-byte seeds to range(0) bytes on one kernel
+static void BM_SHAKE128x2_kernel(benchmark::State& state, const char *name) {
+    std::vector<uint8_t> out0(state.range(0)), out1(state.range(0));
+    static uint8_t seed0[32], seed1[32];
+    const char *active = keccakx2_get_kernel();
+    if (keccakx2_set_kernel(name)) {
+        state.SkipWithError("kernel not supported on this CPU");
+        return;
+    }
+    for (auto _ : state) {
+        shake128x2(out0.data(), out1.data(), state.range(0), seed0, seed1, sizeof(seed0));
+        benchmark::DoNotOptimize(out0.data());
+        benchmark::DoNotOptimize(out1.data());
+    }
+    keccakx2_set_kernel(active);
+    state.SetBytesProcessed(state.iterations() * 2 * state.range(0));
+}
+
+static void BM_F1600x3(benchmark::State& state) {
+    v128 a[25] = {0};
+    uint64_t b[25] = {0};
+    for (auto _ : state) {
+        KeccakF1600_StatePermutex3(&a[0], b);
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+    }
+}
+
+static void BM_F1600x4(benchmark::State& state) {
+    v128 a[25] = {0}, b[25] = {0};
+    for (auto _ : state) {
+        KeccakF1600_StatePermutex4(&a[0], &b[0]);
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+    }
+}
+
+static void BM_F1600xN(benchmark::State& state) {
+    static uint64_t a[25 * KECCAKXN_MAX_LANES] = {0};
+    for (auto _ : state) {
+        KeccakF1600_StatePermutexN(a);
+        benchmark::DoNotOptimize(a);
+    }
+    state.counters["lanes"] = keccakxN_lanes();
+}
+
 static void BM_F1600(benchmark::State& state) {
     uint64_t a[25] = {0};
     for (auto _ : state) {
@@ -24,6 +116,372 @@ static void BM_F1600(benchmark::State& state) {
     }
 }
 
+static void BM_SHA3x2(benchmark::State& state,
+                      void (*f)(uint8_t *, uint8_t *, const uint8_t *,
+                                const uint8_t *, size_t)) {
+    std::vector<uint8_t> in0(state.range(0)), in1(state.range(0));
+    static uint8_t h0[64], h1[64];
+    for (auto _ : state) {
+        f(h0, h1, in0.data(), in1.data(), state.range(0));
+        benchmark::DoNotOptimize(h0);
+        benchmark::DoNotOptimize(h1);
+    }
+    state.SetBytesProcessed(state.iterations() * 2 * state.range(0));
+}
+
+static void BM_SHA3x2_fixed(benchmark::State& state,
+                            void (*f)(uint8_t *, uint8_t *, const uint8_t *,
+                                      const uint8_t *)) {
+    static uint8_t in0[64], in1[64], h0[64], h1[64];
+    for (auto _ : state) {
+        f(h0, h1, in0, in1);
+        benchmark::DoNotOptimize(h0);
+        benchmark::DoNotOptimize(h1);
+    }
+}
+
+// range(0) bytes per call from one SHAKE128 stream per lane
+static void BM_SHAKE128x2_squeeze(benchmark::State& state) {
+    static uint8_t seed0[34], seed1[34], out0[512], out1[512];
+    keccakx2_state s;
+    shake128x2_absorb(&s, seed0, seed1, sizeof(seed0));
+    for (auto _ : state) {
+        shake128x2_squeeze(out0, out1, state.range(0), &s);
+        benchmark::DoNotOptimize(out0);
+        benchmark::DoNotOptimize(out1);
+    }
+    state.SetBytesProcessed(state.iterations() * 2 * state.range(0));
+}
+
+// Whole blocks, about range(0) bytes per lane per call
+static void BM_SHAKE128x2_keystream(benchmark::State& state) {
+    const size_t nblocks = state.range(0) / SHAKE128_RATE;
+    std::vector<uint8_t> out0(nblocks * SHAKE128_RATE), out1(nblocks * SHAKE128_RATE);
+    static uint8_t seed0[32], seed1[32];
+    keccakx2_state s;
+    shake128x2_absorb(&s, seed0, seed1, sizeof(seed0));
+    for (auto _ : state) {
+        shake128x2_squeezeblocks(out0.data(), out1.data(), nblocks, &s);
+        benchmark::DoNotOptimize(out0.data());
+        benchmark::DoNotOptimize(out1.data());
+    }
+    state.SetBytesProcessed(state.iterations() * 2 * nblocks * SHAKE128_RATE);
+}
+
+static void BM_SHAKE128x2_keystream_interleaved(benchmark::State& state) {
+    const size_t nblocks = state.range(0) / SHAKE128_RATE;
+    std::vector<uint8_t> out(2 * nblocks * SHAKE128_RATE);
+    static uint8_t seed[64];
+    keccakx2_state s;
+    shake128x2_absorb_interleaved(&s, seed, 32);
+    for (auto _ : state) {
+        shake128x2_squeezeblocks_interleaved(out.data(), nblocks, &s);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * 2 * nblocks * SHAKE128_RATE);
+}
+
+static void BM_MLKEM_gen_matrix(benchmark::State& state) {
+    static int16_t a[16 * MLKEM_N];
+    static uint8_t rho[MLKEM_SYMBYTES];
+    for (auto _ : state) {
+        mlkem_gen_matrix(a, rho, state.range(0), 0);
+        benchmark::DoNotOptimize(a);
+    }
+}
+
+// ML-DSA-44, -65 and -87: (k, l), (l, k, eta), (l, gamma1)
+static void BM_MLDSA_expand_a(benchmark::State& state) {
+    static int32_t a[8 * 7 * MLDSA_N];
+    static uint8_t rho[MLDSA_SEEDBYTES];
+    for (auto _ : state) {
+        mldsa_expand_a(a, rho, state.range(0), state.range(1));
+        benchmark::DoNotOptimize(a);
+    }
+}
+
+static void BM_MLDSA_expand_s(benchmark::State& state) {
+    static int32_t s1[7 * MLDSA_N], s2[8 * MLDSA_N];
+    static uint8_t rhoprime[MLDSA_CRHBYTES];
+    for (auto _ : state) {
+        mldsa_expand_s(s1, s2, rhoprime, state.range(0), state.range(1),
+                       state.range(2));
+        benchmark::DoNotOptimize(s1);
+        benchmark::DoNotOptimize(s2);
+    }
+}
+
+static void BM_MLDSA_expand_mask(benchmark::State& state) {
+    static int32_t y[7 * MLDSA_N];
+    static uint8_t rhoprime[MLDSA_CRHBYTES];
+    for (auto _ : state) {
+        mldsa_expand_mask(y, rhoprime, 0, state.range(0), state.range(1));
+        benchmark::DoNotOptimize(y);
+    }
+}
+
+// SLH-DSA F (one n-byte block) with n = range(0)
+static void BM_SLHDSA_thash_x2(benchmark::State& state) {
+    static uint8_t seed[32], addr0[32], addr1[32], m0[32], m1[32];
+    slhdsa_ctx ctx;
+    slhdsa_ctx_init(&ctx, seed, state.range(0));
+    for (auto _ : state) {
+        slhdsa_thash_x2(m0, m1, m0, m1, 1, &ctx, addr0, addr1);
+        benchmark::DoNotOptimize(m0);
+        benchmark::DoNotOptimize(m1);
+    }
+}
+
+// The same input through the generic sponge
+static void BM_SLHDSA_shake256x2(benchmark::State& state) {
+    static uint8_t in0[96], in1[96];
+    for (auto _ : state) {
+        shake256x2(&in0[64], &in1[64], state.range(0), in0, in1,
+                   2 * state.range(0) + 32);
+        benchmark::DoNotOptimize(in0);
+        benchmark::DoNotOptimize(in1);
+    }
+}
+
+// 64 messages of 0 to 1000 bytes
+static void BM_SHA3_256_batch(benchmark::State& state) {
+    static uint8_t in[64][1024], h[64][32];
+    const uint8_t *inp[64];
+    uint8_t *hp[64];
+    size_t inlen[64];
+    for (int i = 0; i < 64; ++i) {
+        inp[i] = in[i];
+        hp[i] = h[i];
+        inlen[i] = (i * 389) % 1001;
+    }
+    for (auto _ : state) {
+        sha3_256_batch(hp, inp, inlen, 64);
+        benchmark::DoNotOptimize(h);
+    }
+}
+
+static void BM_SHA3_256_single(benchmark::State& state) {
+    static uint8_t in[64][1024], h[64][32];
+    for (auto _ : state) {
+        for (int i = 0; i < 64; ++i)
+            sha3_256(h[i], in[i], (i * 389) % 1001);
+        benchmark::DoNotOptimize(h);
+    }
+}
+
+// 4096 messages of 0 to 1000 bytes on state.range(0) threads
+static void BM_SHA3_256_batch_mt(benchmark::State& state) {
+    const size_t n = 4096;
+    static uint8_t in[n][1024], h[n][32];
+    static const uint8_t *inp[n];
+    static uint8_t *hp[n];
+    static size_t inlen[n];
+    for (size_t i = 0; i < n; ++i) {
+        inp[i] = in[i];
+        hp[i] = h[i];
+        inlen[i] = (i * 389) % 1001;
+    }
+    keccak_pool *pool = keccak_pool_create(state.range(0));
+    if (pool == NULL) {
+        state.SkipWithError("keccak_pool_create failed");
+        return;
+    }
+    for (auto _ : state) {
+        sha3_256_batch_mt(pool, hp, inp, inlen, n);
+        benchmark::DoNotOptimize(h);
+    }
+    keccak_pool_destroy(pool);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// 1, 2, 4, ... up to the number of CPUs
+static void ThreadCounts(benchmark::internal::Benchmark *b) {
+    int ncpus = std::thread::hardware_concurrency();
+    for (int t = 1; t < ncpus; t *= 2)
+        b->Arg(t);
+    b->Arg(ncpus > 0 ? ncpus : 1);
+}
+
+// Merkle tree over state.range(0) leaves of 32 bytes, one sha3_256 per node
+static void BM_Merkle_scalar(benchmark::State& state) {
+    const size_t n = state.range(0);
+    std::vector<uint8_t> leaves(n * 32), nodes(2 * n * 32);
+    uint8_t buf[65];
+    for (auto _ : state) {
+        buf[0] = 0x00;
+        for (size_t i = 0; i < n; ++i) {
+            memcpy(&buf[1], &leaves[i * 32], 32);
+            sha3_256(&nodes[i * 32], buf, 33);
+        }
+        buf[0] = 0x01;
+        size_t in = 0, out = n;
+        for (size_t m = n; m > 1; m = (m + 1) / 2) {
+            for (size_t i = 0; i < m; i += 2) {
+                if (i + 1 < m) {
+                    memcpy(&buf[1], &nodes[(in + i) * 32], 64);
+                    sha3_256(&nodes[(out + i / 2) * 32], buf, 65);
+                } else
+                    memcpy(&nodes[(out + i / 2) * 32], &nodes[(in + i) * 32], 32);
+            }
+            in = out;
+            out += (m + 1) / 2;
+        }
+        benchmark::DoNotOptimize(nodes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// The same tree two nodes at a time, on a pool of state.range(1) threads
+static void BM_Merkle(benchmark::State& state) {
+    const size_t n = state.range(0);
+    std::vector<uint8_t> leaves(n * 32);
+    keccak_pool *pool = NULL;
+    merkle_tree tree;
+    if (state.range(1) > 0) {
+        pool = keccak_pool_create(state.range(1));
+        if (pool == NULL) {
+            state.SkipWithError("keccak_pool_create failed");
+            return;
+        }
+    }
+    for (auto _ : state) {
+        if (merkle_tree_build(&tree, leaves.data(), 32, n, pool) != 0) {
+            state.SkipWithError("merkle_tree_build failed");
+            break;
+        }
+        benchmark::DoNotOptimize(merkle_root(&tree));
+        merkle_tree_free(&tree);
+    }
+    if (pool != NULL)
+        keccak_pool_destroy(pool);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// 2^10 to 2^24 leaves, without a pool and on every CPU
+static void MerkleSizes(benchmark::internal::Benchmark *b) {
+    int ncpus = std::thread::hardware_concurrency();
+    for (int64_t n = 1 << 10; n <= 1 << 24; n <<= 2) {
+        b->Args({n, 0});
+        b->Args({n, ncpus > 0 ? ncpus : 1});
+    }
+}
+
+// Multi-megabyte messages, state.range(0) MiB
+static void BM_KT128(benchmark::State& state) {
+    const size_t len = state.range(0) << 20;
+    static uint8_t in[16 << 20], h[32];
+    for (auto _ : state) {
+        kangarootwelve(h, 32, in, len, NULL, 0);
+        benchmark::DoNotOptimize(h);
+    }
+    state.SetBytesProcessed(state.iterations() * len);
+}
+
+static void BM_SHA3_256_long(benchmark::State& state) {
+    const size_t len = state.range(0) << 20;
+    static uint8_t in[16 << 20], h[32];
+    for (auto _ : state) {
+        sha3_256(h, in, len);
+        benchmark::DoNotOptimize(h);
+    }
+    state.SetBytesProcessed(state.iterations() * len);
+}
+
+// 4 MiB message, block size state.range(0) bytes
+static void BM_ParallelHash128(benchmark::State& state) {
+    const size_t len = 4 << 20;
+    static uint8_t in[4 << 20], h[32];
+    for (auto _ : state) {
+        parallelhash128(h, 32, in, len, state.range(0), NULL, 0);
+        benchmark::DoNotOptimize(h);
+    }
+    state.SetBytesProcessed(state.iterations() * len);
+}
+
+static void BM_ParallelHash256(benchmark::State& state) {
+    const size_t len = 4 << 20;
+    static uint8_t in[4 << 20], h[64];
+    for (auto _ : state) {
+        parallelhash256(h, 64, in, len, state.range(0), NULL, 0);
+        benchmark::DoNotOptimize(h);
+    }
+    state.SetBytesProcessed(state.iterations() * len);
+}
+
+static void BM_KMAC128x2(benchmark::State& state) {
+    static uint8_t key[32], in0[64], in1[64], t0[32], t1[32];
+    kmac_key k;
+    kmac128_init_key(&k, key, sizeof(key), NULL, 0);
+    for (auto _ : state) {
+        kmac128x2(&k, t0, t1, 32, in0, in1, state.range(0));
+        benchmark::DoNotOptimize(t0);
+        benchmark::DoNotOptimize(t1);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+static void BM_KMAC128_rekey(benchmark::State& state) {
+    static uint8_t key[32], in0[64], in1[64], t0[32], t1[32];
+    for (auto _ : state) {
+        kmac_key k;
+        kmac128_init_key(&k, key, sizeof(key), NULL, 0);
+        kmac128x2(&k, t0, t1, 32, in0, in1, state.range(0));
+        benchmark::DoNotOptimize(t0);
+        benchmark::DoNotOptimize(t1);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
 BENCHMARK(BM_F1600x2);
+BENCHMARK_CAPTURE(BM_F1600x2_kernel, sha3, "sha3");
+BENCHMARK_CAPTURE(BM_F1600x2_kernel, neon, "neon");
+BENCHMARK_CAPTURE(BM_F1600x2_kernel, sha3_asm, "sha3_asm");
+BENCHMARK_CAPTURE(BM_F1600x2_kernel, neon_asm, "neon_asm");
+BENCHMARK_CAPTURE(BM_F1600x2_kernel, avx2, "avx2");
+BENCHMARK_CAPTURE(BM_F1600x2_kernel, sse2, "sse2");
+BENCHMARK_CAPTURE(BM_F1600x2_kernel, scalar, "scalar");
+BENCHMARK_CAPTURE(BM_SHA3_256x2_kernel, sha3, "sha3")->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_SHA3_256x2_kernel, neon, "neon")->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_SHA3_256x2_kernel, sha3_asm, "sha3_asm")->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_SHA3_256x2_kernel, neon_asm, "neon_asm")->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_SHA3_256x2_kernel, avx2, "avx2")->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_SHA3_256x2_kernel, sse2, "sse2")->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_SHA3_256x2_kernel, scalar, "scalar")->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_SHAKE128x2_kernel, sha3, "sha3")->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_SHAKE128x2_kernel, neon, "neon")->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_SHAKE128x2_kernel, sha3_asm, "sha3_asm")->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_SHAKE128x2_kernel, neon_asm, "neon_asm")->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_SHAKE128x2_kernel, avx2, "avx2")->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_SHAKE128x2_kernel, sse2, "sse2")->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_SHAKE128x2_kernel, scalar, "scalar")->Arg(1024)->Arg(1 << 20);
+BENCHMARK(BM_F1600x3);
+BENCHMARK(BM_F1600x4);
+BENCHMARK(BM_F1600xN);
 BENCHMARK(BM_F1600);
+BENCHMARK_CAPTURE(BM_SHA3x2, sha3_224, sha3_224x2)->Arg(1024);
+BENCHMARK_CAPTURE(BM_SHA3x2, sha3_256, sha3_256x2)->Arg(32)->Arg(1024)->Arg(1 << 20);
+BENCHMARK_CAPTURE(BM_SHA3x2, sha3_384, sha3_384x2)->Arg(1024);
+BENCHMARK_CAPTURE(BM_SHA3x2, sha3_512, sha3_512x2)->Arg(64)->Arg(1024);
+BENCHMARK_CAPTURE(BM_SHA3x2_fixed, sha3_256_32, sha3_256x2_32);
+BENCHMARK_CAPTURE(BM_SHA3x2_fixed, sha3_512_64, sha3_512x2_64);
+BENCHMARK(BM_SHAKE128x2_squeeze)->Arg(3)->Arg(64)->Arg(500);
+BENCHMARK(BM_SHAKE128x2_keystream)->Arg(64 << 10)->Arg(4 << 20);
+BENCHMARK(BM_SHAKE128x2_keystream_interleaved)->Arg(64 << 10)->Arg(4 << 20);
+BENCHMARK(BM_MLKEM_gen_matrix)->DenseRange(2, 4);
+BENCHMARK(BM_MLDSA_expand_a)->Args({4, 4})->Args({6, 5})->Args({8, 7});
+BENCHMARK(BM_MLDSA_expand_s)->Args({4, 4, 2})->Args({5, 6, 4})->Args({7, 8, 2});
+BENCHMARK(BM_MLDSA_expand_mask)->Args({4, 1 << 17})->Args({5, 1 << 19})->Args({7, 1 << 19});
+BENCHMARK(BM_SLHDSA_thash_x2)->Arg(16)->Arg(32);
+BENCHMARK(BM_SLHDSA_shake256x2)->Arg(16)->Arg(32);
+BENCHMARK(BM_SHA3_256_batch);
+BENCHMARK(BM_SHA3_256_single);
+BENCHMARK(BM_KT128)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK(BM_SHA3_256_long)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK(BM_ParallelHash128)->RangeMultiplier(2)->Range(1 << 10, 64 << 10);
+BENCHMARK(BM_ParallelHash256)->RangeMultiplier(2)->Range(1 << 10, 64 << 10);
+BENCHMARK(BM_KMAC128x2)->Arg(16)->Arg(64);
+BENCHMARK(BM_KMAC128_rekey)->Arg(16)->Arg(64);
+BENCHMARK(BM_SHA3_256_batch_mt)->Apply(ThreadCounts)->UseRealTime();
+BENCHMARK(BM_Merkle_scalar)->RangeMultiplier(4)->Range(1 << 10, 1 << 24)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Merkle)->Apply(MerkleSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
 BENCHMARK_MAIN();
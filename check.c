@@ -0,0 +1,314 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#include <stdio.h>
+#include <string.h>
+#include "fips202.h"
+#include "fips202x2.h"
+#include "fips202xN.h"
+
+/*
+Usage: check
+Hashes distinct messages in every lane with each 2-way and N-way kernel
+this CPU supports and compares every lane against fips202.c. The N-way
+lane count is the SVE vector length, run under
+qemu-aarch64 -cpu max,sve-default-vector-length= to cover several, and
+a 32-bit Arm build under qemu-arm. Prints one line per kernel, exits 1
+on any mismatch.
+*/
+
+#define MAXIN 1000
+#define MAXOUT 512
+
+static const char *const kernels_x2[] = {"sha3", "neon", "sha3_asm", "neon_asm", "avx2", "sse2", "scalar"};
+static const char *const kernels_xN[] = {"sve2", "sve", "x2"};
+
+// Across the SHA3-512, SHA3-256/SHAKE256 and SHAKE128 rates
+static const size_t inlens[] = {0, 1, 71, 72, 73, 135, 136, 137, 167, 168, 169, MAXIN};
+static const size_t outlens[] = {1, 32, 136, 168, 169, MAXOUT};
+
+#define NELEMS(a) (sizeof(a) / sizeof((a)[0]))
+
+static uint8_t in[KECCAKXN_MAX_LANES][MAXIN];
+static uint8_t out[KECCAKXN_MAX_LANES][MAXOUT];
+static uint8_t ref[MAXOUT];
+static uint8_t il[2 * (MAXIN + 8)];
+
+static int fail(const char *kernel, const char *what, unsigned int lane, size_t inlen, size_t outlen)
+{
+  printf("%s: %s mismatch in lane %u, inlen %zu, outlen %zu\n",
+         kernel, what, lane, inlen, outlen);
+  return 1;
+}
+
+/*************************************************
+ * Name:        check_x2
+ *
+ * Description: Compares sha3_256x2, sha3_512x2, shake128x2,
+ *              shake256x2, their absorb/squeeze, interleaved and
+ *              fixed-length variants with the active 2-way kernel
+ *              against fips202.c
+ *
+ * Arguments:   - const char *kernel: name of the active kernel
+ *
+ * Returns the number of mismatches
+ **************************************************/
+static int check_x2(const char *kernel)
+{
+  keccakx2_state state;
+  size_t i, j;
+  unsigned int l;
+  int errors = 0;
+
+  for (i = 0; i < NELEMS(inlens); ++i)
+  {
+    size_t inlen = inlens[i];
+
+    sha3_256x2(out[0], out[1], in[0], in[1], inlen);
+    for (l = 0; l < 2; ++l)
+    {
+      sha3_256(ref, in[l], inlen);
+      if (memcmp(out[l], ref, 32))
+        errors += fail(kernel, "sha3_256x2", l, inlen, 32);
+    }
+
+    sha3_512x2(out[0], out[1], in[0], in[1], inlen);
+    for (l = 0; l < 2; ++l)
+    {
+      sha3_512(ref, in[l], inlen);
+      if (memcmp(out[l], ref, 64))
+        errors += fail(kernel, "sha3_512x2", l, inlen, 64);
+    }
+
+    for (j = 0; j < NELEMS(outlens); ++j)
+    {
+      size_t outlen = outlens[j];
+
+      shake128x2(out[0], out[1], outlen, in[0], in[1], inlen);
+      for (l = 0; l < 2; ++l)
+      {
+        shake128(ref, outlen, in[l], inlen);
+        if (memcmp(out[l], ref, outlen))
+          errors += fail(kernel, "shake128x2", l, inlen, outlen);
+      }
+
+      shake256x2(out[0], out[1], outlen, in[0], in[1], inlen);
+      for (l = 0; l < 2; ++l)
+      {
+        shake256(ref, outlen, in[l], inlen);
+        if (memcmp(out[l], ref, outlen))
+          errors += fail(kernel, "shake256x2", l, inlen, outlen);
+      }
+    }
+
+    // Three blocks, the second and third squeezed separately
+    shake128x2_absorb(&state, in[0], in[1], inlen);
+    shake128x2_squeezeblocks(out[0], out[1], 1, &state);
+    shake128x2_squeezeblocks(out[0] + SHAKE128_RATE, out[1] + SHAKE128_RATE, 2, &state);
+    for (l = 0; l < 2; ++l)
+    {
+      shake128(ref, 3 * SHAKE128_RATE, in[l], inlen);
+      if (memcmp(out[l], ref, 3 * SHAKE128_RATE))
+        errors += fail(kernel, "shake128x2_squeezeblocks", l, inlen, 3 * SHAKE128_RATE);
+    }
+
+    shake256x2_absorb(&state, in[0], in[1], inlen);
+    shake256x2_squeezeblocks(out[0], out[1], 1, &state);
+    shake256x2_squeezeblocks(out[0] + SHAKE256_RATE, out[1] + SHAKE256_RATE, 2, &state);
+    for (l = 0; l < 2; ++l)
+    {
+      shake256(ref, 3 * SHAKE256_RATE, in[l], inlen);
+      if (memcmp(out[l], ref, 3 * SHAKE256_RATE))
+        errors += fail(kernel, "shake256x2_squeezeblocks", l, inlen, 3 * SHAKE256_RATE);
+    }
+
+    // 3, then 200 bytes, across a block boundary
+    shake128x2_absorb(&state, in[0], in[1], inlen);
+    shake128x2_squeeze(out[0], out[1], 3, &state);
+    shake128x2_squeeze(out[0] + 3, out[1] + 3, 200, &state);
+    for (l = 0; l < 2; ++l)
+    {
+      shake128(ref, 203, in[l], inlen);
+      if (memcmp(out[l], ref, 203))
+        errors += fail(kernel, "shake128x2_squeeze", l, inlen, 203);
+    }
+
+    // Word w of lane l at il[16 * w + 8 * l]
+    for (j = 0; j < inlen; ++j)
+      for (l = 0; l < 2; ++l)
+        il[16 * (j / 8) + 8 * l + j % 8] = in[l][j];
+    shake128x2_absorb_interleaved(&state, il, inlen);
+    shake128x2_squeezeblocks_interleaved(il, 1, &state);
+    for (l = 0; l < 2; ++l)
+    {
+      for (j = 0; j < SHAKE128_RATE; ++j)
+        out[l][j] = il[16 * (j / 8) + 8 * l + j % 8];
+      shake128(ref, SHAKE128_RATE, in[l], inlen);
+      if (memcmp(out[l], ref, SHAKE128_RATE))
+        errors += fail(kernel, "shake128x2_absorb_interleaved", l, inlen, SHAKE128_RATE);
+    }
+  }
+
+  sha3_256x2_32(out[0], out[1], in[0], in[1]);
+  sha3_512x2_64(out[0] + 32, out[1] + 32, in[0], in[1]);
+  for (l = 0; l < 2; ++l)
+  {
+    sha3_256(ref, in[l], 32);
+    sha3_512(ref + 32, in[l], 64);
+    if (memcmp(out[l], ref, 96))
+      errors += fail(kernel, "sha3_256x2_32/sha3_512x2_64", l, 32, 96);
+  }
+  return errors;
+}
+
+/*************************************************
+ * Name:        check_xN
+ *
+ * Description: Compares sha3_256xN, sha3_512xN, shake128xN,
+ *              shake256xN and shake*xN_absorb/squeezeblocks
+ *              with the active N-way kernel against fips202.c
+ *
+ * Arguments:   - const char *kernel: name of the active kernel
+ *
+ * Returns the number of mismatches
+ **************************************************/
+static int check_xN(const char *kernel)
+{
+  unsigned int n = keccakxN_lanes();
+  const uint8_t *inp[KECCAKXN_MAX_LANES];
+  uint8_t *outp[KECCAKXN_MAX_LANES];
+  keccakxN_state state;
+  size_t i, j;
+  unsigned int l;
+  int errors = 0;
+
+  for (l = 0; l < n; ++l)
+  {
+    inp[l] = in[l];
+    outp[l] = out[l];
+  }
+
+  for (i = 0; i < NELEMS(inlens); ++i)
+  {
+    size_t inlen = inlens[i];
+
+    sha3_256xN(outp, inp, inlen);
+    for (l = 0; l < n; ++l)
+    {
+      sha3_256(ref, in[l], inlen);
+      if (memcmp(out[l], ref, 32))
+        errors += fail(kernel, "sha3_256xN", l, inlen, 32);
+    }
+
+    sha3_512xN(outp, inp, inlen);
+    for (l = 0; l < n; ++l)
+    {
+      sha3_512(ref, in[l], inlen);
+      if (memcmp(out[l], ref, 64))
+        errors += fail(kernel, "sha3_512xN", l, inlen, 64);
+    }
+
+    for (j = 0; j < NELEMS(outlens); ++j)
+    {
+      size_t outlen = outlens[j];
+
+      shake128xN(outp, outlen, inp, inlen);
+      for (l = 0; l < n; ++l)
+      {
+        shake128(ref, outlen, in[l], inlen);
+        if (memcmp(out[l], ref, outlen))
+          errors += fail(kernel, "shake128xN", l, inlen, outlen);
+      }
+
+      shake256xN(outp, outlen, inp, inlen);
+      for (l = 0; l < n; ++l)
+      {
+        shake256(ref, outlen, in[l], inlen);
+        if (memcmp(out[l], ref, outlen))
+          errors += fail(kernel, "shake256xN", l, inlen, outlen);
+      }
+    }
+
+    // Three blocks, the second and third squeezed separately
+    shake128xN_absorb(&state, inp, inlen);
+    shake128xN_squeezeblocks(outp, 1, &state);
+    for (l = 0; l < n; ++l)
+      outp[l] = out[l] + SHAKE128_RATE;
+    shake128xN_squeezeblocks(outp, 2, &state);
+    for (l = 0; l < n; ++l)
+    {
+      outp[l] = out[l];
+      shake128(ref, 3 * SHAKE128_RATE, in[l], inlen);
+      if (memcmp(out[l], ref, 3 * SHAKE128_RATE))
+        errors += fail(kernel, "shake128xN_squeezeblocks", l, inlen, 3 * SHAKE128_RATE);
+    }
+
+    shake256xN_absorb(&state, inp, inlen);
+    shake256xN_squeezeblocks(outp, 1, &state);
+    for (l = 0; l < n; ++l)
+      outp[l] = out[l] + SHAKE256_RATE;
+    shake256xN_squeezeblocks(outp, 2, &state);
+    for (l = 0; l < n; ++l)
+    {
+      outp[l] = out[l];
+      shake256(ref, 3 * SHAKE256_RATE, in[l], inlen);
+      if (memcmp(out[l], ref, 3 * SHAKE256_RATE))
+        errors += fail(kernel, "shake256xN_squeezeblocks", l, inlen, 3 * SHAKE256_RATE);
+    }
+  }
+  return errors;
+}
+
+int main(void)
+{
+  const char *x2 = keccakx2_get_kernel();
+  size_t i, k;
+  unsigned int l;
+  int errors = 0;
+
+  for (l = 0; l < KECCAKXN_MAX_LANES; ++l)
+    for (i = 0; i < MAXIN; ++i)
+      in[l][i] = (uint8_t)(i * 7 + l * 131 + (i >> 8));
+
+  for (k = 0; k < NELEMS(kernels_x2); ++k)
+  {
+    int e;
+
+    if (keccakx2_set_kernel(kernels_x2[k]))
+    {
+      printf("x2 %-8s skipped, not supported\n", kernels_x2[k]);
+      continue;
+    }
+    e = check_x2(kernels_x2[k]);
+    printf("x2 %-8s %s\n", kernels_x2[k], e ? "FAIL" : "ok");
+    errors += e;
+  }
+  keccakx2_set_kernel(x2);
+
+  for (k = 0; k < NELEMS(kernels_xN); ++k)
+  {
+    int e;
+
+    if (keccakxN_set_kernel(kernels_xN[k]))
+    {
+      printf("xN %-8s skipped, not supported\n", kernels_xN[k]);
+      continue;
+    }
+    e = check_xN(kernels_xN[k]);
+    printf("xN %-8s %2u lanes %s\n", kernels_xN[k], keccakxN_lanes(), e ? "FAIL" : "ok");
+    errors += e;
+  }
+  return errors != 0;
+}
@@ -0,0 +1,514 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "fips202.h"
+#include "fips202x2.h"
+#include "fips202batch.h"
+#include "filehash.h"
+
+typedef struct {
+  unsigned int r;
+  uint8_t p;
+  size_t outlen;    // 0 for the XOFs
+} filehash_param;
+
+static const filehash_param filehash_params[] = {
+  { SHA3_256_RATE, 0x06, 32 },
+  { SHA3_512_RATE, 0x06, 64 },
+  { SHAKE128_RATE, 0x1F, 0 },
+  { SHAKE256_RATE, 0x1F, 0 }
+};
+
+typedef struct {
+  int fd;
+  int err;
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  uint8_t *buf[2];
+  size_t len[2];
+  int full[2];
+  // Reader side of the consumer: buffer being hashed, bytes done in it
+  unsigned int cur;
+  size_t off;
+} filehash_stream;
+
+/*************************************************
+ * Name:        filehash_reader
+ *
+ * Description: Background thread of a stream: fill the two buffers in
+ *              turn, each as soon as the hashing side has released it.
+ *              The end of the stream, or an error, is published as an
+ *              empty buffer.
+ *
+ * Arguments:   - void *arg: pointer to the filehash_stream
+ **************************************************/
+static void *filehash_reader(void *arg)
+{
+  filehash_stream *st = (filehash_stream *)arg;
+  unsigned int b = 0;
+  size_t len;
+  ssize_t k;
+  int err;
+
+  for (;;)
+  {
+    pthread_mutex_lock(&st->lock);
+    while (st->full[b])
+      pthread_cond_wait(&st->cond, &st->lock);
+    pthread_mutex_unlock(&st->lock);
+
+    len = 0;
+    err = 0;
+    while (len < FILEHASH_BUFSIZE)
+    {
+      k = read(st->fd, st->buf[b] + len, FILEHASH_BUFSIZE - len);
+      if (k > 0)
+        len += (size_t)k;
+      else if (k == 0)
+        break;
+      else if (errno != EINTR)
+      {
+        err = errno;
+        len = 0;
+        break;
+      }
+    }
+
+    pthread_mutex_lock(&st->lock);
+    st->len[b] = len;
+    st->full[b] = 1;
+    if (err)
+      st->err = err;
+    pthread_cond_broadcast(&st->cond);
+    pthread_mutex_unlock(&st->lock);
+
+    if (len == 0)
+      return NULL;
+    b ^= 1;
+  }
+}
+
+/*************************************************
+ * Name:        filehash_stream_start
+ *
+ * Description: Allocate the buffers of a stream and start its reader
+ *
+ * Arguments:   - filehash_stream *st: pointer to the stream
+ *              - int fd: file descriptor to read
+ *
+ * Returns 0 or an errno value
+ **************************************************/
+static int filehash_stream_start(filehash_stream *st, int fd)
+{
+  int err;
+
+  st->fd = fd;
+  st->err = 0;
+  st->buf[0] = (uint8_t *)malloc(2 * (size_t)FILEHASH_BUFSIZE);
+  if (st->buf[0] == NULL)
+    return ENOMEM;
+  st->buf[1] = st->buf[0] + FILEHASH_BUFSIZE;
+  st->full[0] = st->full[1] = 0;
+  st->cur = 0;
+  st->off = 0;
+
+  pthread_mutex_init(&st->lock, NULL);
+  pthread_cond_init(&st->cond, NULL);
+  err = pthread_create(&st->thread, NULL, filehash_reader, st);
+  if (err)
+  {
+    pthread_cond_destroy(&st->cond);
+    pthread_mutex_destroy(&st->lock);
+    free(st->buf[0]);
+  }
+  return err;
+}
+
+/*************************************************
+ * Name:        filehash_stream_finish
+ *
+ * Description: Join the reader of a stream that was read to the end
+ *              and free it
+ *
+ * Arguments:   - filehash_stream *st: pointer to the stream
+ *
+ * Returns 0 or the errno value of the failed read
+ **************************************************/
+static int filehash_stream_finish(filehash_stream *st)
+{
+  pthread_join(st->thread, NULL);
+  pthread_cond_destroy(&st->cond);
+  pthread_mutex_destroy(&st->lock);
+  free(st->buf[0]);
+  return st->err;
+}
+
+/*************************************************
+ * Name:        filehash_stream_peek
+ *
+ * Description: Wait for data in the current buffer
+ *
+ * Arguments:   - filehash_stream *st: pointer to the stream
+ *              - const uint8_t **in: set to the unhashed bytes
+ *
+ * Returns the number of unhashed bytes, 0 at the end of the stream
+ **************************************************/
+static size_t filehash_stream_peek(filehash_stream *st, const uint8_t **in)
+{
+  pthread_mutex_lock(&st->lock);
+  while (!st->full[st->cur])
+    pthread_cond_wait(&st->cond, &st->lock);
+  pthread_mutex_unlock(&st->lock);
+
+  *in = st->buf[st->cur] + st->off;
+  return st->len[st->cur] - st->off;
+}
+
+/*************************************************
+ * Name:        filehash_stream_consume
+ *
+ * Description: Mark n bytes of the current buffer as hashed, and hand
+ *              the buffer back to the reader once all of it is
+ *
+ * Arguments:   - filehash_stream *st: pointer to the stream
+ *              - size_t n: number of bytes hashed
+ **************************************************/
+static void filehash_stream_consume(filehash_stream *st, size_t n)
+{
+  st->off += n;
+  if (st->off < st->len[st->cur])
+    return;
+
+  pthread_mutex_lock(&st->lock);
+  st->full[st->cur] = 0;
+  pthread_cond_broadcast(&st->cond);
+  pthread_mutex_unlock(&st->lock);
+
+  st->cur ^= 1;
+  st->off = 0;
+}
+
+/*************************************************
+ * Name:        filehash_stream_x1
+ *
+ * Description: Absorb the rest of a stream into a scalar state, then
+ *              finalize and squeeze
+ *
+ * Arguments:   - const filehash_param *p: pointer to rate and padding
+ *              - uint8_t *out: pointer to output
+ *              - size_t outlen: output length in bytes
+ *              - filehash_stream *st: pointer to the stream
+ *              - keccak_inc_state *state: pointer to the state
+ **************************************************/
+static void filehash_stream_x1(const filehash_param *p,
+                               uint8_t *out,
+                               size_t outlen,
+                               filehash_stream *st,
+                               keccak_inc_state *state)
+{
+  const uint8_t *in;
+  size_t n;
+
+  while ((n = filehash_stream_peek(st, &in)) > 0)
+  {
+    keccak_inc_absorb(state, p->r, in, n);
+    filehash_stream_consume(st, n);
+  }
+
+  keccak_inc_finalize(state, p->r, p->p);
+  keccak_inc_squeeze(out, outlen, state, p->r);
+}
+
+/*************************************************
+ * Name:        filehash_stream_x2
+ *
+ * Description: Hash two streams on the 2-way permutation while both
+ *              have data; when one ends, both lanes are moved to scalar
+ *              states and finish on their own.
+ *
+ * Arguments:   - const filehash_param *p: pointer to rate and padding
+ *              - uint8_t *out0, *out1: pointers to outputs
+ *              - size_t outlen: output length in bytes
+ *              - filehash_stream *st0, *st1: pointers to the streams
+ **************************************************/
+static void filehash_stream_x2(const filehash_param *p,
+                               uint8_t *out0,
+                               uint8_t *out1,
+                               size_t outlen,
+                               filehash_stream *st0,
+                               filehash_stream *st1)
+{
+  const uint8_t *in0, *in1;
+  size_t n0, n1;
+  unsigned int i, pos = 0;
+  keccak_inc_state state;
+  v128 s[25];
+
+  for (i = 0; i < 25; ++i)
+    s[i] = v128_zero();
+
+  for (;;)
+  {
+    n0 = filehash_stream_peek(st0, &in0);
+    n1 = filehash_stream_peek(st1, &in1);
+    if (n0 == 0 || n1 == 0)
+      break;
+
+    if (n0 > n1)
+      n0 = n1;
+    pos = keccakx2_inc_absorb(s, pos, p->r, in0, in1, n0);
+    filehash_stream_consume(st0, n0);
+    filehash_stream_consume(st1, n0);
+  }
+
+  if (n0 == 0 && n1 == 0)
+  {
+    keccakx2_inc_finalize(s, pos, p->r, p->p);
+    keccakx2_squeeze(out0, out1, outlen, p->r, s);
+    return;
+  }
+
+  for (i = 0; i < 25; ++i)
+    state.s[i] = v128_lane0(s[i]);
+  state.pos = pos;
+  filehash_stream_x1(p, out0, outlen, st0, &state);
+
+  for (i = 0; i < 25; ++i)
+    state.s[i] = v128_lane1(s[i]);
+  state.pos = pos;
+  filehash_stream_x1(p, out1, outlen, st1, &state);
+}
+
+/*************************************************
+ * Name:        filehash_open
+ *
+ * Description: Open a file and map it if it is a regular file with a
+ *              size; everything else is left to be read as a stream
+ *
+ * Arguments:   - const char *path: path, "-" for standard input
+ *              - int *fd: set to the descriptor to stream, -1 if mapped
+ *              - const uint8_t **map: set to the mapping
+ *              - size_t *size: set to the size of the mapping
+ *
+ * Returns 0 or an errno value
+ **************************************************/
+static int filehash_open(const char *path,
+                         int *fd,
+                         const uint8_t **map,
+                         size_t *size)
+{
+  struct stat sb;
+  void *m;
+  int err;
+
+  if (strcmp(path, "-") == 0)
+  {
+    *fd = STDIN_FILENO;
+    return 0;
+  }
+
+  *fd = open(path, O_RDONLY);
+  if (*fd < 0)
+    return errno;
+  if (fstat(*fd, &sb) != 0)
+    err = errno;
+  else if (S_ISDIR(sb.st_mode))
+    err = EISDIR;
+  else
+    err = 0;
+  if (err != 0)
+  {
+    close(*fd);
+    *fd = -1;
+    return err;
+  }
+
+  if (!S_ISREG(sb.st_mode) || sb.st_size <= 0 ||
+      (uintmax_t)sb.st_size > SIZE_MAX)
+    return 0;
+
+  m = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, *fd, 0);
+  if (m == MAP_FAILED)
+    return 0;
+  madvise(m, (size_t)sb.st_size, MADV_SEQUENTIAL);
+  close(*fd);
+
+  *fd = -1;
+  *map = (const uint8_t *)m;
+  *size = (size_t)sb.st_size;
+  return 0;
+}
+
+/*************************************************
+ * Name:        filehash_group
+ *
+ * Description: Hash up to FILEHASH_GROUP files: the mapped ones through
+ *              the batch functions, then the streams two at a time
+ *
+ * Arguments:   - filehash_fn fn: function to compute
+ *              - uint8_t *const out[]: n outputs
+ *              - size_t outlen: output length in bytes
+ *              - const char *const path[]: n paths
+ *              - int err[]: n errno values, or NULL
+ *              - size_t n: number of files
+ *
+ * Returns 0, or -1 if any file could not be read
+ **************************************************/
+static int filehash_group(filehash_fn fn,
+                          uint8_t *const out[],
+                          size_t outlen,
+                          const char *const path[],
+                          int err[],
+                          size_t n)
+{
+  const filehash_param *p = &filehash_params[fn];
+  const uint8_t *map[FILEHASH_GROUP];
+  size_t size[FILEHASH_GROUP];
+  uint8_t *mout[FILEHASH_GROUP];
+  size_t sidx[FILEHASH_GROUP];
+  int fd[FILEHASH_GROUP], e[FILEHASH_GROUP];
+  filehash_stream st[2];
+  size_t i, nmap = 0, nstream = 0;
+  int ret = 0;
+
+  for (i = 0; i < n; ++i)
+  {
+    e[i] = filehash_open(path[i], &fd[i], &map[nmap], &size[nmap]);
+    if (e[i] != 0)
+      continue;
+    if (fd[i] < 0)
+      mout[nmap++] = out[i];
+    else
+      sidx[nstream++] = i;
+  }
+
+  switch (fn)
+  {
+  case FILEHASH_SHA3_256:
+    sha3_256_batch(mout, map, size, nmap);
+    break;
+  case FILEHASH_SHA3_512:
+    sha3_512_batch(mout, map, size, nmap);
+    break;
+  case FILEHASH_SHAKE128:
+    shake128_batch(mout, outlen, map, size, nmap);
+    break;
+  case FILEHASH_SHAKE256:
+    shake256_batch(mout, outlen, map, size, nmap);
+    break;
+  }
+  for (i = 0; i < nmap; ++i)
+    munmap((void *)map[i], size[i]);
+
+  if (p->outlen)
+    outlen = p->outlen;
+
+  for (i = 0; i < nstream; ++i)
+  {
+    size_t a = sidx[i], b;
+    keccak_inc_state state;
+
+    e[a] = filehash_stream_start(&st[0], fd[a]);
+    if (e[a] != 0)
+      continue;
+
+    // Pair with the next stream that starts
+    for (b = a; ++i < nstream; )
+    {
+      b = sidx[i];
+      e[b] = filehash_stream_start(&st[1], fd[b]);
+      if (e[b] == 0)
+        break;
+    }
+
+    if (i < nstream)
+    {
+      filehash_stream_x2(p, out[a], out[b], outlen, &st[0], &st[1]);
+      e[b] = filehash_stream_finish(&st[1]);
+    }
+    else
+    {
+      keccak_inc_init(&state);
+      filehash_stream_x1(p, out[a], outlen, &st[0], &state);
+    }
+    e[a] = filehash_stream_finish(&st[0]);
+  }
+
+  for (i = 0; i < n; ++i)
+  {
+    if (fd[i] >= 0 && fd[i] != STDIN_FILENO)
+      close(fd[i]);
+    if (err != NULL)
+      err[i] = e[i];
+    if (e[i] != 0)
+      ret = -1;
+  }
+
+  return ret;
+}
+
+/*************************************************
+ * Name:        filehash
+ *
+ * Description: Hash n files, FILEHASH_GROUP at a time
+ *
+ * Arguments:   - filehash_fn fn: function to compute
+ *              - uint8_t *const out[]: n outputs
+ *              - size_t outlen: output length in bytes, XOFs only
+ *              - const char *const path[]: n paths, "-" for standard input
+ *              - int err[]: n errno values, or NULL
+ *              - size_t n: number of files
+ *
+ * Returns 0, or -1 if any file could not be read
+ **************************************************/
+int filehash(filehash_fn fn,
+             uint8_t *const out[],
+             size_t outlen,
+             const char *const path[],
+             int err[],
+             size_t n)
+{
+  size_t m;
+  int ret = 0;
+
+  while (n > 0)
+  {
+    m = n < FILEHASH_GROUP ? n : FILEHASH_GROUP;
+    if (filehash_group(fn, out, outlen, path, err, m) != 0)
+      ret = -1;
+
+    out += m;
+    path += m;
+    if (err != NULL)
+      err += m;
+    n -= m;
+  }
+
+  return ret;
+}
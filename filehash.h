@@ -0,0 +1,54 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#ifndef FILEHASH_H
+#define FILEHASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Hash many files. Regular files are mmap'd with MADV_SEQUENTIAL and
+ * hashed through the batch functions, paired by size on the 2-way
+ * permutation. Pipes, sockets, devices and files that report size 0
+ * (e.g. /proc) are read by a background thread into two buffers of
+ * FILEHASH_BUFSIZE bytes, so reading overlaps hashing; two such streams
+ * share the 2-way permutation while both have data.
+ * Files are opened FILEHASH_GROUP at a time.
+ */
+#define FILEHASH_BUFSIZE (1 << 20)
+#define FILEHASH_GROUP 64
+
+typedef enum {
+  FILEHASH_SHA3_256,
+  FILEHASH_SHA3_512,
+  FILEHASH_SHAKE128,
+  FILEHASH_SHAKE256
+} filehash_fn;
+
+/*
+ * out[i]: digest of path[i], outlen bytes for the XOFs (ignored for
+ * SHA3). The path "-" is standard input. err may be NULL, otherwise
+ * err[i] gets the errno of path[i], 0 if it was hashed.
+ * Returns 0, or -1 if any file could not be read
+ */
+int filehash(filehash_fn fn,
+             uint8_t *const out[],
+             size_t outlen,
+             const char *const path[],
+             int err[],
+             size_t n);
+
+#endif
@@ -75,11 +75,13 @@ static const uint64_t KeccakF_RoundConstants[NROUNDS] = {
 };
 
 /*************************************************
-* Name:        KeccakF1600_StatePermute
+* Name:        KeccakP1600_StatePermute
 *
-* Description: The Keccak F1600 Permutation
+* Description: The last NROUNDS - first rounds of the Keccak F1600
+*              Permutation, first even
 *
 * Arguments:   - uint64_t *state: pointer to input/output Keccak state
+*              - int first: index of the first round
 **************************************************/
 // void print_state(uint64_t a, uint64_t b, uint64_t c, uint64_t d, uint64_t e)
 // {
@@ -87,7 +89,7 @@ static const uint64_t KeccakF_RoundConstants[NROUNDS] = {
 //     // printf("%d : %lx -- %lx -- %lx -- %lx -- %lx\n", count++, a, b, c, d, e);
 //     // printf("%d : %lu -- %lu -- %lu -- %lu -- %lu\n", count++, a, b, c, d, e);
 // }
-void KeccakF1600_StatePermute(uint64_t state[25])
+static void KeccakP1600_StatePermute(uint64_t state[25], int first)
 {
         int round;
 
@@ -131,7 +133,7 @@ void KeccakF1600_StatePermute(uint64_t state[25])
         Aso = state[23];
         Asu = state[24];
 
-        for( round = 0; round < NROUNDS; round += 2 )
+        for( round = first; round < NROUNDS; round += 2 )
         {
             //    prepareTheta
             BCa = Aba^Aga^Aka^Ama^Asa;
@@ -381,6 +383,31 @@ void KeccakF1600_StatePermute(uint64_t state[25])
         state[24] = Asu;
 }
 
+/*************************************************
+* Name:        KeccakF1600_StatePermute
+*
+* Description: The Keccak F1600 Permutation
+*
+* Arguments:   - uint64_t *state: pointer to input/output Keccak state
+**************************************************/
+void KeccakF1600_StatePermute(uint64_t state[25])
+{
+  KeccakP1600_StatePermute(state, 0);
+}
+
+/*************************************************
+* Name:        KeccakP1600_12_StatePermute
+*
+* Description: Keccak-p[1600, 12], the last 12 rounds of the
+*              Keccak F1600 Permutation
+*
+* Arguments:   - uint64_t *state: pointer to input/output Keccak state
+**************************************************/
+void KeccakP1600_12_StatePermute(uint64_t state[25])
+{
+  KeccakP1600_StatePermute(state, NROUNDS - 12);
+}
+
 /*************************************************
 * Name:        keccak_absorb
 *
@@ -619,3 +646,102 @@ void sha3_512(uint8_t *h, const uint8_t *in, size_t inlen)
   for(i=0;i<64;i++)
     h[i] = t[i];
 }
+
+/*************************************************
+* Name:        keccak_inc_init
+*
+* Description: Initializes the incremental Keccak state to zero
+*
+* Arguments:   - keccak_inc_state *state: pointer to output Keccak state
+**************************************************/
+void keccak_inc_init(keccak_inc_state *state)
+{
+  unsigned int i;
+
+  for(i=0;i<25;i++)
+    state->s[i] = 0;
+  state->pos = 0;
+}
+
+/*************************************************
+* Name:        keccak_inc_absorb
+*
+* Description: Incremental absorb step of Keccak, any number of calls
+*              with any input length
+*
+* Arguments:   - keccak_inc_state *state: pointer to input/output Keccak state
+*              - unsigned int r:          rate in bytes (e.g., 168 for SHAKE128)
+*              - const uint8_t *in:       pointer to input
+*              - size_t inlen:            length of input in bytes
+**************************************************/
+void keccak_inc_absorb(keccak_inc_state *state,
+                       unsigned int r,
+                       const uint8_t *in,
+                       size_t inlen)
+{
+  unsigned int i;
+  uint64_t *s = state->s;
+
+  while(inlen > 0) {
+    if(state->pos == 0 && inlen >= r) {
+      for(i=0;i<r/8;i++)
+        s[i] ^= load64(in + 8*i);
+      KeccakF1600_StatePermute(s);
+      in += r;
+      inlen -= r;
+      continue;
+    }
+
+    s[state->pos/8] ^= (uint64_t)*in++ << 8*(state->pos%8);
+    inlen--;
+
+    if(++state->pos == r) {
+      KeccakF1600_StatePermute(s);
+      state->pos = 0;
+    }
+  }
+}
+
+/*************************************************
+* Name:        keccak_inc_finalize
+*
+* Description: Pads the incremental Keccak state, absorbing is over
+*
+* Arguments:   - keccak_inc_state *state: pointer to input/output Keccak state
+*              - unsigned int r:          rate in bytes (e.g., 168 for SHAKE128)
+*              - uint8_t p:               domain-separation byte for different
+*                                         Keccak-derived functions
+**************************************************/
+void keccak_inc_finalize(keccak_inc_state *state, unsigned int r, uint8_t p)
+{
+  state->s[state->pos/8] ^= (uint64_t)p << 8*(state->pos%8);
+  state->s[r/8-1] ^= 1ULL << 63;
+  state->pos = r;
+}
+
+/*************************************************
+* Name:        keccak_inc_squeeze
+*
+* Description: Incremental squeeze step of Keccak, any number of calls
+*              with any output length
+*
+* Arguments:   - uint8_t *out:            pointer to output
+*              - size_t outlen:           requested output length in bytes
+*              - keccak_inc_state *state: pointer to input/output Keccak state
+*              - unsigned int r:          rate in bytes (e.g., 168 for SHAKE128)
+**************************************************/
+void keccak_inc_squeeze(uint8_t *out,
+                        size_t outlen,
+                        keccak_inc_state *state,
+                        unsigned int r)
+{
+  while(outlen > 0) {
+    if(state->pos == r) {
+      KeccakF1600_StatePermute(state->s);
+      state->pos = 0;
+    }
+    *out++ = state->s[state->pos/8] >> 8*(state->pos%8);
+    state->pos++;
+    outlen--;
+  }
+}
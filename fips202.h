@@ -13,8 +13,15 @@ typedef struct {
   uint64_t s[25];
 } keccak_state;
 
+typedef struct {
+  uint64_t s[25];
+  unsigned int pos;
+} keccak_inc_state;
+
 void KeccakF1600_StatePermute(uint64_t state[25]);
 
+void KeccakP1600_12_StatePermute(uint64_t state[25]);
+
 void shake128_absorb(keccak_state *state, const uint8_t *in, size_t inlen);
 
 void shake128_squeezeblocks(uint8_t *out, size_t nblocks, keccak_state *state);
@@ -32,4 +39,22 @@ void sha3_256(uint8_t h[32], const uint8_t *in, size_t inlen);
 
 void sha3_512(uint8_t h[64], const uint8_t *in, size_t inlen);
 
+/*
+ * Incremental sponge with any rate r and domain byte p, for the
+ * functions built on top of Keccak (e.g. cSHAKE)
+ */
+void keccak_inc_init(keccak_inc_state *state);
+
+void keccak_inc_absorb(keccak_inc_state *state,
+                       unsigned int r,
+                       const uint8_t *in,
+                       size_t inlen);
+
+void keccak_inc_finalize(keccak_inc_state *state, unsigned int r, uint8_t p);
+
+void keccak_inc_squeeze(uint8_t *out,
+                        size_t outlen,
+                        keccak_inc_state *state,
+                        unsigned int r);
+
 #endif
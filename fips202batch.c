@@ -0,0 +1,274 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "fips202.h"
+#include "fips202x2.h"
+#include "fips202batch.h"
+
+typedef enum {
+  BATCH_SHAKE128,
+  BATCH_SHAKE256,
+  BATCH_SHA3_256,
+  BATCH_SHA3_512
+} keccak_batch_fn;
+
+typedef struct {
+  size_t inlen;
+  size_t idx;
+} keccak_batch_job;
+
+/*************************************************
+ * Name:        keccak_batch_cmp
+ *
+ * Description: qsort comparison, shorter messages first
+ **************************************************/
+static int keccak_batch_cmp(const void *a, const void *b)
+{
+  const keccak_batch_job *x = (const keccak_batch_job *)a;
+  const keccak_batch_job *y = (const keccak_batch_job *)b;
+
+  if (x->inlen != y->inlen)
+    return x->inlen < y->inlen ? -1 : 1;
+  return x->idx < y->idx ? -1 : x->idx > y->idx;
+}
+
+/*************************************************
+ * Name:        keccak_batch_x1
+ *
+ * Description: Hash one message with the scalar fips202.c code
+ *
+ * Arguments:   - keccak_batch_fn fn: function to compute
+ *              - uint8_t *out: pointer to output
+ *              - size_t outlen: output length in bytes, XOFs only
+ *              - const uint8_t *in: pointer to input
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+static void keccak_batch_x1(keccak_batch_fn fn,
+                            uint8_t *out,
+                            size_t outlen,
+                            const uint8_t *in,
+                            size_t inlen)
+{
+  switch (fn)
+  {
+  case BATCH_SHAKE128:
+    shake128(out, outlen, in, inlen);
+    break;
+  case BATCH_SHAKE256:
+    shake256(out, outlen, in, inlen);
+    break;
+  case BATCH_SHA3_256:
+    sha3_256(out, in, inlen);
+    break;
+  case BATCH_SHA3_512:
+    sha3_512(out, in, inlen);
+    break;
+  }
+}
+
+/*************************************************
+ * Name:        keccak_batch_x2
+ *
+ * Description: Hash two messages on the 2-way permutation, the
+ *              same-length functions when the lengths match
+ *
+ * Arguments:   - keccak_batch_fn fn: function to compute
+ *              - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: output length in bytes, XOFs only
+ *              - const uint8_t *in0, *in1: pointer to input
+ *              - size_t inlen0, inlen1: length of each input in bytes
+ **************************************************/
+static void keccak_batch_x2(keccak_batch_fn fn,
+                            uint8_t *out0,
+                            uint8_t *out1,
+                            size_t outlen,
+                            const uint8_t *in0,
+                            const uint8_t *in1,
+                            size_t inlen0,
+                            size_t inlen1)
+{
+  if (inlen0 == inlen1)
+  {
+    switch (fn)
+    {
+    case BATCH_SHAKE128:
+      shake128x2(out0, out1, outlen, in0, in1, inlen0);
+      break;
+    case BATCH_SHAKE256:
+      shake256x2(out0, out1, outlen, in0, in1, inlen0);
+      break;
+    case BATCH_SHA3_256:
+      sha3_256x2(out0, out1, in0, in1, inlen0);
+      break;
+    case BATCH_SHA3_512:
+      sha3_512x2(out0, out1, in0, in1, inlen0);
+      break;
+    }
+    return;
+  }
+
+  switch (fn)
+  {
+  case BATCH_SHAKE128:
+    shake128x2_var(out0, out1, outlen, in0, in1, inlen0, inlen1);
+    break;
+  case BATCH_SHAKE256:
+    shake256x2_var(out0, out1, outlen, in0, in1, inlen0, inlen1);
+    break;
+  case BATCH_SHA3_256:
+    sha3_256x2_var(out0, out1, in0, in1, inlen0, inlen1);
+    break;
+  case BATCH_SHA3_512:
+    sha3_512x2_var(out0, out1, in0, in1, inlen0, inlen1);
+    break;
+  }
+}
+
+/*************************************************
+ * Name:        keccak_batch
+ *
+ * Description: Hash n independent messages. Each chunk of
+ *              KECCAK_BATCH_CHUNK messages is sorted by length so that
+ *              neighbours need the same number of blocks, then hashed
+ *              in pairs; the longest message of an odd chunk is
+ *              hashed alone.
+ *
+ * Arguments:   - keccak_batch_fn fn: function to compute
+ *              - uint8_t *const out[]: n outputs
+ *              - size_t outlen: output length in bytes, XOFs only
+ *              - const uint8_t *const in[]: n inputs
+ *              - const size_t inlen[]: n input lengths in bytes
+ *              - size_t n: number of messages
+ **************************************************/
+static void keccak_batch(keccak_batch_fn fn,
+                         uint8_t *const out[],
+                         size_t outlen,
+                         const uint8_t *const in[],
+                         const size_t inlen[],
+                         size_t n)
+{
+  size_t i, m, a, b;
+  keccak_batch_job jobs[KECCAK_BATCH_CHUNK];
+
+  while (n > 0)
+  {
+    m = n < KECCAK_BATCH_CHUNK ? n : KECCAK_BATCH_CHUNK;
+
+    for (i = 0; i < m; ++i)
+    {
+      jobs[i].inlen = inlen[i];
+      jobs[i].idx = i;
+    }
+    qsort(jobs, m, sizeof(jobs[0]), keccak_batch_cmp);
+
+    for (i = 0; i + 2 <= m; i += 2)
+    {
+      a = jobs[i].idx;
+      b = jobs[i + 1].idx;
+      keccak_batch_x2(fn, out[a], out[b], outlen,
+                      in[a], in[b], inlen[a], inlen[b]);
+    }
+
+    if (i < m)
+    {
+      a = jobs[i].idx;
+      keccak_batch_x1(fn, out[a], outlen, in[a], inlen[a]);
+    }
+
+    out += m;
+    in += m;
+    inlen += m;
+    n -= m;
+  }
+}
+
+/*************************************************
+ * Name:        shake128_batch
+ *
+ * Description: SHAKE128 XOF on n independent messages
+ *
+ * Arguments:   - uint8_t *const out[]: n outputs
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *const in[]: n inputs
+ *              - const size_t inlen[]: n input lengths in bytes
+ *              - size_t n: number of messages
+ **************************************************/
+void shake128_batch(uint8_t *const out[],
+                    size_t outlen,
+                    const uint8_t *const in[],
+                    const size_t inlen[],
+                    size_t n)
+{
+  keccak_batch(BATCH_SHAKE128, out, outlen, in, inlen, n);
+}
+
+/*************************************************
+ * Name:        shake256_batch
+ *
+ * Description: SHAKE256 XOF on n independent messages
+ *
+ * Arguments:   - uint8_t *const out[]: n outputs
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *const in[]: n inputs
+ *              - const size_t inlen[]: n input lengths in bytes
+ *              - size_t n: number of messages
+ **************************************************/
+void shake256_batch(uint8_t *const out[],
+                    size_t outlen,
+                    const uint8_t *const in[],
+                    const size_t inlen[],
+                    size_t n)
+{
+  keccak_batch(BATCH_SHAKE256, out, outlen, in, inlen, n);
+}
+
+/*************************************************
+ * Name:        sha3_256_batch
+ *
+ * Description: SHA3-256 on n independent messages
+ *
+ * Arguments:   - uint8_t *const h[]: n outputs (32 bytes)
+ *              - const uint8_t *const in[]: n inputs
+ *              - const size_t inlen[]: n input lengths in bytes
+ *              - size_t n: number of messages
+ **************************************************/
+void sha3_256_batch(uint8_t *const h[],
+                    const uint8_t *const in[],
+                    const size_t inlen[],
+                    size_t n)
+{
+  keccak_batch(BATCH_SHA3_256, h, 32, in, inlen, n);
+}
+
+/*************************************************
+ * Name:        sha3_512_batch
+ *
+ * Description: SHA3-512 on n independent messages
+ *
+ * Arguments:   - uint8_t *const h[]: n outputs (64 bytes)
+ *              - const uint8_t *const in[]: n inputs
+ *              - const size_t inlen[]: n input lengths in bytes
+ *              - size_t n: number of messages
+ **************************************************/
+void sha3_512_batch(uint8_t *const h[],
+                    const uint8_t *const in[],
+                    const size_t inlen[],
+                    size_t n)
+{
+  keccak_batch(BATCH_SHA3_512, h, 64, in, inlen, n);
+}
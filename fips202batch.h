@@ -0,0 +1,51 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#ifndef FIPS202BATCH_H
+#define FIPS202BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * n independent messages of any length. Messages are sorted by length
+ * and paired on the 2-way permutation, an odd one out goes through
+ * fips202.c. Sorting is done per KECCAK_BATCH_CHUNK messages.
+ */
+#define KECCAK_BATCH_CHUNK 256
+
+void shake128_batch(uint8_t *const out[],
+                    size_t outlen,
+                    const uint8_t *const in[],
+                    const size_t inlen[],
+                    size_t n);
+
+void shake256_batch(uint8_t *const out[],
+                    size_t outlen,
+                    const uint8_t *const in[],
+                    const size_t inlen[],
+                    size_t n);
+
+void sha3_256_batch(uint8_t *const h[],
+                    const uint8_t *const in[],
+                    const size_t inlen[],
+                    size_t n);
+
+void sha3_512_batch(uint8_t *const h[],
+                    const uint8_t *const in[],
+                    const size_t inlen[],
+                    size_t n);
+
+#endif
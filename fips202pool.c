@@ -0,0 +1,590 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "fips202batch.h"
+#include "fips202pool.h"
+
+#define KECCAK_POOL_MAX_CPUS 1024
+
+typedef enum {
+  POOL_SHAKE128,
+  POOL_SHAKE256,
+  POOL_SHA3_256,
+  POOL_SHA3_512,
+  POOL_FOR
+} keccak_pool_fn;
+
+/*
+ * Grains [next, end) of one worker, on its own cache line.
+ * next is bumped atomically by the owner and by thieves
+ */
+typedef struct {
+  size_t next;
+  size_t end;
+  uint8_t pad[64 - 2 * sizeof(size_t)];
+} keccak_pool_share;
+
+typedef struct {
+  keccak_pool *pool;
+  unsigned int id;
+  int cpu;
+} keccak_pool_worker;
+
+struct keccak_pool {
+  unsigned int nthreads;
+  pthread_t *threads;
+  keccak_pool_worker *workers;
+  keccak_pool_share *shares;
+
+  pthread_mutex_t batch; // one batch at a time
+  pthread_mutex_t lock;  // protects the fields below
+  pthread_cond_t start;
+  pthread_cond_t done;
+  unsigned long generation;
+  unsigned int busy;
+  int stop;
+
+  // Current batch, written before generation is bumped
+  keccak_pool_fn fn;
+  uint8_t *const *out;
+  size_t outlen;
+  const uint8_t *const *in;
+  const size_t *inlen;
+  void (*job)(void *arg, size_t i);
+  void *arg;
+  size_t n;
+  size_t grain;
+};
+
+/*************************************************
+ * Name:        keccak_pool_capacity
+ *
+ * Description: Relative performance of a CPU, from
+ *              /sys/devices/system/cpu/cpuN/cpu_capacity on Linux
+ *
+ * Arguments:   - int cpu: CPU number
+ *
+ * Returns the capacity, 1024 if unknown
+ **************************************************/
+static unsigned long keccak_pool_capacity(int cpu)
+{
+  char path[64];
+  unsigned long cap = 1024;
+  FILE *f;
+
+  snprintf(path, sizeof(path),
+           "/sys/devices/system/cpu/cpu%d/cpu_capacity", cpu);
+  f = fopen(path, "r");
+  if (f == NULL)
+    return cap;
+  if (fscanf(f, "%lu", &cap) != 1)
+    cap = 1024;
+  fclose(f);
+
+  return cap;
+}
+
+/*************************************************
+ * Name:        keccak_pool_cpus
+ *
+ * Description: CPUs this process may run on, fastest first,
+ *              in CPU number order within the same capacity
+ *
+ * Arguments:   - int *cpus: output, KECCAK_POOL_MAX_CPUS entries
+ *
+ * Returns the number of CPUs, 0 if unknown
+ **************************************************/
+static unsigned int keccak_pool_cpus(int cpus[KECCAK_POOL_MAX_CPUS])
+{
+#if defined(__linux__)
+  unsigned int i, j, n = 0;
+  int c, t;
+  unsigned long u, cap[KECCAK_POOL_MAX_CPUS];
+  cpu_set_t set;
+
+  if (sched_getaffinity(0, sizeof(set), &set))
+    return 0;
+
+  for (c = 0; c < CPU_SETSIZE && n < KECCAK_POOL_MAX_CPUS; ++c)
+  {
+    if (!CPU_ISSET(c, &set))
+      continue;
+    cpus[n] = c;
+    cap[n] = keccak_pool_capacity(c);
+    n++;
+  }
+
+  // Stable insertion sort, big cores first
+  for (i = 1; i < n; ++i)
+  {
+    t = cpus[i];
+    u = cap[i];
+    for (j = i; j > 0 && cap[j - 1] < u; --j)
+    {
+      cpus[j] = cpus[j - 1];
+      cap[j] = cap[j - 1];
+    }
+    cpus[j] = t;
+    cap[j] = u;
+  }
+
+  return n;
+#else
+  (void)cpus;
+  return 0;
+#endif
+}
+
+/*************************************************
+ * Name:        keccak_pool_pin
+ *
+ * Description: Pin the calling thread to one CPU, best effort
+ *
+ * Arguments:   - int cpu: CPU number, negative to leave it unpinned
+ **************************************************/
+static void keccak_pool_pin(int cpu)
+{
+#if defined(__linux__)
+  cpu_set_t set;
+
+  if (cpu < 0)
+    return;
+
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  (void)cpu;
+#endif
+}
+
+/*************************************************
+ * Name:        keccak_pool_run
+ *
+ * Description: Hash one grain of the current batch
+ *
+ * Arguments:   - const keccak_pool *pool: pointer to the pool
+ *              - size_t first: index of the first message
+ **************************************************/
+static void keccak_pool_run(const keccak_pool *pool, size_t first)
+{
+  size_t i, m = pool->n - first;
+
+  if (m > pool->grain)
+    m = pool->grain;
+
+  switch (pool->fn)
+  {
+  case POOL_SHAKE128:
+    shake128_batch(&pool->out[first], pool->outlen,
+                   &pool->in[first], &pool->inlen[first], m);
+    break;
+  case POOL_SHAKE256:
+    shake256_batch(&pool->out[first], pool->outlen,
+                   &pool->in[first], &pool->inlen[first], m);
+    break;
+  case POOL_SHA3_256:
+    sha3_256_batch(&pool->out[first],
+                   &pool->in[first], &pool->inlen[first], m);
+    break;
+  case POOL_SHA3_512:
+    sha3_512_batch(&pool->out[first],
+                   &pool->in[first], &pool->inlen[first], m);
+    break;
+  case POOL_FOR:
+    for (i = first; i < first + m; ++i)
+      pool->job(pool->arg, i);
+    break;
+  }
+}
+
+/*************************************************
+ * Name:        keccak_pool_work
+ *
+ * Description: Drain the own share of the current batch,
+ *              then steal grains from the other workers
+ *
+ * Arguments:   - keccak_pool *pool: pointer to the pool
+ *              - unsigned int id: worker number
+ **************************************************/
+static void keccak_pool_work(keccak_pool *pool, unsigned int id)
+{
+  unsigned int k;
+  size_t g;
+  keccak_pool_share *share;
+
+  for (k = 0; k < pool->nthreads; ++k)
+  {
+    share = &pool->shares[(id + k) % pool->nthreads];
+    while ((g = __atomic_fetch_add(&share->next, 1, __ATOMIC_RELAXED)) < share->end)
+      keccak_pool_run(pool, g * pool->grain);
+  }
+}
+
+/*************************************************
+ * Name:        keccak_pool_main
+ *
+ * Description: Worker thread: pin, then run every batch
+ *              until the pool is destroyed
+ *
+ * Arguments:   - void *arg: pointer to the keccak_pool_worker
+ **************************************************/
+static void *keccak_pool_main(void *arg)
+{
+  keccak_pool_worker *w = (keccak_pool_worker *)arg;
+  keccak_pool *pool = w->pool;
+  unsigned long seen = 0;
+
+  keccak_pool_pin(w->cpu);
+
+  pthread_mutex_lock(&pool->lock);
+  for (;;)
+  {
+    while (!pool->stop && pool->generation == seen)
+      pthread_cond_wait(&pool->start, &pool->lock);
+    if (pool->stop)
+      break;
+    seen = pool->generation;
+    pthread_mutex_unlock(&pool->lock);
+
+    keccak_pool_work(pool, w->id);
+
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->busy == 0)
+      pthread_cond_signal(&pool->done);
+  }
+  pthread_mutex_unlock(&pool->lock);
+
+  return NULL;
+}
+
+/*************************************************
+ * Name:        keccak_pool_destroy
+ *
+ * Description: Stop and join the workers, free the pool
+ *
+ * Arguments:   - keccak_pool *pool: pointer to the pool, may be NULL
+ **************************************************/
+void keccak_pool_destroy(keccak_pool *pool)
+{
+  unsigned int i;
+
+  if (pool == NULL)
+    return;
+
+  pthread_mutex_lock(&pool->lock);
+  pool->stop = 1;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->lock);
+
+  for (i = 0; i < pool->nthreads; ++i)
+    pthread_join(pool->threads[i], NULL);
+
+  pthread_cond_destroy(&pool->done);
+  pthread_cond_destroy(&pool->start);
+  pthread_mutex_destroy(&pool->lock);
+  pthread_mutex_destroy(&pool->batch);
+
+  free(pool->shares);
+  free(pool->workers);
+  free(pool->threads);
+  free(pool);
+}
+
+/*************************************************
+ * Name:        keccak_pool_create
+ *
+ * Description: Start a pool of pinned worker threads
+ *
+ * Arguments:   - unsigned int nthreads: number of workers,
+ *                0 for one per available CPU
+ *
+ * Returns the pool, NULL on failure
+ **************************************************/
+keccak_pool *keccak_pool_create(unsigned int nthreads)
+{
+  unsigned int i, ncpus;
+  int cpus[KECCAK_POOL_MAX_CPUS];
+  long online;
+  void *shares;
+  keccak_pool *pool;
+
+  ncpus = keccak_pool_cpus(cpus);
+  if (nthreads == 0)
+  {
+    online = sysconf(_SC_NPROCESSORS_ONLN);
+    nthreads = ncpus ? ncpus : online > 0 ? (unsigned int)online : 1;
+  }
+
+  pool = (keccak_pool *)calloc(1, sizeof(*pool));
+  if (pool == NULL)
+    return NULL;
+
+  pool->threads = (pthread_t *)calloc(nthreads, sizeof(pthread_t));
+  pool->workers = (keccak_pool_worker *)calloc(nthreads, sizeof(keccak_pool_worker));
+  if (posix_memalign(&shares, 64, nthreads * sizeof(keccak_pool_share)))
+    shares = NULL;
+  pool->shares = (keccak_pool_share *)shares;
+
+  pthread_mutex_init(&pool->batch, NULL);
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->start, NULL);
+  pthread_cond_init(&pool->done, NULL);
+
+  if (pool->threads == NULL || pool->workers == NULL || pool->shares == NULL)
+  {
+    keccak_pool_destroy(pool);
+    return NULL;
+  }
+
+  for (i = 0; i < nthreads; ++i)
+  {
+    pool->workers[i].pool = pool;
+    pool->workers[i].id = i;
+    pool->workers[i].cpu = ncpus ? cpus[i % ncpus] : -1;
+    if (pthread_create(&pool->threads[i], NULL,
+                       keccak_pool_main, &pool->workers[i]))
+    {
+      keccak_pool_destroy(pool);
+      return NULL;
+    }
+    pool->nthreads = i + 1;
+  }
+
+  return pool;
+}
+
+/*************************************************
+ * Name:        keccak_pool_threads
+ *
+ * Description: Number of worker threads
+ *
+ * Arguments:   - const keccak_pool *pool: pointer to the pool
+ *
+ * Returns the number of workers
+ **************************************************/
+unsigned int keccak_pool_threads(const keccak_pool *pool)
+{
+  return pool->nthreads;
+}
+
+/*************************************************
+ * Name:        keccak_pool_start
+ *
+ * Description: Split the current batch into one share per worker, wake
+ *              them up and wait until all grains are done. Batches of a
+ *              single grain run on the calling thread. Called with both
+ *              mutexes held, releases them.
+ *
+ * Arguments:   - keccak_pool *pool: pointer to the pool
+ **************************************************/
+static void keccak_pool_start(keccak_pool *pool)
+{
+  unsigned int i;
+  const unsigned int t = pool->nthreads;
+  const size_t ngrains = (pool->n + pool->grain - 1) / pool->grain;
+
+  if (ngrains == 1)
+  {
+    pthread_mutex_unlock(&pool->lock);
+    keccak_pool_run(pool, 0);
+    pthread_mutex_unlock(&pool->batch);
+    return;
+  }
+
+  for (i = 0; i < t; ++i)
+  {
+    pool->shares[i].next = ngrains * i / t;
+    pool->shares[i].end = ngrains * (i + 1) / t;
+  }
+
+  pool->busy = t;
+  pool->generation++;
+  pthread_cond_broadcast(&pool->start);
+
+  while (pool->busy > 0)
+    pthread_cond_wait(&pool->done, &pool->lock);
+
+  pthread_mutex_unlock(&pool->lock);
+  pthread_mutex_unlock(&pool->batch);
+}
+
+/*************************************************
+ * Name:        keccak_pool_batch
+ *
+ * Description: Run a batch of messages on the pool,
+ *              KECCAK_POOL_GRAIN messages per grain
+ *
+ * Arguments:   - keccak_pool *pool: pointer to the pool
+ *              - keccak_pool_fn fn: function to compute
+ *              - uint8_t *const out[]: n outputs
+ *              - size_t outlen: output length in bytes, XOFs only
+ *              - const uint8_t *const in[]: n inputs
+ *              - const size_t inlen[]: n input lengths in bytes
+ *              - size_t n: number of messages
+ **************************************************/
+static void keccak_pool_batch(keccak_pool *pool,
+                              keccak_pool_fn fn,
+                              uint8_t *const out[],
+                              size_t outlen,
+                              const uint8_t *const in[],
+                              const size_t inlen[],
+                              size_t n)
+{
+  if (n == 0)
+    return;
+
+  pthread_mutex_lock(&pool->batch);
+  pthread_mutex_lock(&pool->lock);
+
+  pool->fn = fn;
+  pool->out = out;
+  pool->outlen = outlen;
+  pool->in = in;
+  pool->inlen = inlen;
+  pool->n = n;
+  pool->grain = KECCAK_POOL_GRAIN;
+
+  keccak_pool_start(pool);
+}
+
+/*************************************************
+ * Name:        keccak_pool_for
+ *
+ * Description: Run job(arg, i) for i = 0 to n - 1 on the pool, one
+ *              index per grain, for jobs that are large on their own
+ *
+ * Arguments:   - keccak_pool *pool: pointer to the pool
+ *              - void (*job)(void *, size_t): function to run
+ *              - void *arg: first argument of job
+ *              - size_t n: number of indices
+ **************************************************/
+void keccak_pool_for(keccak_pool *pool,
+                     void (*job)(void *arg, size_t i),
+                     void *arg,
+                     size_t n)
+{
+  if (n == 0)
+    return;
+
+  pthread_mutex_lock(&pool->batch);
+  pthread_mutex_lock(&pool->lock);
+
+  pool->fn = POOL_FOR;
+  pool->job = job;
+  pool->arg = arg;
+  pool->n = n;
+  pool->grain = 1;
+
+  keccak_pool_start(pool);
+}
+
+/*************************************************
+ * Name:        shake128_batch_mt
+ *
+ * Description: SHAKE128 XOF on n independent messages,
+ *              spread over the pool
+ *
+ * Arguments:   - keccak_pool *pool: pointer to the pool
+ *              - uint8_t *const out[]: n outputs
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *const in[]: n inputs
+ *              - const size_t inlen[]: n input lengths in bytes
+ *              - size_t n: number of messages
+ **************************************************/
+void shake128_batch_mt(keccak_pool *pool,
+                       uint8_t *const out[],
+                       size_t outlen,
+                       const uint8_t *const in[],
+                       const size_t inlen[],
+                       size_t n)
+{
+  keccak_pool_batch(pool, POOL_SHAKE128, out, outlen, in, inlen, n);
+}
+
+/*************************************************
+ * Name:        shake256_batch_mt
+ *
+ * Description: SHAKE256 XOF on n independent messages,
+ *              spread over the pool
+ *
+ * Arguments:   - keccak_pool *pool: pointer to the pool
+ *              - uint8_t *const out[]: n outputs
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *const in[]: n inputs
+ *              - const size_t inlen[]: n input lengths in bytes
+ *              - size_t n: number of messages
+ **************************************************/
+void shake256_batch_mt(keccak_pool *pool,
+                       uint8_t *const out[],
+                       size_t outlen,
+                       const uint8_t *const in[],
+                       const size_t inlen[],
+                       size_t n)
+{
+  keccak_pool_batch(pool, POOL_SHAKE256, out, outlen, in, inlen, n);
+}
+
+/*************************************************
+ * Name:        sha3_256_batch_mt
+ *
+ * Description: SHA3-256 on n independent messages,
+ *              spread over the pool
+ *
+ * Arguments:   - keccak_pool *pool: pointer to the pool
+ *              - uint8_t *const h[]: n outputs (32 bytes)
+ *              - const uint8_t *const in[]: n inputs
+ *              - const size_t inlen[]: n input lengths in bytes
+ *              - size_t n: number of messages
+ **************************************************/
+void sha3_256_batch_mt(keccak_pool *pool,
+                       uint8_t *const h[],
+                       const uint8_t *const in[],
+                       const size_t inlen[],
+                       size_t n)
+{
+  keccak_pool_batch(pool, POOL_SHA3_256, h, 32, in, inlen, n);
+}
+
+/*************************************************
+ * Name:        sha3_512_batch_mt
+ *
+ * Description: SHA3-512 on n independent messages,
+ *              spread over the pool
+ *
+ * Arguments:   - keccak_pool *pool: pointer to the pool
+ *              - uint8_t *const h[]: n outputs (64 bytes)
+ *              - const uint8_t *const in[]: n inputs
+ *              - const size_t inlen[]: n input lengths in bytes
+ *              - size_t n: number of messages
+ **************************************************/
+void sha3_512_batch_mt(keccak_pool *pool,
+                       uint8_t *const h[],
+                       const uint8_t *const in[],
+                       const size_t inlen[],
+                       size_t n)
+{
+  keccak_pool_batch(pool, POOL_SHA3_512, h, 64, in, inlen, n);
+}
@@ -0,0 +1,78 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#ifndef FIPS202POOL_H
+#define FIPS202POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Thread pool for the batch functions of fips202batch.h. Each worker is
+ * pinned to one CPU, fastest cores first (cpu_capacity on Linux
+ * big.LITTLE), and owns an equal share of the batch; idle workers steal
+ * KECCAK_POOL_GRAIN messages at a time from the others.
+ * Batches on one pool are serialized.
+ */
+#define KECCAK_POOL_GRAIN 64
+
+typedef struct keccak_pool keccak_pool;
+
+/*
+ * nthreads == 0: one worker per CPU this process may run on.
+ * Returns NULL on failure
+ */
+keccak_pool *keccak_pool_create(unsigned int nthreads);
+
+void keccak_pool_destroy(keccak_pool *pool);
+
+unsigned int keccak_pool_threads(const keccak_pool *pool);
+
+/*
+ * Run job(arg, i) for i = 0 to n - 1, one index per grain; for jobs
+ * that are large on their own (e.g. Merkle subtrees)
+ */
+void keccak_pool_for(keccak_pool *pool,
+                     void (*job)(void *arg, size_t i),
+                     void *arg,
+                     size_t n);
+
+void shake128_batch_mt(keccak_pool *pool,
+                       uint8_t *const out[],
+                       size_t outlen,
+                       const uint8_t *const in[],
+                       const size_t inlen[],
+                       size_t n);
+
+void shake256_batch_mt(keccak_pool *pool,
+                       uint8_t *const out[],
+                       size_t outlen,
+                       const uint8_t *const in[],
+                       const size_t inlen[],
+                       size_t n);
+
+void sha3_256_batch_mt(keccak_pool *pool,
+                       uint8_t *const h[],
+                       const uint8_t *const in[],
+                       const size_t inlen[],
+                       size_t n);
+
+void sha3_512_batch_mt(keccak_pool *pool,
+                       uint8_t *const h[],
+                       const uint8_t *const in[],
+                       const size_t inlen[],
+                       size_t n);
+
+#endif
@@ -13,389 +13,32 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 =============================================================================*/
-#include <arm_neon.h>
 #include <stddef.h>
 #include "fips202x2.h"
 
-#define NROUNDS 24
-#define SHA3 1
-
-/*
- * Using vld1q_u64_x4 is consider harmful
- */
-#ifndef MEM
-#define MEM 0
-#endif
-
-// Define NEON operation
-
 // Bitwise-XOR: c = a ^ b
-#define vxor(c, a, b) c = veorq_u64(a, b);
-
-#define pack(out, a, b, c, d) \
-  out.val[0] = a;             \
-  out.val[1] = b;             \
-  out.val[2] = c;             \
-  out.val[3] = d;
-
-#define unpack(a, b, c, d, out) \
-  a = out.val[0];               \
-  b = out.val[1];               \
-  c = out.val[2];               \
-  d = out.val[3];
-
-#if SHA3 == 1
+#define vxor(c, a, b) c = v128_xor(a, b);
 
-/*
- * At least ARMv8.2-sha3 supported
- */
+/*************************************************
+ * Name:        load64_partial
+ *
+ * Description: Load up to 8 bytes into uint64_t in little-endian order,
+ *              missing bytes are zero
+ *
+ * Arguments:   - const uint8_t *x: pointer to input byte array
+ *              - size_t len: number of bytes to load (at most 8)
+ *
+ * Returns the loaded 64-bit unsigned integer
+ **************************************************/
+static uint64_t load64_partial(const uint8_t *x, size_t len)
+{
+  size_t i;
+  uint64_t r = 0;
 
-// Xor chain: out = a ^ b ^ c ^ d ^ e
-#define vXOR5(out, a, b, c, d, e) \
-  out = veor3q_u64(a, b, c);      \
-  out = veor3q_u64(out, d, e);
-
-// Rotate left by 1 bit, then XOR: a ^ ROL(b)
-#define vRXOR(c, a, b) c = vrax1q_u64(a, b);
-
-// XOR then Rotate by n bit: c = ROL(a^b, n)
-#define vXORR(c, a, b, n) c = vxarq_u64(a, b, n);
-
-// Xor Not And: out = a ^ ( (~b) & c)
-#define vXNA(out, a, b, c) out = vbcaxq_u64(a, c, b);
-
-#else
-
-// Rotate left by n bit
-#define vROL(out, a, offset)      \
-  out = vshlq_n_u64(a, (offset)); \
-  out = vsriq_n_u64(out, a, 64 - (offset));
-
-// Xor chain: out = a ^ b ^ c ^ d ^ e
-#define vXOR5(out, a, b, c, d, e) \
-  out = veorq_u64(a, b);          \
-  out = veorq_u64(out, c);        \
-  out = veorq_u64(out, d);        \
-  out = veorq_u64(out, e);
-
-// Xor Not And: out = a ^ ( (~b) & c)
-#define vXNA(out, a, b, c) \
-  out = vbicq_u64(c, b);   \
-  out = veorq_u64(out, a);
-
-#define vRXOR(c, a, b) \
-  vROL(c, b, 1);       \
-  vxor(c, c, a);
-
-#define vXORR(c, a, b, n) \
-  a = veorq_u64(a, b);    \
-  vROL(c, a, 64 - n);
-
-#endif
-
-// End
-
-/* Keccak round constants */
-static const uint64_t neon_KeccakF_RoundConstants[NROUNDS] = {
-    (uint64_t)0x0000000000000001ULL,
-    (uint64_t)0x0000000000008082ULL,
-    (uint64_t)0x800000000000808aULL,
-    (uint64_t)0x8000000080008000ULL,
-    (uint64_t)0x000000000000808bULL,
-    (uint64_t)0x0000000080000001ULL,
-    (uint64_t)0x8000000080008081ULL,
-    (uint64_t)0x8000000000008009ULL,
-    (uint64_t)0x000000000000008aULL,
-    (uint64_t)0x0000000000000088ULL,
-    (uint64_t)0x0000000080008009ULL,
-    (uint64_t)0x000000008000000aULL,
-    (uint64_t)0x000000008000808bULL,
-    (uint64_t)0x800000000000008bULL,
-    (uint64_t)0x8000000000008089ULL,
-    (uint64_t)0x8000000000008003ULL,
-    (uint64_t)0x8000000000008002ULL,
-    (uint64_t)0x8000000000000080ULL,
-    (uint64_t)0x000000000000800aULL,
-    (uint64_t)0x800000008000000aULL,
-    (uint64_t)0x8000000080008081ULL,
-    (uint64_t)0x8000000000008080ULL,
-    (uint64_t)0x0000000080000001ULL,
-    (uint64_t)0x8000000080008008ULL};
-
-/*************************************************
- * Name:        KeccakF1600_StatePermutex2
- *
- * Description: The Keccak F1600 Permutation
- *
- * Arguments:   - v128 *state: pointer to input/output Keccak state
- **************************************************/
-void KeccakF1600_StatePermutex2(v128 state[25])
-{
-
-  v128 Aba, Abe, Abi, Abo, Abu;
-  v128 Aga, Age, Agi, Ago, Agu;
-  v128 Aka, Ake, Aki, Ako, Aku;
-  v128 Ama, Ame, Ami, Amo, Amu;
-  v128 Asa, Ase, Asi, Aso, Asu;
-  v128 BCa, BCe, BCi, BCo, BCu; // tmp
-  v128 Da, De, Di, Do, Du;      // D
-  v128 Eba, Ebe, Ebi, Ebo, Ebu;
-  v128 Ega, Ege, Egi, Ego, Egu;
-  v128 Eka, Eke, Eki, Eko, Eku;
-  v128 Ema, Eme, Emi, Emo, Emu;
-  v128 Esa, Ese, Esi, Eso, Esu;
-
-#if MEM == 1
-  uint64x2x4_t holder;
-
-  holder = vld1q_u64_x4((uint64_t *)&state[0]);
-  unpack(Aba, Abe, Abi, Abo, holder);
-
-  holder = vld1q_u64_x4((uint64_t *)&state[4]);
-  unpack(Abu, Aga, Age, Agi, holder);
-
-  holder = vld1q_u64_x4((uint64_t *)&state[8]);
-  unpack(Ago, Agu, Aka, Ake, holder);
-
-  holder = vld1q_u64_x4((uint64_t *)&state[12]);
-  unpack(Aki, Ako, Aku, Ama, holder);
-
-  holder = vld1q_u64_x4((uint64_t *)&state[16]);
-  unpack(Ame, Ami, Amo, Amu, holder);
-
-  holder = vld1q_u64_x4((uint64_t *)&state[20]);
-  unpack(Asa, Ase, Asi, Aso, holder);
-
-  Asu = vld1q_u64((uint64_t *)&state[24]);
-#else
-  Aba = state[0];
-  Abe = state[1];
-  Abi = state[2];
-  Abo = state[3];
-  Abu = state[4];
-  Aga = state[5];
-  Age = state[6];
-  Agi = state[7];
-  Ago = state[8];
-  Agu = state[9];
-  Aka = state[10];
-  Ake = state[11];
-  Aki = state[12];
-  Ako = state[13];
-  Aku = state[14];
-  Ama = state[15];
-  Ame = state[16];
-  Ami = state[17];
-  Amo = state[18];
-  Amu = state[19];
-  Asa = state[20];
-  Ase = state[21];
-  Asi = state[22];
-  Aso = state[23];
-  Asu = state[24];
-#endif
-
-  for (int round = 0; round < NROUNDS; round += 2)
-  {
-    //    prepareTheta
-    vXOR5(BCa, Aba, Aga, Aka, Ama, Asa);
-    vXOR5(BCe, Abe, Age, Ake, Ame, Ase);
-    vXOR5(BCi, Abi, Agi, Aki, Ami, Asi);
-    vXOR5(BCo, Abo, Ago, Ako, Amo, Aso);
-    vXOR5(BCu, Abu, Agu, Aku, Amu, Asu);
-
-    vRXOR(Da, BCu, BCe);
-    vRXOR(De, BCa, BCi);
-    vRXOR(Di, BCe, BCo);
-    vRXOR(Do, BCi, BCu);
-    vRXOR(Du, BCo, BCa);
-
-    vxor(Aba, Aba, Da);
-    vXORR(BCe, Age, De, 20);
-    vXORR(BCi, Aki, Di, 21);
-    vXORR(BCo, Amo, Do, 43);
-    vXORR(BCu, Asu, Du, 50);
-
-    vXNA(Eba, Aba, BCe, BCi);
-    vxor(Eba, Eba, vld1q_dup_u64(&neon_KeccakF_RoundConstants[round]));
-    vXNA(Ebe, BCe, BCi, BCo);
-    vXNA(Ebi, BCi, BCo, BCu);
-    vXNA(Ebo, BCo, BCu, Aba);
-    vXNA(Ebu, BCu, Aba, BCe);
-
-    vXORR(BCa, Abo, Do, 36);
-    vXORR(BCe, Agu, Du, 44);
-    vXORR(BCi, Aka, Da, 61);
-    vXORR(BCo, Ame, De, 19);
-    vXORR(BCu, Asi, Di, 3);
-
-    vXNA(Ega, BCa, BCe, BCi);
-    vXNA(Ege, BCe, BCi, BCo);
-    vXNA(Egi, BCi, BCo, BCu);
-    vXNA(Ego, BCo, BCu, BCa);
-    vXNA(Egu, BCu, BCa, BCe);
-
-    vXORR(BCa, Abe, De, 63);
-    vXORR(BCe, Agi, Di, 58);
-    vXORR(BCi, Ako, Do, 39);
-    vXORR(BCo, Amu, Du, 56);
-    vXORR(BCu, Asa, Da, 46);
-
-    vXNA(Eka, BCa, BCe, BCi);
-    vXNA(Eke, BCe, BCi, BCo);
-    vXNA(Eki, BCi, BCo, BCu);
-    vXNA(Eko, BCo, BCu, BCa);
-    vXNA(Eku, BCu, BCa, BCe);
-
-    vXORR(BCa, Abu, Du, 37);
-    vXORR(BCe, Aga, Da, 28);
-    vXORR(BCi, Ake, De, 54);
-    vXORR(BCo, Ami, Di, 49);
-    vXORR(BCu, Aso, Do, 8);
-
-    vXNA(Ema, BCa, BCe, BCi);
-    vXNA(Eme, BCe, BCi, BCo);
-    vXNA(Emi, BCi, BCo, BCu);
-    vXNA(Emo, BCo, BCu, BCa);
-    vXNA(Emu, BCu, BCa, BCe);
-
-    vXORR(BCa, Abi, Di, 2);
-    vXORR(BCe, Ago, Do, 9);
-    vXORR(BCi, Aku, Du, 25);
-    vXORR(BCo, Ama, Da, 23);
-    vXORR(BCu, Ase, De, 62);
-
-    vXNA(Esa, BCa, BCe, BCi);
-    vXNA(Ese, BCe, BCi, BCo);
-    vXNA(Esi, BCi, BCo, BCu);
-    vXNA(Eso, BCo, BCu, BCa);
-    vXNA(Esu, BCu, BCa, BCe);
-
-    // Next Round
-
-    //    prepareTheta
-    vXOR5(BCa, Eba, Ega, Eka, Ema, Esa);
-    vXOR5(BCe, Ebe, Ege, Eke, Eme, Ese);
-    vXOR5(BCi, Ebi, Egi, Eki, Emi, Esi);
-    vXOR5(BCo, Ebo, Ego, Eko, Emo, Eso);
-    vXOR5(BCu, Ebu, Egu, Eku, Emu, Esu);
-
-    // thetaRhoPiChiIotaPrepareTheta(round+1, E, A)
-    vRXOR(Da, BCu, BCe);
-    vRXOR(De, BCa, BCi);
-    vRXOR(Di, BCe, BCo);
-    vRXOR(Do, BCi, BCu);
-    vRXOR(Du, BCo, BCa);
-
-    vxor(Eba, Eba, Da);
-    vXORR(BCe, Ege, De, 20);
-    vXORR(BCi, Eki, Di, 21);
-    vXORR(BCo, Emo, Do, 43);
-    vXORR(BCu, Esu, Du, 50);
-
-    vXNA(Aba, Eba, BCe, BCi);
-    vxor(Aba, Aba, vld1q_dup_u64(&neon_KeccakF_RoundConstants[round + 1]));
-    vXNA(Abe, BCe, BCi, BCo);
-    vXNA(Abi, BCi, BCo, BCu);
-    vXNA(Abo, BCo, BCu, Eba);
-    vXNA(Abu, BCu, Eba, BCe);
-
-    vXORR(BCa, Ebo, Do, 36);
-    vXORR(BCe, Egu, Du, 44);
-    vXORR(BCi, Eka, Da, 61);
-    vXORR(BCo, Eme, De, 19);
-    vXORR(BCu, Esi, Di, 3);
-
-    vXNA(Aga, BCa, BCe, BCi);
-    vXNA(Age, BCe, BCi, BCo);
-    vXNA(Agi, BCi, BCo, BCu);
-    vXNA(Ago, BCo, BCu, BCa);
-    vXNA(Agu, BCu, BCa, BCe);
-
-    vXORR(BCa, Ebe, De, 63);
-    vXORR(BCe, Egi, Di, 58);
-    vXORR(BCi, Eko, Do, 39);
-    vXORR(BCo, Emu, Du, 56);
-    vXORR(BCu, Esa, Da, 46);
-
-    vXNA(Aka, BCa, BCe, BCi);
-    vXNA(Ake, BCe, BCi, BCo);
-    vXNA(Aki, BCi, BCo, BCu);
-    vXNA(Ako, BCo, BCu, BCa);
-    vXNA(Aku, BCu, BCa, BCe);
-
-    vXORR(BCa, Ebu, Du, 37);
-    vXORR(BCe, Ega, Da, 28);
-    vXORR(BCi, Eke, De, 54);
-    vXORR(BCo, Emi, Di, 49);
-    vXORR(BCu, Eso, Do, 8);
-
-    vXNA(Ama, BCa, BCe, BCi);
-    vXNA(Ame, BCe, BCi, BCo);
-    vXNA(Ami, BCi, BCo, BCu);
-    vXNA(Amo, BCo, BCu, BCa);
-    vXNA(Amu, BCu, BCa, BCe);
-
-    vXORR(BCa, Ebi, Di, 2);
-    vXORR(BCe, Ego, Do, 9);
-    vXORR(BCi, Eku, Du, 25);
-    vXORR(BCo, Ema, Da, 23);
-    vXORR(BCu, Ese, De, 62);
-
-    vXNA(Asa, BCa, BCe, BCi);
-    vXNA(Ase, BCe, BCi, BCo);
-    vXNA(Asi, BCi, BCo, BCu);
-    vXNA(Aso, BCo, BCu, BCa);
-    vXNA(Asu, BCu, BCa, BCe);
-  }
+  for (i = 0; i < len; ++i)
+    r |= (uint64_t)x[i] << 8 * i;
 
-#if MEM == 1
-  pack(holder, Aba, Abe, Abi, Abo);
-  vst1q_u64_x4((uint64_t *)&state[0], holder);
-
-  pack(holder, Abu, Aga, Age, Agi);
-  vst1q_u64_x4((uint64_t *)&state[4], holder);
-
-  pack(holder, Ago, Agu, Aka, Ake);
-  vst1q_u64_x4((uint64_t *)&state[8], holder);
-
-  pack(holder, Aki, Ako, Aku, Ama);
-  vst1q_u64_x4((uint64_t *)&state[12], holder);
-
-  pack(holder, Ame, Ami, Amo, Amu);
-  vst1q_u64_x4((uint64_t *)&state[16], holder);
-
-  pack(holder, Asa, Ase, Asi, Aso);
-  vst1q_u64_x4((uint64_t *)&state[20], holder);
-
-  vst1q_u64((uint64_t *)&state[24], Asu);
-#else
-  state[0] = Aba;
-  state[1] = Abe;
-  state[2] = Abi;
-  state[3] = Abo;
-  state[4] = Abu;
-  state[5] = Aga;
-  state[6] = Age;
-  state[7] = Agi;
-  state[8] = Ago;
-  state[9] = Agu;
-  state[10] = Aka;
-  state[11] = Ake;
-  state[12] = Aki;
-  state[13] = Ako;
-  state[14] = Aku;
-  state[15] = Ama;
-  state[16] = Ame;
-  state[17] = Ami;
-  state[18] = Amo;
-  state[19] = Amu;
-  state[20] = Asa;
-  state[21] = Ase;
-  state[22] = Asi;
-  state[23] = Aso;
-  state[24] = Asu;
-#endif
+  return r;
 }
 
 /*************************************************
@@ -421,60 +64,25 @@ void keccakx2_absorb(v128 s[25],
   size_t i, pos = 0;
 
   // Declare SIMD registers
-  v128 tmp, mask;
-  uint64x1_t a, b;
-  uint64x2_t a1, b1, atmp1, btmp1;
-  uint64x2x2_t a2, b2, atmp2, btmp2;
+  v128 tmp, a1, b1;
   // End
 
   for (i = 0; i < 25; ++i)
-    s[i] = vdupq_n_u64(0);
-
-  // Load in0[i] to register, then in1[i] to register, exchange them
-  while (inlen >= r)
-  {
-    for (i = 0; i < r / 8 - 1; i += 4)
-    {
-      a2 = vld1q_u64_x2((uint64_t *)&in0[pos]);
-      b2 = vld1q_u64_x2((uint64_t *)&in1[pos]);
-      // BD = zip1(AB and CD)
-      atmp2.val[0] = vzip1q_u64(a2.val[0], b2.val[0]);
-      atmp2.val[1] = vzip1q_u64(a2.val[1], b2.val[1]);
-      // AC = zip2(AB and CD)
-      btmp2.val[0] = vzip2q_u64(a2.val[0], b2.val[0]);
-      btmp2.val[1] = vzip2q_u64(a2.val[1], b2.val[1]);
-
-      vxor(s[i + 0], s[i + 0], atmp2.val[0]);
-      vxor(s[i + 1], s[i + 1], btmp2.val[0]);
-      vxor(s[i + 2], s[i + 2], atmp2.val[1]);
-      vxor(s[i + 3], s[i + 3], btmp2.val[1]);
-
-      pos += 8 * 2 * 2;
-    }
-    // Last iteration
-    i = r / 8 - 1;
-    a = vld1_u64((uint64_t *)&in0[pos]);
-    b = vld1_u64((uint64_t *)&in1[pos]);
-    tmp = vcombine_u64(a, b);
-    vxor(s[i], s[i], tmp);
-    pos += 8;
+    s[i] = v128_zero();
 
-    KeccakF1600_StatePermutex2(s);
-    inlen -= r;
-  }
+  pos = (inlen / r) * r;
+  KeccakF1600_StateAbsorbx2(s, r, in0, in1, inlen / r);
+  inlen -= pos;
 
   i = 0;
   while (inlen >= 16)
   {
-    a1 = vld1q_u64((uint64_t *)&in0[pos]);
-    b1 = vld1q_u64((uint64_t *)&in1[pos]);
+    a1 = v128_load(&in0[pos]);
+    b1 = v128_load(&in1[pos]);
     // BD = zip1(AB and CD)
-    atmp1 = vzip1q_u64(a1, b1);
+    vxor(s[i + 0], s[i + 0], v128_zip0(a1, b1));
     // AC = zip2(AB and CD)
-    btmp1 = vzip2q_u64(a1, b1);
-
-    vxor(s[i + 0], s[i + 0], atmp1);
-    vxor(s[i + 1], s[i + 1], btmp1);
+    vxor(s[i + 1], s[i + 1], v128_zip1(a1, b1));
 
     i += 2;
     pos += 8 * 2;
@@ -483,9 +91,7 @@ void keccakx2_absorb(v128 s[25],
 
   if (inlen >= 8)
   {
-    a = vld1_u64((uint64_t *)&in0[pos]);
-    b = vld1_u64((uint64_t *)&in1[pos]);
-    tmp = vcombine_u64(a, b);
+    tmp = v128_load2(&in0[pos], &in1[pos]);
     vxor(s[i], s[i], tmp);
 
     i++;
@@ -493,21 +99,19 @@ void keccakx2_absorb(v128 s[25],
     inlen -= 8;
   }
 
+  // Partial word, no read past the end of the inputs
   if (inlen)
   {
-    a = vld1_u64((uint64_t *)&in0[pos]);
-    b = vld1_u64((uint64_t *)&in1[pos]);
-    tmp = vcombine_u64(a, b);
-    mask = vdupq_n_u64((1ULL << (8 * inlen)) - 1);
-    tmp = vandq_u64(tmp, mask);
+    tmp = v128_set(load64_partial(&in0[pos], inlen),
+                   load64_partial(&in1[pos], inlen));
     vxor(s[i], s[i], tmp);
   }
 
-  tmp = vdupq_n_u64((uint64_t)p << (8 * inlen));
+  tmp = v128_dup((uint64_t)p << (8 * inlen));
   vxor(s[i], s[i], tmp);
 
-  mask = vdupq_n_u64(1ULL << 63);
-  vxor(s[r / 8 - 1], s[r / 8 - 1], mask);
+  tmp = v128_dup(1ULL << 63);
+  vxor(s[r / 8 - 1], s[r / 8 - 1], tmp);
 }
 
 /*************************************************
@@ -527,41 +131,486 @@ void keccakx2_squeezeblocks(uint8_t *out0,
                             size_t nblocks,
                             unsigned int r,
                             v128 s[25])
+{
+  KeccakF1600_StateSqueezex2(s, r, out0, out1, nblocks);
+}
+
+/*************************************************
+ * Name:        keccakx2_absorb_interleaved
+ *
+ * Description: keccakx2_absorb on one lane-interleaved buffer: word i of
+ *              the first input at in[16 * i], word i of the second at
+ *              in[16 * i + 8], so every word pair is a plain v128 load.
+ *              A partial last word takes 8 bytes of each 16.
+ *
+ * Arguments:   - v128 *s: pointer to (uninitialized) output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - const uint8_t *in: pointer to interleaved input
+ *              - size_t inlen: length of each input in bytes
+ *              - uint8_t p: domain-separation byte for different
+ *                           Keccak-derived functions
+ **************************************************/
+void keccakx2_absorb_interleaved(v128 s[25],
+                                 unsigned int r,
+                                 const uint8_t *in,
+                                 size_t inlen,
+                                 uint8_t p)
+{
+  size_t i;
+  v128 tmp;
+
+  for (i = 0; i < 25; ++i)
+    s[i] = v128_zero();
+
+  KeccakF1600_StateAbsorbInterleavedx2(s, r, in, inlen / r);
+  in += 2 * (inlen / r) * r;
+  inlen %= r;
+
+  for (i = 0; inlen >= 8; ++i)
+  {
+    vxor(s[i], s[i], v128_load(&in[16 * i]));
+    inlen -= 8;
+  }
+
+  if (inlen)
+  {
+    tmp = v128_set(load64_partial(&in[16 * i], inlen),
+                   load64_partial(&in[16 * i + 8], inlen));
+    vxor(s[i], s[i], tmp);
+  }
+
+  tmp = v128_dup((uint64_t)p << (8 * inlen));
+  vxor(s[i], s[i], tmp);
+
+  tmp = v128_dup(1ULL << 63);
+  vxor(s[r / 8 - 1], s[r / 8 - 1], tmp);
+}
+
+/*************************************************
+ * Name:        keccakx2_squeezeblocks_interleaved
+ *
+ * Description: keccakx2_squeezeblocks to one lane-interleaved buffer of
+ *              2 * r bytes per block, laid out as for
+ *              keccakx2_absorb_interleaved
+ *
+ * Arguments:   - uint8_t *out: pointer to interleaved output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - v128 *s: pointer to input/output Keccak state
+ **************************************************/
+void keccakx2_squeezeblocks_interleaved(uint8_t *out,
+                                        size_t nblocks,
+                                        unsigned int r,
+                                        v128 s[25])
+{
+  KeccakF1600_StateSqueezeInterleavedx2(s, r, out, nblocks);
+}
+
+/*************************************************
+ * Name:        keccakx2_extract
+ *
+ * Description: Copy n bytes of each lane, starting at byte pos of the
+ *              current block, without permuting. Lane pairs starting on
+ *              a 16-byte boundary are stored straight to the output.
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointer to output
+ *              - size_t n: number of bytes, pos + n at most the rate
+ *              - unsigned int pos: position in the current block
+ *              - const v128 *s: pointer to input Keccak state
+ **************************************************/
+static void keccakx2_extract(uint8_t *out0,
+                             uint8_t *out1,
+                             size_t n,
+                             unsigned int pos,
+                             const v128 s[25])
+{
+  unsigned int i, j, k;
+  uint8_t t[2][16];
+
+  while (n > 0)
+  {
+    j = pos / 16 * 2;
+
+    if ((pos & 15) == 0 && n >= 16)
+    {
+      v128_store(out0, v128_zip0(s[j], s[j + 1]));
+      v128_store(out1, v128_zip1(s[j], s[j + 1]));
+      k = 16;
+    }
+    else
+    {
+      v128_store(t[0], v128_zip0(s[j], s[j + 1]));
+      v128_store(t[1], v128_zip1(s[j], s[j + 1]));
+
+      k = 16 - (pos & 15);
+      if (k > n)
+        k = n;
+      for (i = 0; i < k; ++i)
+      {
+        out0[i] = t[0][(pos & 15) + i];
+        out1[i] = t[1][(pos & 15) + i];
+      }
+    }
+
+    out0 += k;
+    out1 += k;
+    pos += k;
+    n -= k;
+  }
+}
+
+/*************************************************
+ * Name:        keccakx2_inc_squeeze
+ *
+ * Description: Incremental squeeze step of Keccak, any number of calls
+ *              with any output length. Whole blocks go through
+ *              keccakx2_squeezeblocks, the rest of a block is kept in
+ *              the state for the next call.
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - unsigned int pos: bytes of the current block already
+ *                                  squeezed, r right after finalize
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - v128 *s: pointer to input/output Keccak state
+ *
+ * Returns new position pos in current block
+ **************************************************/
+unsigned int keccakx2_inc_squeeze(uint8_t *out0,
+                                  uint8_t *out1,
+                                  size_t outlen,
+                                  unsigned int pos,
+                                  unsigned int r,
+                                  v128 s[25])
+{
+  size_t n;
+
+  while (outlen > 0)
+  {
+    if (pos == r)
+    {
+      if (outlen >= r)
+      {
+        n = outlen / r;
+        keccakx2_squeezeblocks(out0, out1, n, r, s);
+        out0 += n * r;
+        out1 += n * r;
+        outlen -= n * r;
+        continue;
+      }
+
+      KeccakF1600_StatePermutex2(s);
+      pos = 0;
+    }
+
+    n = r - pos;
+    if (n > outlen)
+      n = outlen;
+
+    keccakx2_extract(out0, out1, n, pos, s);
+
+    out0 += n;
+    out1 += n;
+    pos += n;
+    outlen -= n;
+  }
+
+  return pos;
+}
+
+/*************************************************
+ * Name:        keccakx2_squeeze
+ *
+ * Description: Squeeze outlen bytes from each lane of a finalized state;
+ *              non-incremental
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - v128 *s: pointer to input/output Keccak state
+ **************************************************/
+void keccakx2_squeeze(uint8_t *out0,
+                      uint8_t *out1,
+                      size_t outlen,
+                      unsigned int r,
+                      v128 s[25])
+{
+  keccakx2_inc_squeeze(out0, out1, outlen, r, r, s);
+}
+
+/*************************************************
+ * Name:        keccakx2_squeezedigest
+ *
+ * Description: Squeeze the first nlanes 8-byte lanes of one block,
+ *              straight into the digests
+ *
+ * Arguments:   - uint8_t *h1, *h2: pointer to output (8 * nlanes bytes)
+ *              - unsigned int nlanes: even number of lanes, at most the rate
+ *              - v128 *s: pointer to input/output Keccak state
+ **************************************************/
+static void keccakx2_squeezedigest(uint8_t *h1,
+                                   uint8_t *h2,
+                                   unsigned int nlanes,
+                                   v128 s[25])
+{
+  unsigned int i;
+
+  KeccakF1600_StatePermutex2(s);
+
+  for (i = 0; i < nlanes; i += 2)
+  {
+    v128_store(&h1[8 * i], v128_zip0(s[i], s[i + 1]));
+    v128_store(&h2[8 * i], v128_zip1(s[i], s[i + 1]));
+  }
+}
+
+/*************************************************
+ * Name:        keccakx2_inc_init
+ *
+ * Description: Initializes the incremental Keccak state to zero.
+ *
+ * Arguments:   - v128 *s: pointer to output Keccak state
+ **************************************************/
+static void keccakx2_inc_init(v128 s[25])
 {
   unsigned int i;
 
-  uint64x1_t a, b;
-  uint64x2x2_t a2, b2;
+  for (i = 0; i < 25; ++i)
+    s[i] = v128_zero();
+}
+
+/*************************************************
+ * Name:        keccakx2_inc_absorb
+ *
+ * Description: Incremental absorb step of Keccak. Absorbs inlen bytes
+ *              of each input on top of the pos bytes already absorbed
+ *              into the current block; can be called any number of times.
+ *
+ * Arguments:   - v128 *s: pointer to input/output Keccak state
+ *              - unsigned int pos: position in current block to be absorbed
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - const uint8_t *in0, *in1: pointer to input to be absorbed into s
+ *              - size_t inlen: length of input in bytes
+ *
+ * Returns new position pos in current block
+ **************************************************/
+unsigned int keccakx2_inc_absorb(v128 s[25],
+                                 unsigned int pos,
+                                 unsigned int r,
+                                 const uint8_t *in0,
+                                 const uint8_t *in1,
+                                 size_t inlen)
+{
+  size_t n;
+  v128 tmp;
+
+  // Complete the partially absorbed lane
+  if (pos & 7)
+  {
+    n = 8 - (pos & 7);
+    if (n > inlen)
+      n = inlen;
+
+    tmp = v128_set(load64_partial(in0, n) << 8 * (pos & 7),
+                   load64_partial(in1, n) << 8 * (pos & 7));
+    vxor(s[pos / 8], s[pos / 8], tmp);
+
+    pos += n;
+    in0 += n;
+    in1 += n;
+    inlen -= n;
+
+    if (pos == r)
+    {
+      KeccakF1600_StatePermutex2(s);
+      pos = 0;
+    }
+  }
+
+  while (inlen >= 8)
+  {
+    // Whole blocks skip the per-lane bookkeeping
+    if (pos == 0 && inlen >= r)
+    {
+      n = inlen / r;
+      KeccakF1600_StateAbsorbx2(s, r, in0, in1, n);
+      in0 += n * r;
+      in1 += n * r;
+      inlen -= n * r;
+      continue;
+    }
+
+    tmp = v128_load2(in0, in1);
+    vxor(s[pos / 8], s[pos / 8], tmp);
+
+    pos += 8;
+    in0 += 8;
+    in1 += 8;
+    inlen -= 8;
+
+    if (pos == r)
+    {
+      KeccakF1600_StatePermutex2(s);
+      pos = 0;
+    }
+  }
+
+  // Remaining bytes start on a lane boundary here
+  if (inlen)
+  {
+    tmp = v128_set(load64_partial(in0, inlen), load64_partial(in1, inlen));
+    vxor(s[pos / 8], s[pos / 8], tmp);
+
+    pos += inlen;
+  }
+
+  return pos;
+}
+
+/*************************************************
+ * Name:        keccakx2_inc_finalize
+ *
+ * Description: Finalize absorb step: adds the domain-separation byte
+ *              and the final padding bit.
+ *
+ * Arguments:   - v128 *s: pointer to input/output Keccak state
+ *              - unsigned int pos: position in current block to be absorbed
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - uint8_t p: domain-separation byte for different
+ *                           Keccak-derived functions
+ **************************************************/
+void keccakx2_inc_finalize(v128 s[25],
+                           unsigned int pos,
+                           unsigned int r,
+                           uint8_t p)
+{
+  v128 tmp;
+
+  tmp = v128_dup((uint64_t)p << 8 * (pos & 7));
+  vxor(s[pos / 8], s[pos / 8], tmp);
+
+  tmp = v128_dup(1ULL << 63);
+  vxor(s[r / 8 - 1], s[r / 8 - 1], tmp);
+}
+
+/*************************************************
+ * Name:        keccakx2_load_tail
+ *
+ * Description: Load one 8-byte lane of a message tail, zero-padded
+ *              past the end of the message.
+ *
+ * Arguments:   - const uint8_t *in: pointer to message
+ *              - size_t inlen: length of message in bytes
+ *              - size_t pos: offset of the lane in bytes
+ *
+ * Returns the loaded lane
+ **************************************************/
+static uint64_t keccakx2_load_tail(const uint8_t *in,
+                                   size_t inlen,
+                                   size_t pos)
+{
+  if (pos + 8 <= inlen)
+    return v128_load64(&in[pos]);
+  if (pos < inlen)
+    return load64_partial(&in[pos], inlen - pos);
+  return 0;
+}
+
+/*************************************************
+ * Name:        keccakx2_absorb_var
+ *
+ * Description: Absorb step of Keccak with a different input length per
+ *              lane; non-incremental, starts by zeroeing the state.
+ *              Blocks present in both inputs are permuted together, the
+ *              surplus blocks of the longer input are permuted while the
+ *              idle lane is preserved, tails and padding are per lane.
+ *
+ * Arguments:   - v128 *s: pointer to (uninitialized) output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - const uint8_t *in0, *in1: pointer to input to be absorbed into s
+ *              - size_t inlen0, inlen1: length of each input in bytes
+ *              - uint8_t p: domain-separation byte for different
+ *                           Keccak-derived functions
+ **************************************************/
+static void keccakx2_absorb_var(v128 s[25],
+                                unsigned int r,
+                                const uint8_t *in0,
+                                const uint8_t *in1,
+                                size_t inlen0,
+                                size_t inlen1,
+                                uint8_t p)
+{
+  size_t i, nblocks;
+  v128 tmp, saved[25];
 
-  while (nblocks > 0)
+  for (i = 0; i < 25; ++i)
+    s[i] = v128_zero();
+
+  // Both lanes busy
+  nblocks = (inlen0 < inlen1 ? inlen0 : inlen1) / r;
+  KeccakF1600_StateAbsorbx2(s, r, in0, in1, nblocks);
+  in0 += nblocks * r;
+  in1 += nblocks * r;
+  inlen0 -= nblocks * r;
+  inlen1 -= nblocks * r;
+
+  // At most one of these loops runs: only lane 0 or only lane 1 busy
+  while (inlen0 >= r)
   {
+    for (i = 0; i < r / 8; ++i)
+    {
+      saved[i] = s[i];
+      tmp = v128_set(v128_load64(&in0[8 * i]), 0);
+      vxor(s[i], s[i], tmp);
+    }
+    for (; i < 25; ++i)
+      saved[i] = s[i];
+
     KeccakF1600_StatePermutex2(s);
 
-    for (i = 0; i < r / 8 - 1; i += 4)
+    for (i = 0; i < 25; ++i)
+      s[i] = v128_merge(s[i], saved[i]);
+
+    in0 += r;
+    inlen0 -= r;
+  }
+
+  while (inlen1 >= r)
+  {
+    for (i = 0; i < r / 8; ++i)
     {
-      a2.val[0] = vuzp1q_u64(s[i], s[i + 1]);
-      b2.val[0] = vuzp2q_u64(s[i], s[i + 1]);
-      a2.val[1] = vuzp1q_u64(s[i + 2], s[i + 3]);
-      b2.val[1] = vuzp2q_u64(s[i + 2], s[i + 3]);
-      vst1q_u64_x2((uint64_t *)out0, a2);
-      vst1q_u64_x2((uint64_t *)out1, b2);
-
-      out0 += 32;
-      out1 += 32;
+      saved[i] = s[i];
+      tmp = v128_set(0, v128_load64(&in1[8 * i]));
+      vxor(s[i], s[i], tmp);
     }
+    for (; i < 25; ++i)
+      saved[i] = s[i];
+
+    KeccakF1600_StatePermutex2(s);
 
-    i = r / 8 - 1;
-    // Last iteration
-    a = vget_low_u64(s[i]);
-    b = vget_high_u64(s[i]);
-    vst1_u64((uint64_t *)out0, a);
-    vst1_u64((uint64_t *)out1, b);
+    for (i = 0; i < 25; ++i)
+      s[i] = v128_merge(saved[i], s[i]);
 
-    out0 += 8;
-    out1 += 8;
+    in1 += r;
+    inlen1 -= r;
+  }
 
-    --nblocks;
+  // Tails, zero-padded per lane
+  for (i = 0; 8 * i < inlen0 || 8 * i < inlen1; ++i)
+  {
+    tmp = v128_set(keccakx2_load_tail(in0, inlen0, 8 * i),
+                   keccakx2_load_tail(in1, inlen1, 8 * i));
+    vxor(s[i], s[i], tmp);
   }
+
+  // Domain-separation byte lands at a different position in each lane
+  tmp = v128_set((uint64_t)p << 8 * (inlen0 & 7), 0);
+  vxor(s[inlen0 / 8], s[inlen0 / 8], tmp);
+  tmp = v128_set(0, (uint64_t)p << 8 * (inlen1 & 7));
+  vxor(s[inlen1 / 8], s[inlen1 / 8], tmp);
+
+  tmp = v128_dup(1ULL << 63);
+  vxor(s[r / 8 - 1], s[r / 8 - 1], tmp);
 }
 
 /*************************************************
@@ -581,6 +630,7 @@ void shake128x2_absorb(keccakx2_state *state,
                        size_t inlen)
 {
   keccakx2_absorb(state->s, SHAKE128_RATE, in0, in1, inlen, 0x1F);
+  state->pos = SHAKE128_RATE;
 }
 
 /*************************************************
@@ -603,6 +653,27 @@ void shake128x2_squeezeblocks(uint8_t *out0,
   keccakx2_squeezeblocks(out0, out1, nblocks, SHAKE128_RATE, state->s);
 }
 
+/*************************************************
+ * Name:        shake128x2_squeeze
+ *
+ * Description: Squeeze step of SHAKE128 XOF with any output length per
+ *              call; the position within the current block is kept in
+ *              the state, so calls can be mixed with any lengths. Do not
+ *              mix with shake128x2_squeezeblocks on the same state.
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - keccakx2_state *s: pointer to input/output Keccak state
+ **************************************************/
+void shake128x2_squeeze(uint8_t *out0,
+                        uint8_t *out1,
+                        size_t outlen,
+                        keccakx2_state *state)
+{
+  state->pos = keccakx2_inc_squeeze(out0, out1, outlen, state->pos,
+                                    SHAKE128_RATE, state->s);
+}
+
 /*************************************************
  * Name:        shake256x2_absorb
  *
@@ -619,6 +690,7 @@ void shake256x2_absorb(keccakx2_state *state,
                        size_t inlen)
 {
   keccakx2_absorb(state->s, SHAKE256_RATE, in0, in1, inlen, 0x1F);
+  state->pos = SHAKE256_RATE;
 }
 
 /*************************************************
@@ -641,6 +713,295 @@ void shake256x2_squeezeblocks(uint8_t *out0,
   keccakx2_squeezeblocks(out0, out1, nblocks, SHAKE256_RATE, state->s);
 }
 
+/*************************************************
+ * Name:        shake256x2_squeeze
+ *
+ * Description: Squeeze step of SHAKE256 XOF with any output length per
+ *              call; the position within the current block is kept in
+ *              the state, so calls can be mixed with any lengths. Do not
+ *              mix with shake256x2_squeezeblocks on the same state.
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - keccakx2_state *s: pointer to input/output Keccak state
+ **************************************************/
+void shake256x2_squeeze(uint8_t *out0,
+                        uint8_t *out1,
+                        size_t outlen,
+                        keccakx2_state *state)
+{
+  state->pos = keccakx2_inc_squeeze(out0, out1, outlen, state->pos,
+                                    SHAKE256_RATE, state->s);
+}
+
+/*************************************************
+ * Name:        shake128x2_absorb_interleaved
+ *
+ * Description: shake128x2_absorb on one lane-interleaved buffer, see
+ *              keccakx2_absorb_interleaved
+ *
+ * Arguments:   - keccakx2_state *state: pointer to (uninitialized) output
+ *                                     Keccak state
+ *              - const uint8_t *in: pointer to interleaved input
+ *              - size_t inlen: length of each input in bytes
+ **************************************************/
+void shake128x2_absorb_interleaved(keccakx2_state *state,
+                                   const uint8_t *in,
+                                   size_t inlen)
+{
+  keccakx2_absorb_interleaved(state->s, SHAKE128_RATE, in, inlen, 0x1F);
+  state->pos = SHAKE128_RATE;
+}
+
+/*************************************************
+ * Name:        shake128x2_squeezeblocks_interleaved
+ *
+ * Description: shake128x2_squeezeblocks to one lane-interleaved buffer
+ *              of 2 * SHAKE128_RATE bytes per block
+ *
+ * Arguments:   - uint8_t *out: pointer to interleaved output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ *              - keccakx2_state *s: pointer to input/output Keccak state
+ **************************************************/
+void shake128x2_squeezeblocks_interleaved(uint8_t *out,
+                                          size_t nblocks,
+                                          keccakx2_state *state)
+{
+  keccakx2_squeezeblocks_interleaved(out, nblocks, SHAKE128_RATE, state->s);
+}
+
+/*************************************************
+ * Name:        shake256x2_absorb_interleaved
+ *
+ * Description: shake256x2_absorb on one lane-interleaved buffer, see
+ *              keccakx2_absorb_interleaved
+ *
+ * Arguments:   - keccakx2_state *state: pointer to (uninitialized) output
+ *                                     Keccak state
+ *              - const uint8_t *in: pointer to interleaved input
+ *              - size_t inlen: length of each input in bytes
+ **************************************************/
+void shake256x2_absorb_interleaved(keccakx2_state *state,
+                                   const uint8_t *in,
+                                   size_t inlen)
+{
+  keccakx2_absorb_interleaved(state->s, SHAKE256_RATE, in, inlen, 0x1F);
+  state->pos = SHAKE256_RATE;
+}
+
+/*************************************************
+ * Name:        shake256x2_squeezeblocks_interleaved
+ *
+ * Description: shake256x2_squeezeblocks to one lane-interleaved buffer
+ *              of 2 * SHAKE256_RATE bytes per block
+ *
+ * Arguments:   - uint8_t *out: pointer to interleaved output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ *              - keccakx2_state *s: pointer to input/output Keccak state
+ **************************************************/
+void shake256x2_squeezeblocks_interleaved(uint8_t *out,
+                                          size_t nblocks,
+                                          keccakx2_state *state)
+{
+  keccakx2_squeezeblocks_interleaved(out, nblocks, SHAKE256_RATE, state->s);
+}
+
+/*************************************************
+ * Name:        shake128x2_inc_init
+ *
+ * Description: Initializes the incremental SHAKE128 state.
+ *
+ * Arguments:   - keccakx2_state *state: pointer to output Keccak state
+ **************************************************/
+void shake128x2_inc_init(keccakx2_state *state)
+{
+  keccakx2_inc_init(state->s);
+  state->pos = 0;
+}
+
+/*************************************************
+ * Name:        shake128x2_inc_absorb
+ *
+ * Description: Incremental absorb step of the SHAKE128 XOF; absorbs
+ *              inlen bytes of both inputs, can be called multiple times
+ *              with chunks of any length.
+ *
+ * Arguments:   - keccakx2_state *state: pointer to input/output Keccak state
+ *              - const uint8_t *in0, *in1: pointer to input to be absorbed into s
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void shake128x2_inc_absorb(keccakx2_state *state,
+                           const uint8_t *in0,
+                           const uint8_t *in1,
+                           size_t inlen)
+{
+  state->pos = keccakx2_inc_absorb(state->s, state->pos, SHAKE128_RATE,
+                                   in0, in1, inlen);
+}
+
+/*************************************************
+ * Name:        shake128x2_inc_finalize
+ *
+ * Description: Finalize absorb step of the SHAKE128 XOF; afterwards the
+ *              state is squeezed with shake128x2_squeezeblocks or
+ *              shake128x2_squeeze.
+ *
+ * Arguments:   - keccakx2_state *state: pointer to input/output Keccak state
+ **************************************************/
+void shake128x2_inc_finalize(keccakx2_state *state)
+{
+  keccakx2_inc_finalize(state->s, state->pos, SHAKE128_RATE, 0x1F);
+  state->pos = SHAKE128_RATE;
+}
+
+/*************************************************
+ * Name:        shake256x2_inc_init
+ *
+ * Description: Initializes the incremental SHAKE256 state.
+ *
+ * Arguments:   - keccakx2_state *state: pointer to output Keccak state
+ **************************************************/
+void shake256x2_inc_init(keccakx2_state *state)
+{
+  keccakx2_inc_init(state->s);
+  state->pos = 0;
+}
+
+/*************************************************
+ * Name:        shake256x2_inc_absorb
+ *
+ * Description: Incremental absorb step of the SHAKE256 XOF; absorbs
+ *              inlen bytes of both inputs, can be called multiple times
+ *              with chunks of any length.
+ *
+ * Arguments:   - keccakx2_state *state: pointer to input/output Keccak state
+ *              - const uint8_t *in0, *in1: pointer to input to be absorbed into s
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void shake256x2_inc_absorb(keccakx2_state *state,
+                           const uint8_t *in0,
+                           const uint8_t *in1,
+                           size_t inlen)
+{
+  state->pos = keccakx2_inc_absorb(state->s, state->pos, SHAKE256_RATE,
+                                   in0, in1, inlen);
+}
+
+/*************************************************
+ * Name:        shake256x2_inc_finalize
+ *
+ * Description: Finalize absorb step of the SHAKE256 XOF; afterwards the
+ *              state is squeezed with shake256x2_squeezeblocks or
+ *              shake256x2_squeeze.
+ *
+ * Arguments:   - keccakx2_state *state: pointer to input/output Keccak state
+ **************************************************/
+void shake256x2_inc_finalize(keccakx2_state *state)
+{
+  keccakx2_inc_finalize(state->s, state->pos, SHAKE256_RATE, 0x1F);
+  state->pos = SHAKE256_RATE;
+}
+
+/*************************************************
+ * Name:        sha3_256x2_inc_init
+ *
+ * Description: Initializes the incremental SHA3-256 state.
+ *
+ * Arguments:   - keccakx2_state *state: pointer to output Keccak state
+ **************************************************/
+void sha3_256x2_inc_init(keccakx2_state *state)
+{
+  keccakx2_inc_init(state->s);
+  state->pos = 0;
+}
+
+/*************************************************
+ * Name:        sha3_256x2_inc_absorb
+ *
+ * Description: Incremental absorb step of SHA3-256; absorbs inlen bytes
+ *              of both inputs, can be called multiple times with chunks
+ *              of any length.
+ *
+ * Arguments:   - keccakx2_state *state: pointer to input/output Keccak state
+ *              - const uint8_t *in0, *in1: pointer to input to be absorbed into s
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void sha3_256x2_inc_absorb(keccakx2_state *state,
+                           const uint8_t *in0,
+                           const uint8_t *in1,
+                           size_t inlen)
+{
+  state->pos = keccakx2_inc_absorb(state->s, state->pos, SHA3_256_RATE,
+                                   in0, in1, inlen);
+}
+
+/*************************************************
+ * Name:        sha3_256x2_inc_finalize
+ *
+ * Description: Finalize step of SHA3-256, writes both digests.
+ *
+ * Arguments:   - uint8_t *h1, *h2: pointer to output (32 bytes)
+ *              - keccakx2_state *state: pointer to input/output Keccak state
+ **************************************************/
+void sha3_256x2_inc_finalize(uint8_t h1[32],
+                             uint8_t h2[32],
+                             keccakx2_state *state)
+{
+  keccakx2_inc_finalize(state->s, state->pos, SHA3_256_RATE, 0x06);
+  keccakx2_squeezedigest(h1, h2, 4, state->s);
+  state->pos = SHA3_256_RATE;
+}
+
+/*************************************************
+ * Name:        sha3_512x2_inc_init
+ *
+ * Description: Initializes the incremental SHA3-512 state.
+ *
+ * Arguments:   - keccakx2_state *state: pointer to output Keccak state
+ **************************************************/
+void sha3_512x2_inc_init(keccakx2_state *state)
+{
+  keccakx2_inc_init(state->s);
+  state->pos = 0;
+}
+
+/*************************************************
+ * Name:        sha3_512x2_inc_absorb
+ *
+ * Description: Incremental absorb step of SHA3-512; absorbs inlen bytes
+ *              of both inputs, can be called multiple times with chunks
+ *              of any length.
+ *
+ * Arguments:   - keccakx2_state *state: pointer to input/output Keccak state
+ *              - const uint8_t *in0, *in1: pointer to input to be absorbed into s
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void sha3_512x2_inc_absorb(keccakx2_state *state,
+                           const uint8_t *in0,
+                           const uint8_t *in1,
+                           size_t inlen)
+{
+  state->pos = keccakx2_inc_absorb(state->s, state->pos, SHA3_512_RATE,
+                                   in0, in1, inlen);
+}
+
+/*************************************************
+ * Name:        sha3_512x2_inc_finalize
+ *
+ * Description: Finalize step of SHA3-512, writes both digests.
+ *
+ * Arguments:   - uint8_t *h1, *h2: pointer to output (64 bytes)
+ *              - keccakx2_state *state: pointer to input/output Keccak state
+ **************************************************/
+void sha3_512x2_inc_finalize(uint8_t h1[64],
+                             uint8_t h2[64],
+                             keccakx2_state *state)
+{
+  keccakx2_inc_finalize(state->s, state->pos, SHA3_512_RATE, 0x06);
+  keccakx2_squeezedigest(h1, h2, 8, state->s);
+  state->pos = SHA3_512_RATE;
+}
+
 /*************************************************
  * Name:        shake128x2
  *
@@ -658,27 +1019,10 @@ void shake128x2(uint8_t *out0,
                 const uint8_t *in1,
                 size_t inlen)
 {
-  unsigned int i;
-  size_t nblocks = outlen / SHAKE128_RATE;
-  uint8_t t[2][SHAKE128_RATE];
   keccakx2_state state;
 
   shake128x2_absorb(&state, in0, in1, inlen);
-  shake128x2_squeezeblocks(out0, out1, nblocks, &state);
-
-  out0 += nblocks * SHAKE128_RATE;
-  out1 += nblocks * SHAKE128_RATE;
-  outlen -= nblocks * SHAKE128_RATE;
-
-  if (outlen)
-  {
-    shake128x2_squeezeblocks(t[0], t[1], 1, &state);
-    for (i = 0; i < outlen; ++i)
-    {
-      out0[i] = t[0][i];
-      out1[i] = t[1][i];
-    }
-  }
+  shake128x2_squeeze(out0, out1, outlen, &state);
 }
 
 /*************************************************
@@ -698,27 +1042,10 @@ void shake256x2(uint8_t *out0,
                 const uint8_t *in1,
                 size_t inlen)
 {
-  unsigned int i;
-  size_t nblocks = outlen / SHAKE256_RATE;
-  uint8_t t[2][SHAKE256_RATE];
   keccakx2_state state;
 
   shake256x2_absorb(&state, in0, in1, inlen);
-  shake256x2_squeezeblocks(out0, out1, nblocks, &state);
-
-  out0 += nblocks * SHAKE256_RATE;
-  out1 += nblocks * SHAKE256_RATE;
-  outlen -= nblocks * SHAKE256_RATE;
-
-  if (outlen)
-  {
-    shake256x2_squeezeblocks(t[0], t[1], 1, &state);
-    for (i = 0; i < outlen; ++i)
-    {
-      out0[i] = t[0][i];
-      out1[i] = t[1][i];
-    }
-  }
+  shake256x2_squeeze(out0, out1, outlen, &state);
 }
 
 /*************************************************
@@ -737,17 +1064,9 @@ void sha3_256x2(uint8_t h1[32],
                 size_t inlen)
 {
   v128 s[25];
-  uint8_t t1[SHA3_256_RATE];
-  uint8_t t2[SHA3_256_RATE];
 
   keccakx2_absorb(s, SHA3_256_RATE, in1, in2, inlen, 0x06);
-  keccakx2_squeezeblocks(t1, t2, 1, SHA3_256_RATE, s);
-
-  uint8x16x2_t a, b;
-  a = vld1q_u8_x2(t1);
-  b = vld1q_u8_x2(t2);
-  vst1q_u8_x2(h1, a);
-  vst1q_u8_x2(h2, b);
+  keccakx2_squeezedigest(h1, h2, 4, s);
 }
 
 /*************************************************
@@ -766,15 +1085,294 @@ void sha3_512x2(uint8_t h1[64],
                 size_t inlen)
 {
   v128 s[25];
-  uint8_t t1[SHA3_512_RATE];
-  uint8_t t2[SHA3_512_RATE];
 
   keccakx2_absorb(s, SHA3_512_RATE, in1, in2, inlen, 0x06);
-  keccakx2_squeezeblocks(t1, t2, 1, SHA3_512_RATE, s);
+  keccakx2_squeezedigest(h1, h2, 8, s);
+}
+
+/*************************************************
+ * Name:        keccakx2
+ *
+ * Description: Keccak sponge with any rate and domain byte, with
+ *              non-incremental API; p = 0x06 gives SHA3, 0x1F SHAKE and
+ *              0x01 the original Keccak[c = 1600 - 8 * r] padding
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in0, *in1: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - unsigned int r: rate in bytes, a multiple of 8 below 200
+ *              - uint8_t p: domain-separation byte
+ **************************************************/
+void keccakx2(uint8_t *out0,
+              uint8_t *out1,
+              size_t outlen,
+              const uint8_t *in0,
+              const uint8_t *in1,
+              size_t inlen,
+              unsigned int r,
+              uint8_t p)
+{
+  v128 s[25];
+
+  keccakx2_absorb(s, r, in0, in1, inlen, p);
+  keccakx2_squeeze(out0, out1, outlen, r, s);
+}
+
+/*************************************************
+ * Name:        sha3_224x2
+ *
+ * Description: SHA3-224 with non-incremental API
+ *
+ * Arguments:   - uint8_t *h1, *h2: pointer to output (28 bytes)
+ *              - const uint8_t *in1, *in2: pointer to input
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void sha3_224x2(uint8_t h1[28],
+                uint8_t h2[28],
+                const uint8_t *in1,
+                const uint8_t *in2,
+                size_t inlen)
+{
+  keccakx2(h1, h2, 28, in1, in2, inlen, SHA3_224_RATE, 0x06);
+}
+
+/*************************************************
+ * Name:        sha3_384x2
+ *
+ * Description: SHA3-384 with non-incremental API
+ *
+ * Arguments:   - uint8_t *h1, *h2: pointer to output (48 bytes)
+ *              - const uint8_t *in1, *in2: pointer to input
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void sha3_384x2(uint8_t h1[48],
+                uint8_t h2[48],
+                const uint8_t *in1,
+                const uint8_t *in2,
+                size_t inlen)
+{
+  keccakx2(h1, h2, 48, in1, in2, inlen, SHA3_384_RATE, 0x06);
+}
+
+/*************************************************
+ * Name:        keccakx2_absorb_short
+ *
+ * Description: Absorb step of Keccak for a constant input length below
+ *              the rate and a multiple of 8; non-incremental, writes
+ *              every lane of the state once. Inlined into the
+ *              fixed-length functions, where the loops unroll and the
+ *              padding lanes are constants.
+ *
+ * Arguments:   - v128 *s: pointer to (uninitialized) output Keccak state
+ *              - unsigned int r: rate in bytes
+ *              - const uint8_t *in0, *in1: pointer to input
+ *              - unsigned int inlen: length of input in bytes
+ *              - uint8_t p: domain-separation byte
+ **************************************************/
+static inline void keccakx2_absorb_short(v128 s[25],
+                                         unsigned int r,
+                                         const uint8_t *in0,
+                                         const uint8_t *in1,
+                                         unsigned int inlen,
+                                         uint8_t p)
+{
+  unsigned int i;
+  v128 a, b;
+
+  for (i = 0; i + 2 <= inlen / 8; i += 2)
+  {
+    a = v128_load(&in0[8 * i]);
+    b = v128_load(&in1[8 * i]);
+    s[i + 0] = v128_zip0(a, b);
+    s[i + 1] = v128_zip1(a, b);
+  }
+  if (i < inlen / 8)
+  {
+    s[i] = v128_load2(&in0[8 * i], &in1[8 * i]);
+    ++i;
+  }
+
+  s[i++] = v128_dup(p);
+  for (; i < 25; ++i)
+    s[i] = v128_zero();
+
+  s[r / 8 - 1] = v128_xor(s[r / 8 - 1], v128_dup(1ULL << 63));
+}
+
+/*
+ * Fixed-length SHA3 and SHAKE256 on two inputs of inlen bytes, e.g.
+ * sha3_256x2_32: no length loops or tail handling on the absorb side,
+ * and only the output lanes are stored
+ */
+#define SHA3X2_FIXED(bits, inlen)                                        \
+  void sha3_##bits##x2_##inlen(uint8_t h1[bits / 8],                     \
+                               uint8_t h2[bits / 8],                     \
+                               const uint8_t *in1,                       \
+                               const uint8_t *in2)                       \
+  {                                                                      \
+    v128 s[25];                                                          \
+                                                                         \
+    keccakx2_absorb_short(s, SHA3_##bits##_RATE, in1, in2, inlen, 0x06); \
+    keccakx2_squeezedigest(h1, h2, bits / 64, s);                        \
+  }
+
+#define SHAKE256X2_FIXED(inlen)                                          \
+  void shake256x2_##inlen(uint8_t *out0,                                 \
+                          uint8_t *out1,                                 \
+                          size_t outlen,                                 \
+                          const uint8_t *in0,                            \
+                          const uint8_t *in1)                            \
+  {                                                                      \
+    v128 s[25];                                                          \
+                                                                         \
+    keccakx2_absorb_short(s, SHAKE256_RATE, in0, in1, inlen, 0x1F);      \
+    keccakx2_squeeze(out0, out1, outlen, SHAKE256_RATE, s);              \
+  }
+
+SHA3X2_FIXED(256, 32)
+SHA3X2_FIXED(256, 64)
+SHA3X2_FIXED(512, 32)
+SHA3X2_FIXED(512, 64)
+SHAKE256X2_FIXED(32)
+SHAKE256X2_FIXED(64)
+
+/*************************************************
+ * Name:        shake128x2_absorb_var
+ *
+ * Description: Absorb step of the SHAKE128 XOF with a different input
+ *              length per lane.
+ *              non-incremental, starts by zeroeing the state.
+ *
+ * Arguments:   - keccakx2_state *state: pointer to (uninitialized) output
+ *                                     Keccak state
+ *              - const uint8_t *in0, *in1: pointer to input to be absorbed into s
+ *              - size_t inlen0, inlen1: length of each input in bytes
+ **************************************************/
+void shake128x2_absorb_var(keccakx2_state *state,
+                           const uint8_t *in0,
+                           const uint8_t *in1,
+                           size_t inlen0,
+                           size_t inlen1)
+{
+  keccakx2_absorb_var(state->s, SHAKE128_RATE, in0, in1, inlen0, inlen1, 0x1F);
+  state->pos = SHAKE128_RATE;
+}
+
+/*************************************************
+ * Name:        shake256x2_absorb_var
+ *
+ * Description: Absorb step of the SHAKE256 XOF with a different input
+ *              length per lane.
+ *              non-incremental, starts by zeroeing the state.
+ *
+ * Arguments:   - keccakx2_state *state: pointer to (uninitialized) output
+ *                                     Keccak state
+ *              - const uint8_t *in0, *in1: pointer to input to be absorbed into s
+ *              - size_t inlen0, inlen1: length of each input in bytes
+ **************************************************/
+void shake256x2_absorb_var(keccakx2_state *state,
+                           const uint8_t *in0,
+                           const uint8_t *in1,
+                           size_t inlen0,
+                           size_t inlen1)
+{
+  keccakx2_absorb_var(state->s, SHAKE256_RATE, in0, in1, inlen0, inlen1, 0x1F);
+  state->pos = SHAKE256_RATE;
+}
+
+/*************************************************
+ * Name:        shake128x2_var
+ *
+ * Description: SHAKE128 XOF with non-incremental API and a different
+ *              input length per lane
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in0, *in1: pointer to input
+ *              - size_t inlen0, inlen1: length of each input in bytes
+ **************************************************/
+void shake128x2_var(uint8_t *out0,
+                    uint8_t *out1,
+                    size_t outlen,
+                    const uint8_t *in0,
+                    const uint8_t *in1,
+                    size_t inlen0,
+                    size_t inlen1)
+{
+  keccakx2_state state;
+
+  shake128x2_absorb_var(&state, in0, in1, inlen0, inlen1);
+  shake128x2_squeeze(out0, out1, outlen, &state);
+}
+
+/*************************************************
+ * Name:        shake256x2_var
+ *
+ * Description: SHAKE256 XOF with non-incremental API and a different
+ *              input length per lane
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in0, *in1: pointer to input
+ *              - size_t inlen0, inlen1: length of each input in bytes
+ **************************************************/
+void shake256x2_var(uint8_t *out0,
+                    uint8_t *out1,
+                    size_t outlen,
+                    const uint8_t *in0,
+                    const uint8_t *in1,
+                    size_t inlen0,
+                    size_t inlen1)
+{
+  keccakx2_state state;
+
+  shake256x2_absorb_var(&state, in0, in1, inlen0, inlen1);
+  shake256x2_squeeze(out0, out1, outlen, &state);
+}
+
+/*************************************************
+ * Name:        sha3_256x2_var
+ *
+ * Description: SHA3-256 with non-incremental API and a different
+ *              input length per lane
+ *
+ * Arguments:   - uint8_t *h1, *h2: pointer to output (32 bytes)
+ *              - const uint8_t *in1, *in2: pointer to input
+ *              - size_t inlen1, inlen2: length of each input in bytes
+ **************************************************/
+void sha3_256x2_var(uint8_t h1[32],
+                    uint8_t h2[32],
+                    const uint8_t *in1,
+                    const uint8_t *in2,
+                    size_t inlen1,
+                    size_t inlen2)
+{
+  v128 s[25];
+
+  keccakx2_absorb_var(s, SHA3_256_RATE, in1, in2, inlen1, inlen2, 0x06);
+  keccakx2_squeezedigest(h1, h2, 4, s);
+}
+
+/*************************************************
+ * Name:        sha3_512x2_var
+ *
+ * Description: SHA3-512 with non-incremental API and a different
+ *              input length per lane
+ *
+ * Arguments:   - uint8_t *h1, *h2: pointer to output (64 bytes)
+ *              - const uint8_t *in1, *in2: pointer to input
+ *              - size_t inlen1, inlen2: length of each input in bytes
+ **************************************************/
+void sha3_512x2_var(uint8_t h1[64],
+                    uint8_t h2[64],
+                    const uint8_t *in1,
+                    const uint8_t *in2,
+                    size_t inlen1,
+                    size_t inlen2)
+{
+  v128 s[25];
 
-  uint8x16x4_t a, b;
-  a = vld1q_u8_x4(t1);
-  b = vld1q_u8_x4(t2);
-  vst1q_u8_x4(h1, a);
-  vst1q_u8_x4(h2, b);
+  keccakx2_absorb_var(s, SHA3_512_RATE, in1, in2, inlen1, inlen2, 0x06);
+  keccakx2_squeezedigest(h1, h2, 8, s);
 }
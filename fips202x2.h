@@ -17,22 +17,130 @@ limitations under the License.
 #define FIPS202X2_H
 
 #include <stddef.h>
-#include <arm_neon.h>
-
-typedef uint64x2_t v128;
+#include "v128.h"
 
 #define SHAKE128_RATE 168
 #define SHAKE256_RATE 136
+#define SHA3_224_RATE 144
 #define SHA3_256_RATE 136
+#define SHA3_384_RATE 104
 #define SHA3_512_RATE 72
 
 
 typedef struct {
   v128 s[25];
+  unsigned int pos;
 } keccakx2_state;
 
 void KeccakF1600_StatePermutex2(v128 state[25]);
 
+// Keccak-p[1600, 12], for TurboSHAKE and KangarooTwelve
+void KeccakP1600_12_StatePermutex2(v128 state[25]);
+
+// XOR and permute nblocks full blocks of r bytes of each input
+void KeccakF1600_StateAbsorbx2(v128 state[25],
+                               unsigned int r,
+                               const uint8_t *in0,
+                               const uint8_t *in1,
+                               size_t nblocks);
+
+// Permute and store nblocks full blocks of r bytes to each output
+void KeccakF1600_StateSqueezex2(v128 state[25],
+                                unsigned int r,
+                                uint8_t *out0,
+                                uint8_t *out1,
+                                size_t nblocks);
+
+// The same on one lane-interleaved buffer of 2 * r bytes per block:
+// word i of the first message, then word i of the second
+void KeccakF1600_StateAbsorbInterleavedx2(v128 state[25],
+                                          unsigned int r,
+                                          const uint8_t *in,
+                                          size_t nblocks);
+
+void KeccakF1600_StateSqueezeInterleavedx2(v128 state[25],
+                                           unsigned int r,
+                                           uint8_t *out,
+                                           size_t nblocks);
+
+/*
+ * The permutation kernel is selected when the library is loaded, from the
+ * CPU features or the SHA3X2_KERNEL environment variable:
+ * "sha3", "neon", "sha3_asm", "neon_asm" or "scalar" on AArch64, "avx2",
+ * "sse2" or "scalar" on x86-64, "scalar" elsewhere
+ */
+const char *keccakx2_get_kernel(void);
+
+int keccakx2_set_kernel(const char *name);
+
+/*
+ * Sponge building blocks with any rate r (a multiple of 8 below 200) and
+ * domain byte p, for the functions built on top of Keccak (e.g. cSHAKE,
+ * KMAC); keccakx2 is the one-shot sponge
+ */
+void keccakx2_absorb(v128 s[25],
+                     unsigned int r,
+                     const uint8_t *in0,
+                     const uint8_t *in1,
+                     size_t inlen,
+                     uint8_t p);
+
+/*
+ * Interleaved variants: one buffer holding both messages word by word,
+ * in[16 * i] is word i of the first and in[16 * i + 8] word i of the
+ * second, which is how the state keeps them; no zip on the way in or out
+ */
+void keccakx2_absorb_interleaved(v128 s[25],
+                                 unsigned int r,
+                                 const uint8_t *in,
+                                 size_t inlen,
+                                 uint8_t p);
+
+void keccakx2_squeezeblocks_interleaved(uint8_t *out,
+                                        size_t nblocks,
+                                        unsigned int r,
+                                        v128 s[25]);
+
+unsigned int keccakx2_inc_absorb(v128 s[25],
+                                 unsigned int pos,
+                                 unsigned int r,
+                                 const uint8_t *in0,
+                                 const uint8_t *in1,
+                                 size_t inlen);
+
+void keccakx2_inc_finalize(v128 s[25],
+                           unsigned int pos,
+                           unsigned int r,
+                           uint8_t p);
+
+void keccakx2_squeezeblocks(uint8_t *out0,
+                            uint8_t *out1,
+                            size_t nblocks,
+                            unsigned int r,
+                            v128 s[25]);
+
+unsigned int keccakx2_inc_squeeze(uint8_t *out0,
+                                  uint8_t *out1,
+                                  size_t outlen,
+                                  unsigned int pos,
+                                  unsigned int r,
+                                  v128 s[25]);
+
+void keccakx2_squeeze(uint8_t *out0,
+                      uint8_t *out1,
+                      size_t outlen,
+                      unsigned int r,
+                      v128 s[25]);
+
+void keccakx2(uint8_t *out0,
+              uint8_t *out1,
+              size_t outlen,
+              const uint8_t *in0,
+              const uint8_t *in1,
+              size_t inlen,
+              unsigned int r,
+              uint8_t p);
+
 void shake128x2_absorb(keccakx2_state *state,
                        const uint8_t *in0,
                        const uint8_t *in1,
@@ -43,6 +151,12 @@ void shake128x2_squeezeblocks(uint8_t *out0,
                               size_t nblocks,
                               keccakx2_state *state);
 
+// Any number of bytes per call, after shake128x2_absorb or shake128x2_inc_finalize
+void shake128x2_squeeze(uint8_t *out0,
+                        uint8_t *out1,
+                        size_t outlen,
+                        keccakx2_state *state);
+
 void shake256x2_absorb(keccakx2_state *state,
                        const uint8_t *in0,
                        const uint8_t *in1,
@@ -53,6 +167,68 @@ void shake256x2_squeezeblocks(uint8_t *out0,
                               size_t nblocks,
                               keccakx2_state *state);
 
+// Any number of bytes per call, after shake256x2_absorb or shake256x2_inc_finalize
+void shake256x2_squeeze(uint8_t *out0,
+                        uint8_t *out1,
+                        size_t outlen,
+                        keccakx2_state *state);
+
+void shake128x2_absorb_interleaved(keccakx2_state *state,
+                                   const uint8_t *in,
+                                   size_t inlen);
+
+void shake128x2_squeezeblocks_interleaved(uint8_t *out,
+                                          size_t nblocks,
+                                          keccakx2_state *state);
+
+void shake256x2_absorb_interleaved(keccakx2_state *state,
+                                   const uint8_t *in,
+                                   size_t inlen);
+
+void shake256x2_squeezeblocks_interleaved(uint8_t *out,
+                                          size_t nblocks,
+                                          keccakx2_state *state);
+
+void shake128x2_inc_init(keccakx2_state *state);
+
+void shake128x2_inc_absorb(keccakx2_state *state,
+                           const uint8_t *in0,
+                           const uint8_t *in1,
+                           size_t inlen);
+
+void shake128x2_inc_finalize(keccakx2_state *state);
+
+void shake256x2_inc_init(keccakx2_state *state);
+
+void shake256x2_inc_absorb(keccakx2_state *state,
+                           const uint8_t *in0,
+                           const uint8_t *in1,
+                           size_t inlen);
+
+void shake256x2_inc_finalize(keccakx2_state *state);
+
+void sha3_256x2_inc_init(keccakx2_state *state);
+
+void sha3_256x2_inc_absorb(keccakx2_state *state,
+                           const uint8_t *in0,
+                           const uint8_t *in1,
+                           size_t inlen);
+
+void sha3_256x2_inc_finalize(uint8_t h1[32],
+                             uint8_t h2[32],
+                             keccakx2_state *state);
+
+void sha3_512x2_inc_init(keccakx2_state *state);
+
+void sha3_512x2_inc_absorb(keccakx2_state *state,
+                           const uint8_t *in0,
+                           const uint8_t *in1,
+                           size_t inlen);
+
+void sha3_512x2_inc_finalize(uint8_t h1[64],
+                             uint8_t h2[64],
+                             keccakx2_state *state);
+
 void shake128x2(uint8_t *out0,
                 uint8_t *out1,
                 size_t outlen,
@@ -67,16 +243,105 @@ void shake256x2(uint8_t *out0,
                 const uint8_t *in1,
                 size_t inlen);
 
+void sha3_224x2(uint8_t h1[28],
+                uint8_t h2[28],
+                const uint8_t *in1,
+                const uint8_t *in2,
+                size_t inlen);
+
 void sha3_256x2(uint8_t h1[32],
                 uint8_t h2[32],
                 const uint8_t *in1,
                 const uint8_t *in2,
                 size_t inlen);
 
+void sha3_384x2(uint8_t h1[48],
+                uint8_t h2[48],
+                const uint8_t *in1,
+                const uint8_t *in2,
+                size_t inlen);
+
 void sha3_512x2(uint8_t h1[64],
                 uint8_t h2[64],
                 const uint8_t *in1,
                 const uint8_t *in2,
                 size_t inlen);
 
+/*
+ * Fixed input lengths of 32 and 64 bytes (seeds, hash-of-hash)
+ */
+void sha3_256x2_32(uint8_t h1[32],
+                   uint8_t h2[32],
+                   const uint8_t *in1,
+                   const uint8_t *in2);
+
+void sha3_256x2_64(uint8_t h1[32],
+                   uint8_t h2[32],
+                   const uint8_t *in1,
+                   const uint8_t *in2);
+
+void sha3_512x2_32(uint8_t h1[64],
+                   uint8_t h2[64],
+                   const uint8_t *in1,
+                   const uint8_t *in2);
+
+void sha3_512x2_64(uint8_t h1[64],
+                   uint8_t h2[64],
+                   const uint8_t *in1,
+                   const uint8_t *in2);
+
+void shake256x2_32(uint8_t *out0,
+                   uint8_t *out1,
+                   size_t outlen,
+                   const uint8_t *in0,
+                   const uint8_t *in1);
+
+void shake256x2_64(uint8_t *out0,
+                   uint8_t *out1,
+                   size_t outlen,
+                   const uint8_t *in0,
+                   const uint8_t *in1);
+
+void shake128x2_absorb_var(keccakx2_state *state,
+                           const uint8_t *in0,
+                           const uint8_t *in1,
+                           size_t inlen0,
+                           size_t inlen1);
+
+void shake256x2_absorb_var(keccakx2_state *state,
+                           const uint8_t *in0,
+                           const uint8_t *in1,
+                           size_t inlen0,
+                           size_t inlen1);
+
+void shake128x2_var(uint8_t *out0,
+                    uint8_t *out1,
+                    size_t outlen,
+                    const uint8_t *in0,
+                    const uint8_t *in1,
+                    size_t inlen0,
+                    size_t inlen1);
+
+void shake256x2_var(uint8_t *out0,
+                    uint8_t *out1,
+                    size_t outlen,
+                    const uint8_t *in0,
+                    const uint8_t *in1,
+                    size_t inlen0,
+                    size_t inlen1);
+
+void sha3_256x2_var(uint8_t h1[32],
+                    uint8_t h2[32],
+                    const uint8_t *in1,
+                    const uint8_t *in2,
+                    size_t inlen1,
+                    size_t inlen2);
+
+void sha3_512x2_var(uint8_t h1[64],
+                    uint8_t h2[64],
+                    const uint8_t *in1,
+                    const uint8_t *in2,
+                    size_t inlen1,
+                    size_t inlen2);
+
 #endif
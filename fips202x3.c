@@ -0,0 +1,375 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#include <stddef.h>
+#include "fips202x3.h"
+
+// Bitwise-XOR: c = a ^ b
+#define vxor(c, a, b) c = v128_xor(a, b);
+
+/*************************************************
+ * Name:        load64
+ *
+ * Description: Load 8 bytes into uint64_t in little-endian order
+ *
+ * Arguments:   - const uint8_t *x: pointer to input byte array
+ *
+ * Returns the loaded 64-bit unsigned integer
+ **************************************************/
+static uint64_t load64(const uint8_t x[8])
+{
+  unsigned int i;
+  uint64_t r = 0;
+
+  for (i = 0; i < 8; ++i)
+    r |= (uint64_t)x[i] << 8 * i;
+
+  return r;
+}
+
+/*************************************************
+ * Name:        store64
+ *
+ * Description: Store a 64-bit integer to array of 8 bytes in little-endian order
+ *
+ * Arguments:   - uint8_t *x: pointer to the output byte array (allocated)
+ *              - uint64_t u: input 64-bit unsigned integer
+ **************************************************/
+static void store64(uint8_t x[8], uint64_t u)
+{
+  unsigned int i;
+
+  for (i = 0; i < 8; ++i)
+    x[i] = u >> 8 * i;
+}
+
+/*************************************************
+ * Name:        keccakx3_absorb
+ *
+ * Description: Absorb step of Keccak;
+ *              non-incremental, starts by zeroeing the state.
+ *
+ * Arguments:   - v128 *s: pointer to (uninitialized) 2-way Keccak state
+ *              - uint64_t *t: pointer to (uninitialized) scalar Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - const uint8_t *in0, *in1, *in2: pointer to input to be absorbed
+ *              - size_t inlen: length of input in bytes
+ *              - uint8_t p: domain-separation byte for different
+ *                           Keccak-derived functions
+ **************************************************/
+static void keccakx3_absorb(v128 s[25],
+                            uint64_t t[25],
+                            unsigned int r,
+                            const uint8_t *in0,
+                            const uint8_t *in1,
+                            const uint8_t *in2,
+                            size_t inlen,
+                            uint8_t p)
+{
+  size_t i;
+  uint8_t b[3][200];
+  v128 tmp;
+
+  for (i = 0; i < 25; ++i)
+  {
+    s[i] = v128_zero();
+    t[i] = 0;
+  }
+
+  while (inlen >= r)
+  {
+    for (i = 0; i < r / 8; ++i)
+    {
+      tmp = v128_load2(&in0[8 * i], &in1[8 * i]);
+      vxor(s[i], s[i], tmp);
+      t[i] ^= load64(&in2[8 * i]);
+    }
+
+    KeccakF1600_StatePermutex3(s, t);
+    in0 += r;
+    in1 += r;
+    in2 += r;
+    inlen -= r;
+  }
+
+  // Last block, padded
+  for (i = 0; i < r; ++i)
+    b[0][i] = b[1][i] = b[2][i] = 0;
+  for (i = 0; i < inlen; ++i)
+  {
+    b[0][i] = in0[i];
+    b[1][i] = in1[i];
+    b[2][i] = in2[i];
+  }
+  b[0][inlen] = b[1][inlen] = b[2][inlen] = p;
+  b[0][r - 1] |= 128;
+  b[1][r - 1] |= 128;
+  b[2][r - 1] |= 128;
+
+  for (i = 0; i < r / 8; ++i)
+  {
+    tmp = v128_load2(&b[0][8 * i], &b[1][8 * i]);
+    vxor(s[i], s[i], tmp);
+    t[i] ^= load64(&b[2][8 * i]);
+  }
+}
+
+/*************************************************
+ * Name:        keccakx3_squeezeblocks
+ *
+ * Description: Squeeze step of Keccak. Squeezes full blocks of r bytes each.
+ *              Modifies the state. Can be called multiple times to keep
+ *              squeezing, i.e., is incremental.
+ *
+ * Arguments:   - uint8_t *out0, *out1, *out2: pointer to output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - v128 *s: pointer to input/output 2-way Keccak state
+ *              - uint64_t *t: pointer to input/output scalar Keccak state
+ **************************************************/
+static void keccakx3_squeezeblocks(uint8_t *out0,
+                                   uint8_t *out1,
+                                   uint8_t *out2,
+                                   size_t nblocks,
+                                   unsigned int r,
+                                   v128 s[25],
+                                   uint64_t t[25])
+{
+  unsigned int i;
+
+  while (nblocks > 0)
+  {
+    KeccakF1600_StatePermutex3(s, t);
+
+    for (i = 0; i < r / 8; ++i)
+    {
+      v128_store2(out0, out1, s[i]);
+      store64(out2, t[i]);
+
+      out0 += 8;
+      out1 += 8;
+      out2 += 8;
+    }
+
+    --nblocks;
+  }
+}
+
+/*************************************************
+ * Name:        shake128x3_absorb
+ *
+ * Description: Absorb step of the SHAKE128 XOF.
+ *              non-incremental, starts by zeroeing the state.
+ *
+ * Arguments:   - keccakx3_state *state: pointer to (uninitialized) output
+ *                                     Keccak state
+ *              - const uint8_t *in0, *in1, *in2: pointer to input to be absorbed
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void shake128x3_absorb(keccakx3_state *state,
+                       const uint8_t *in0,
+                       const uint8_t *in1,
+                       const uint8_t *in2,
+                       size_t inlen)
+{
+  keccakx3_absorb(state->s, state->t, SHAKE128_RATE,
+                  in0, in1, in2, inlen, 0x1F);
+}
+
+/*************************************************
+ * Name:        shake128x3_squeezeblocks
+ *
+ * Description: Squeeze step of SHAKE128 XOF. Squeezes full blocks of
+ *              SHAKE128_RATE bytes each. Modifies the state. Can be called
+ *              multiple times to keep squeezing, i.e., is incremental.
+ *
+ * Arguments:   - uint8_t *out0, *out1, *out2: pointer to output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ *                                (written to output)
+ *              - keccakx3_state *s: pointer to input/output Keccak state
+ **************************************************/
+void shake128x3_squeezeblocks(uint8_t *out0,
+                              uint8_t *out1,
+                              uint8_t *out2,
+                              size_t nblocks,
+                              keccakx3_state *state)
+{
+  keccakx3_squeezeblocks(out0, out1, out2, nblocks, SHAKE128_RATE,
+                         state->s, state->t);
+}
+
+/*************************************************
+ * Name:        shake256x3_absorb
+ *
+ * Description: Absorb step of the SHAKE256 XOF.
+ *              non-incremental, starts by zeroeing the state.
+ *
+ * Arguments:   - keccakx3_state *state: pointer to (uninitialized) output
+ *                                     Keccak state
+ *              - const uint8_t *in0, *in1, *in2: pointer to input to be absorbed
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void shake256x3_absorb(keccakx3_state *state,
+                       const uint8_t *in0,
+                       const uint8_t *in1,
+                       const uint8_t *in2,
+                       size_t inlen)
+{
+  keccakx3_absorb(state->s, state->t, SHAKE256_RATE,
+                  in0, in1, in2, inlen, 0x1F);
+}
+
+/*************************************************
+ * Name:        shake256x3_squeezeblocks
+ *
+ * Description: Squeeze step of SHAKE256 XOF. Squeezes full blocks of
+ *              SHAKE256_RATE bytes each. Modifies the state. Can be called
+ *              multiple times to keep squeezing, i.e., is incremental.
+ *
+ * Arguments:   - uint8_t *out0, *out1, *out2: pointer to output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ *                                (written to output)
+ *              - keccakx3_state *s: pointer to input/output Keccak state
+ **************************************************/
+void shake256x3_squeezeblocks(uint8_t *out0,
+                              uint8_t *out1,
+                              uint8_t *out2,
+                              size_t nblocks,
+                              keccakx3_state *state)
+{
+  keccakx3_squeezeblocks(out0, out1, out2, nblocks, SHAKE256_RATE,
+                         state->s, state->t);
+}
+
+/*************************************************
+ * Name:        shake128x3
+ *
+ * Description: SHAKE128 XOF with non-incremental API
+ *
+ * Arguments:   - uint8_t *out0, *out1, *out2: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in0, *in1, *in2: pointer to input
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void shake128x3(uint8_t *out0,
+                uint8_t *out1,
+                uint8_t *out2,
+                size_t outlen,
+                const uint8_t *in0,
+                const uint8_t *in1,
+                const uint8_t *in2,
+                size_t inlen)
+{
+  unsigned int i;
+  size_t nblocks = outlen / SHAKE128_RATE;
+  uint8_t t[3][SHAKE128_RATE];
+  keccakx3_state state;
+
+  shake128x3_absorb(&state, in0, in1, in2, inlen);
+  shake128x3_squeezeblocks(out0, out1, out2, nblocks, &state);
+
+  out0 += nblocks * SHAKE128_RATE;
+  out1 += nblocks * SHAKE128_RATE;
+  out2 += nblocks * SHAKE128_RATE;
+  outlen -= nblocks * SHAKE128_RATE;
+
+  if (outlen)
+  {
+    shake128x3_squeezeblocks(t[0], t[1], t[2], 1, &state);
+    for (i = 0; i < outlen; ++i)
+    {
+      out0[i] = t[0][i];
+      out1[i] = t[1][i];
+      out2[i] = t[2][i];
+    }
+  }
+}
+
+/*************************************************
+ * Name:        shake256x3
+ *
+ * Description: SHAKE256 XOF with non-incremental API
+ *
+ * Arguments:   - uint8_t *out0, *out1, *out2: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in0, *in1, *in2: pointer to input
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void shake256x3(uint8_t *out0,
+                uint8_t *out1,
+                uint8_t *out2,
+                size_t outlen,
+                const uint8_t *in0,
+                const uint8_t *in1,
+                const uint8_t *in2,
+                size_t inlen)
+{
+  unsigned int i;
+  size_t nblocks = outlen / SHAKE256_RATE;
+  uint8_t t[3][SHAKE256_RATE];
+  keccakx3_state state;
+
+  shake256x3_absorb(&state, in0, in1, in2, inlen);
+  shake256x3_squeezeblocks(out0, out1, out2, nblocks, &state);
+
+  out0 += nblocks * SHAKE256_RATE;
+  out1 += nblocks * SHAKE256_RATE;
+  out2 += nblocks * SHAKE256_RATE;
+  outlen -= nblocks * SHAKE256_RATE;
+
+  if (outlen)
+  {
+    shake256x3_squeezeblocks(t[0], t[1], t[2], 1, &state);
+    for (i = 0; i < outlen; ++i)
+    {
+      out0[i] = t[0][i];
+      out1[i] = t[1][i];
+      out2[i] = t[2][i];
+    }
+  }
+}
+
+/*************************************************
+ * Name:        sha3_256x3
+ *
+ * Description: SHA3-256 with non-incremental API
+ *
+ * Arguments:   - uint8_t *h0, *h1, *h2: pointer to output (32 bytes)
+ *              - const uint8_t *in0, *in1, *in2: pointer to input
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void sha3_256x3(uint8_t h0[32],
+                uint8_t h1[32],
+                uint8_t h2[32],
+                const uint8_t *in0,
+                const uint8_t *in1,
+                const uint8_t *in2,
+                size_t inlen)
+{
+  unsigned int i;
+  v128 s[25];
+  uint64_t t[25];
+  uint8_t t0[SHA3_256_RATE], t1[SHA3_256_RATE], t2[SHA3_256_RATE];
+
+  keccakx3_absorb(s, t, SHA3_256_RATE, in0, in1, in2, inlen, 0x06);
+  keccakx3_squeezeblocks(t0, t1, t2, 1, SHA3_256_RATE, s, t);
+
+  for (i = 0; i < 32; ++i)
+  {
+    h0[i] = t0[i];
+    h1[i] = t1[i];
+    h2[i] = t2[i];
+  }
+}
@@ -0,0 +1,84 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#ifndef FIPS202X3_H
+#define FIPS202X3_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "fips202x2.h"
+
+/*
+ * Three messages at once: lanes 0 and 1 in NEON, lane 2 in
+ * general-purpose registers, see KeccakF1600_StatePermutex3
+ */
+typedef struct {
+  v128 s[25];
+  uint64_t t[25];
+} keccakx3_state;
+
+void KeccakF1600_StatePermutex3(v128 state[25], uint64_t state2[25]);
+
+void shake128x3_absorb(keccakx3_state *state,
+                       const uint8_t *in0,
+                       const uint8_t *in1,
+                       const uint8_t *in2,
+                       size_t inlen);
+
+void shake128x3_squeezeblocks(uint8_t *out0,
+                              uint8_t *out1,
+                              uint8_t *out2,
+                              size_t nblocks,
+                              keccakx3_state *state);
+
+void shake256x3_absorb(keccakx3_state *state,
+                       const uint8_t *in0,
+                       const uint8_t *in1,
+                       const uint8_t *in2,
+                       size_t inlen);
+
+void shake256x3_squeezeblocks(uint8_t *out0,
+                              uint8_t *out1,
+                              uint8_t *out2,
+                              size_t nblocks,
+                              keccakx3_state *state);
+
+void shake128x3(uint8_t *out0,
+                uint8_t *out1,
+                uint8_t *out2,
+                size_t outlen,
+                const uint8_t *in0,
+                const uint8_t *in1,
+                const uint8_t *in2,
+                size_t inlen);
+
+void shake256x3(uint8_t *out0,
+                uint8_t *out1,
+                uint8_t *out2,
+                size_t outlen,
+                const uint8_t *in0,
+                const uint8_t *in1,
+                const uint8_t *in2,
+                size_t inlen);
+
+void sha3_256x3(uint8_t h0[32],
+                uint8_t h1[32],
+                uint8_t h2[32],
+                const uint8_t *in0,
+                const uint8_t *in1,
+                const uint8_t *in2,
+                size_t inlen);
+
+#endif
@@ -0,0 +1,421 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#include <stddef.h>
+#include "fips202x4.h"
+
+// Bitwise-XOR: c = a ^ b
+#define vxor(c, a, b) c = v128_xor(a, b);
+
+/*************************************************
+ * Name:        keccakx4_xorlanes
+ *
+ * Description: XOR nlanes 8-byte lanes of two inputs into a 2-way state
+ *
+ * Arguments:   - v128 *s: pointer to input/output 2-way Keccak state
+ *              - const uint8_t *in0, *in1: pointer to input
+ *              - unsigned int nlanes: number of lanes
+ **************************************************/
+static void keccakx4_xorlanes(v128 s[25],
+                              const uint8_t *in0,
+                              const uint8_t *in1,
+                              unsigned int nlanes)
+{
+  unsigned int i;
+  v128 tmp, a1, b1;
+
+  for (i = 0; i + 2 <= nlanes; i += 2)
+  {
+    a1 = v128_load(&in0[8 * i]);
+    b1 = v128_load(&in1[8 * i]);
+    vxor(s[i + 0], s[i + 0], v128_zip0(a1, b1));
+    vxor(s[i + 1], s[i + 1], v128_zip1(a1, b1));
+  }
+
+  if (i < nlanes)
+  {
+    tmp = v128_load2(&in0[8 * i], &in1[8 * i]);
+    vxor(s[i], s[i], tmp);
+  }
+}
+
+/*************************************************
+ * Name:        keccakx4_storelanes
+ *
+ * Description: Store nlanes 8-byte lanes of a 2-way state to two outputs
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointer to output
+ *              - const v128 *s: pointer to 2-way Keccak state
+ *              - unsigned int nlanes: number of lanes
+ **************************************************/
+static void keccakx4_storelanes(uint8_t *out0,
+                                uint8_t *out1,
+                                const v128 s[25],
+                                unsigned int nlanes)
+{
+  unsigned int i;
+
+  for (i = 0; i + 2 <= nlanes; i += 2)
+  {
+    v128_store(&out0[8 * i], v128_zip0(s[i], s[i + 1]));
+    v128_store(&out1[8 * i], v128_zip1(s[i], s[i + 1]));
+  }
+
+  if (i < nlanes)
+    v128_store2(&out0[8 * i], &out1[8 * i], s[i]);
+}
+
+/*************************************************
+ * Name:        keccakx4_absorb
+ *
+ * Description: Absorb step of Keccak;
+ *              non-incremental, starts by zeroeing the state.
+ *
+ * Arguments:   - v128 *s0, *s1: pointer to (uninitialized) 2-way Keccak states
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - const uint8_t *in0, *in1, *in2, *in3: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - uint8_t p: domain-separation byte for different
+ *                           Keccak-derived functions
+ **************************************************/
+static void keccakx4_absorb(v128 s0[25],
+                            v128 s1[25],
+                            unsigned int r,
+                            const uint8_t *in0,
+                            const uint8_t *in1,
+                            const uint8_t *in2,
+                            const uint8_t *in3,
+                            size_t inlen,
+                            uint8_t p)
+{
+  size_t i;
+  uint8_t b[4][200];
+
+  for (i = 0; i < 25; ++i)
+  {
+    s0[i] = v128_zero();
+    s1[i] = v128_zero();
+  }
+
+  while (inlen >= r)
+  {
+    keccakx4_xorlanes(s0, in0, in1, r / 8);
+    keccakx4_xorlanes(s1, in2, in3, r / 8);
+
+    KeccakF1600_StatePermutex4(s0, s1);
+    in0 += r;
+    in1 += r;
+    in2 += r;
+    in3 += r;
+    inlen -= r;
+  }
+
+  // Last block, padded
+  for (i = 0; i < r; ++i)
+    b[0][i] = b[1][i] = b[2][i] = b[3][i] = 0;
+  for (i = 0; i < inlen; ++i)
+  {
+    b[0][i] = in0[i];
+    b[1][i] = in1[i];
+    b[2][i] = in2[i];
+    b[3][i] = in3[i];
+  }
+  b[0][inlen] = b[1][inlen] = b[2][inlen] = b[3][inlen] = p;
+  b[0][r - 1] |= 128;
+  b[1][r - 1] |= 128;
+  b[2][r - 1] |= 128;
+  b[3][r - 1] |= 128;
+
+  keccakx4_xorlanes(s0, b[0], b[1], r / 8);
+  keccakx4_xorlanes(s1, b[2], b[3], r / 8);
+}
+
+/*************************************************
+ * Name:        keccakx4_squeezeblocks
+ *
+ * Description: Squeeze step of Keccak. Squeezes full blocks of r bytes each.
+ *              Modifies the state. Can be called multiple times to keep
+ *              squeezing, i.e., is incremental.
+ *
+ * Arguments:   - uint8_t *out0, *out1, *out2, *out3: pointer to output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - v128 *s0, *s1: pointer to input/output 2-way Keccak states
+ **************************************************/
+static void keccakx4_squeezeblocks(uint8_t *out0,
+                                   uint8_t *out1,
+                                   uint8_t *out2,
+                                   uint8_t *out3,
+                                   size_t nblocks,
+                                   unsigned int r,
+                                   v128 s0[25],
+                                   v128 s1[25])
+{
+  while (nblocks > 0)
+  {
+    KeccakF1600_StatePermutex4(s0, s1);
+
+    keccakx4_storelanes(out0, out1, s0, r / 8);
+    keccakx4_storelanes(out2, out3, s1, r / 8);
+
+    out0 += r;
+    out1 += r;
+    out2 += r;
+    out3 += r;
+    --nblocks;
+  }
+}
+
+/*************************************************
+ * Name:        shake128x4_absorb
+ *
+ * Description: Absorb step of the SHAKE128 XOF.
+ *              non-incremental, starts by zeroeing the state.
+ *
+ * Arguments:   - keccakx4_state *state: pointer to (uninitialized) output
+ *                                     Keccak state
+ *              - const uint8_t *in0, *in1, *in2, *in3: pointer to input
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void shake128x4_absorb(keccakx4_state *state,
+                       const uint8_t *in0,
+                       const uint8_t *in1,
+                       const uint8_t *in2,
+                       const uint8_t *in3,
+                       size_t inlen)
+{
+  keccakx4_absorb(state->s[0], state->s[1], SHAKE128_RATE,
+                  in0, in1, in2, in3, inlen, 0x1F);
+}
+
+/*************************************************
+ * Name:        shake128x4_squeezeblocks
+ *
+ * Description: Squeeze step of SHAKE128 XOF. Squeezes full blocks of
+ *              SHAKE128_RATE bytes each. Modifies the state. Can be called
+ *              multiple times to keep squeezing, i.e., is incremental.
+ *
+ * Arguments:   - uint8_t *out0, *out1, *out2, *out3: pointer to output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ *                                (written to output)
+ *              - keccakx4_state *s: pointer to input/output Keccak state
+ **************************************************/
+void shake128x4_squeezeblocks(uint8_t *out0,
+                              uint8_t *out1,
+                              uint8_t *out2,
+                              uint8_t *out3,
+                              size_t nblocks,
+                              keccakx4_state *state)
+{
+  keccakx4_squeezeblocks(out0, out1, out2, out3, nblocks, SHAKE128_RATE,
+                         state->s[0], state->s[1]);
+}
+
+/*************************************************
+ * Name:        shake256x4_absorb
+ *
+ * Description: Absorb step of the SHAKE256 XOF.
+ *              non-incremental, starts by zeroeing the state.
+ *
+ * Arguments:   - keccakx4_state *state: pointer to (uninitialized) output
+ *                                     Keccak state
+ *              - const uint8_t *in0, *in1, *in2, *in3: pointer to input
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void shake256x4_absorb(keccakx4_state *state,
+                       const uint8_t *in0,
+                       const uint8_t *in1,
+                       const uint8_t *in2,
+                       const uint8_t *in3,
+                       size_t inlen)
+{
+  keccakx4_absorb(state->s[0], state->s[1], SHAKE256_RATE,
+                  in0, in1, in2, in3, inlen, 0x1F);
+}
+
+/*************************************************
+ * Name:        shake256x4_squeezeblocks
+ *
+ * Description: Squeeze step of SHAKE256 XOF. Squeezes full blocks of
+ *              SHAKE256_RATE bytes each. Modifies the state. Can be called
+ *              multiple times to keep squeezing, i.e., is incremental.
+ *
+ * Arguments:   - uint8_t *out0, *out1, *out2, *out3: pointer to output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ *                                (written to output)
+ *              - keccakx4_state *s: pointer to input/output Keccak state
+ **************************************************/
+void shake256x4_squeezeblocks(uint8_t *out0,
+                              uint8_t *out1,
+                              uint8_t *out2,
+                              uint8_t *out3,
+                              size_t nblocks,
+                              keccakx4_state *state)
+{
+  keccakx4_squeezeblocks(out0, out1, out2, out3, nblocks, SHAKE256_RATE,
+                         state->s[0], state->s[1]);
+}
+
+/*************************************************
+ * Name:        shake128x4
+ *
+ * Description: SHAKE128 XOF with non-incremental API
+ *
+ * Arguments:   - uint8_t *out0, *out1, *out2, *out3: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in0, *in1, *in2, *in3: pointer to input
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void shake128x4(uint8_t *out0,
+                uint8_t *out1,
+                uint8_t *out2,
+                uint8_t *out3,
+                size_t outlen,
+                const uint8_t *in0,
+                const uint8_t *in1,
+                const uint8_t *in2,
+                const uint8_t *in3,
+                size_t inlen)
+{
+  unsigned int i;
+  size_t nblocks = outlen / SHAKE128_RATE;
+  uint8_t t[4][SHAKE128_RATE];
+  keccakx4_state state;
+
+  shake128x4_absorb(&state, in0, in1, in2, in3, inlen);
+  shake128x4_squeezeblocks(out0, out1, out2, out3, nblocks, &state);
+
+  out0 += nblocks * SHAKE128_RATE;
+  out1 += nblocks * SHAKE128_RATE;
+  out2 += nblocks * SHAKE128_RATE;
+  out3 += nblocks * SHAKE128_RATE;
+  outlen -= nblocks * SHAKE128_RATE;
+
+  if (outlen)
+  {
+    shake128x4_squeezeblocks(t[0], t[1], t[2], t[3], 1, &state);
+    for (i = 0; i < outlen; ++i)
+    {
+      out0[i] = t[0][i];
+      out1[i] = t[1][i];
+      out2[i] = t[2][i];
+      out3[i] = t[3][i];
+    }
+  }
+}
+
+/*************************************************
+ * Name:        shake256x4
+ *
+ * Description: SHAKE256 XOF with non-incremental API
+ *
+ * Arguments:   - uint8_t *out0, *out1, *out2, *out3: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in0, *in1, *in2, *in3: pointer to input
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void shake256x4(uint8_t *out0,
+                uint8_t *out1,
+                uint8_t *out2,
+                uint8_t *out3,
+                size_t outlen,
+                const uint8_t *in0,
+                const uint8_t *in1,
+                const uint8_t *in2,
+                const uint8_t *in3,
+                size_t inlen)
+{
+  unsigned int i;
+  size_t nblocks = outlen / SHAKE256_RATE;
+  uint8_t t[4][SHAKE256_RATE];
+  keccakx4_state state;
+
+  shake256x4_absorb(&state, in0, in1, in2, in3, inlen);
+  shake256x4_squeezeblocks(out0, out1, out2, out3, nblocks, &state);
+
+  out0 += nblocks * SHAKE256_RATE;
+  out1 += nblocks * SHAKE256_RATE;
+  out2 += nblocks * SHAKE256_RATE;
+  out3 += nblocks * SHAKE256_RATE;
+  outlen -= nblocks * SHAKE256_RATE;
+
+  if (outlen)
+  {
+    shake256x4_squeezeblocks(t[0], t[1], t[2], t[3], 1, &state);
+    for (i = 0; i < outlen; ++i)
+    {
+      out0[i] = t[0][i];
+      out1[i] = t[1][i];
+      out2[i] = t[2][i];
+      out3[i] = t[3][i];
+    }
+  }
+}
+
+/*************************************************
+ * Name:        sha3_256x4
+ *
+ * Description: SHA3-256 with non-incremental API
+ *
+ * Arguments:   - uint8_t *h0, *h1, *h2, *h3: pointer to output (32 bytes)
+ *              - const uint8_t *in0, *in1, *in2, *in3: pointer to input
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void sha3_256x4(uint8_t h0[32],
+                uint8_t h1[32],
+                uint8_t h2[32],
+                uint8_t h3[32],
+                const uint8_t *in0,
+                const uint8_t *in1,
+                const uint8_t *in2,
+                const uint8_t *in3,
+                size_t inlen)
+{
+  v128 s0[25], s1[25];
+
+  keccakx4_absorb(s0, s1, SHA3_256_RATE, in0, in1, in2, in3, inlen, 0x06);
+  KeccakF1600_StatePermutex4(s0, s1);
+
+  keccakx4_storelanes(h0, h1, s0, 4);
+  keccakx4_storelanes(h2, h3, s1, 4);
+}
+
+/*************************************************
+ * Name:        sha3_512x4
+ *
+ * Description: SHA3-512 with non-incremental API
+ *
+ * Arguments:   - uint8_t *h0, *h1, *h2, *h3: pointer to output (64 bytes)
+ *              - const uint8_t *in0, *in1, *in2, *in3: pointer to input
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void sha3_512x4(uint8_t h0[64],
+                uint8_t h1[64],
+                uint8_t h2[64],
+                uint8_t h3[64],
+                const uint8_t *in0,
+                const uint8_t *in1,
+                const uint8_t *in2,
+                const uint8_t *in3,
+                size_t inlen)
+{
+  v128 s0[25], s1[25];
+
+  keccakx4_absorb(s0, s1, SHA3_512_RATE, in0, in1, in2, in3, inlen, 0x06);
+  KeccakF1600_StatePermutex4(s0, s1);
+
+  keccakx4_storelanes(h0, h1, s0, 8);
+  keccakx4_storelanes(h2, h3, s1, 8);
+}
@@ -0,0 +1,327 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include "fips202xN.h"
+
+/*************************************************
+ * Name:        load64
+ *
+ * Description: Load 8 bytes into uint64_t in little-endian order
+ *
+ * Arguments:   - const uint8_t *x: pointer to input byte array
+ *
+ * Returns the loaded 64-bit unsigned integer
+ **************************************************/
+static uint64_t load64(const uint8_t x[8])
+{
+  unsigned int i;
+  uint64_t r = 0;
+
+  for (i = 0; i < 8; i++)
+    r |= (uint64_t)x[i] << 8 * i;
+
+  return r;
+}
+
+/*************************************************
+ * Name:        store64
+ *
+ * Description: Store a 64-bit integer to array of 8 bytes in little-endian order
+ *
+ * Arguments:   - uint8_t *x: pointer to the output byte array (allocated)
+ *              - uint64_t u: input 64-bit unsigned integer
+ **************************************************/
+static void store64(uint8_t x[8], uint64_t u)
+{
+  unsigned int i;
+
+  for (i = 0; i < 8; i++)
+    x[i] = u >> 8 * i;
+}
+
+/*************************************************
+ * Name:        keccakxN_absorb
+ *
+ * Description: Absorb step of Keccak;
+ *              non-incremental, starts by zeroeing the state.
+ *
+ * Arguments:   - keccakxN_state *state: pointer to (uninitialized)
+ *                                       N-way Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - const uint8_t *const in[]: keccakxN_lanes() inputs
+ *              - size_t inlen: length of input in bytes
+ *              - uint8_t p: domain-separation byte for different
+ *                           Keccak-derived functions
+ **************************************************/
+static void keccakxN_absorb(keccakxN_state *state,
+                            unsigned int r,
+                            const uint8_t *const in[],
+                            size_t inlen,
+                            uint8_t p)
+{
+  unsigned int i, l;
+  const unsigned int n = keccakxN_lanes();
+  uint64_t *s = state->s;
+  size_t off = 0;
+  uint8_t b[200];
+
+  state->n = n;
+  for (i = 0; i < 25 * n; ++i)
+    s[i] = 0;
+
+  while (inlen >= r)
+  {
+    for (l = 0; l < n; ++l)
+      for (i = 0; i < r / 8; ++i)
+        s[i * n + l] ^= load64(in[l] + off + 8 * i);
+
+    KeccakF1600_StatePermutexN(s);
+    off += r;
+    inlen -= r;
+  }
+
+  // Last block, padded
+  for (l = 0; l < n; ++l)
+  {
+    for (i = 0; i < r; ++i)
+      b[i] = 0;
+    for (i = 0; i < inlen; ++i)
+      b[i] = in[l][off + i];
+    b[inlen] = p;
+    b[r - 1] |= 128;
+
+    for (i = 0; i < r / 8; ++i)
+      s[i * n + l] ^= load64(b + 8 * i);
+  }
+}
+
+/*************************************************
+ * Name:        keccakxN_squeezeblocks
+ *
+ * Description: Squeeze step of Keccak. Squeezes full blocks of r bytes each.
+ *              Modifies the state. Can be called multiple times to keep
+ *              squeezing, i.e., is incremental.
+ *
+ * Arguments:   - uint8_t *const out[]: keccakxN_lanes() output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - keccakxN_state *state: pointer to input/output Keccak state
+ **************************************************/
+static void keccakxN_squeezeblocks(uint8_t *const out[],
+                                   size_t nblocks,
+                                   unsigned int r,
+                                   keccakxN_state *state)
+{
+  unsigned int i, l;
+  const unsigned int n = state->n;
+  uint64_t *s = state->s;
+  size_t off = 0;
+
+  while (nblocks > 0)
+  {
+    KeccakF1600_StatePermutexN(s);
+
+    for (l = 0; l < n; ++l)
+      for (i = 0; i < r / 8; ++i)
+        store64(out[l] + off + 8 * i, s[i * n + l]);
+
+    off += r;
+    --nblocks;
+  }
+}
+
+/*************************************************
+ * Name:        keccakxN
+ *
+ * Description: Absorb then squeeze outlen bytes, non-incremental
+ *
+ * Arguments:   - uint8_t *const out[]: keccakxN_lanes() outputs
+ *              - size_t outlen: requested output length in bytes
+ *              - unsigned int r: rate in bytes
+ *              - const uint8_t *const in[]: keccakxN_lanes() inputs
+ *              - size_t inlen: length of input in bytes
+ *              - uint8_t p: domain-separation byte
+ **************************************************/
+static void keccakxN(uint8_t *const out[],
+                     size_t outlen,
+                     unsigned int r,
+                     const uint8_t *const in[],
+                     size_t inlen,
+                     uint8_t p)
+{
+  unsigned int i, l, n;
+  size_t nblocks = outlen / r;
+  size_t off = nblocks * r;
+  uint64_t *s;
+  keccakxN_state state;
+
+  keccakxN_absorb(&state, r, in, inlen, p);
+  keccakxN_squeezeblocks(out, nblocks, r, &state);
+
+  outlen -= off;
+  if (outlen)
+  {
+    n = state.n;
+    s = state.s;
+    KeccakF1600_StatePermutexN(s);
+    for (l = 0; l < n; ++l)
+      for (i = 0; i < outlen; ++i)
+        out[l][off + i] = s[(i / 8) * n + l] >> 8 * (i % 8);
+  }
+}
+
+/*************************************************
+ * Name:        shake128xN_absorb
+ *
+ * Description: Absorb step of the SHAKE128 XOF.
+ *              non-incremental, starts by zeroeing the state.
+ *
+ * Arguments:   - keccakxN_state *state: pointer to (uninitialized) output
+ *                                     Keccak state
+ *              - const uint8_t *const in[]: keccakxN_lanes() inputs
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void shake128xN_absorb(keccakxN_state *state,
+                       const uint8_t *const in[],
+                       size_t inlen)
+{
+  keccakxN_absorb(state, SHAKE128_RATE, in, inlen, 0x1F);
+}
+
+/*************************************************
+ * Name:        shake128xN_squeezeblocks
+ *
+ * Description: Squeeze step of SHAKE128 XOF. Squeezes full blocks of
+ *              SHAKE128_RATE bytes each. Modifies the state. Can be called
+ *              multiple times to keep squeezing, i.e., is incremental.
+ *
+ * Arguments:   - uint8_t *const out[]: keccakxN_lanes() output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ *                                (written to output)
+ *              - keccakxN_state *state: pointer to input/output Keccak state
+ **************************************************/
+void shake128xN_squeezeblocks(uint8_t *const out[],
+                              size_t nblocks,
+                              keccakxN_state *state)
+{
+  keccakxN_squeezeblocks(out, nblocks, SHAKE128_RATE, state);
+}
+
+/*************************************************
+ * Name:        shake256xN_absorb
+ *
+ * Description: Absorb step of the SHAKE256 XOF.
+ *              non-incremental, starts by zeroeing the state.
+ *
+ * Arguments:   - keccakxN_state *state: pointer to (uninitialized) output
+ *                                     Keccak state
+ *              - const uint8_t *const in[]: keccakxN_lanes() inputs
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void shake256xN_absorb(keccakxN_state *state,
+                       const uint8_t *const in[],
+                       size_t inlen)
+{
+  keccakxN_absorb(state, SHAKE256_RATE, in, inlen, 0x1F);
+}
+
+/*************************************************
+ * Name:        shake256xN_squeezeblocks
+ *
+ * Description: Squeeze step of SHAKE256 XOF. Squeezes full blocks of
+ *              SHAKE256_RATE bytes each. Modifies the state. Can be called
+ *              multiple times to keep squeezing, i.e., is incremental.
+ *
+ * Arguments:   - uint8_t *const out[]: keccakxN_lanes() output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ *                                (written to output)
+ *              - keccakxN_state *state: pointer to input/output Keccak state
+ **************************************************/
+void shake256xN_squeezeblocks(uint8_t *const out[],
+                              size_t nblocks,
+                              keccakxN_state *state)
+{
+  keccakxN_squeezeblocks(out, nblocks, SHAKE256_RATE, state);
+}
+
+/*************************************************
+ * Name:        shake128xN
+ *
+ * Description: SHAKE128 XOF with non-incremental API
+ *
+ * Arguments:   - uint8_t *const out[]: keccakxN_lanes() outputs
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *const in[]: keccakxN_lanes() inputs
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void shake128xN(uint8_t *const out[],
+                size_t outlen,
+                const uint8_t *const in[],
+                size_t inlen)
+{
+  keccakxN(out, outlen, SHAKE128_RATE, in, inlen, 0x1F);
+}
+
+/*************************************************
+ * Name:        shake256xN
+ *
+ * Description: SHAKE256 XOF with non-incremental API
+ *
+ * Arguments:   - uint8_t *const out[]: keccakxN_lanes() outputs
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *const in[]: keccakxN_lanes() inputs
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void shake256xN(uint8_t *const out[],
+                size_t outlen,
+                const uint8_t *const in[],
+                size_t inlen)
+{
+  keccakxN(out, outlen, SHAKE256_RATE, in, inlen, 0x1F);
+}
+
+/*************************************************
+ * Name:        sha3_256xN
+ *
+ * Description: SHA3-256 with non-incremental API
+ *
+ * Arguments:   - uint8_t *const h[]: keccakxN_lanes() outputs (32 bytes)
+ *              - const uint8_t *const in[]: keccakxN_lanes() inputs
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void sha3_256xN(uint8_t *const h[],
+                const uint8_t *const in[],
+                size_t inlen)
+{
+  keccakxN(h, 32, SHA3_256_RATE, in, inlen, 0x06);
+}
+
+/*************************************************
+ * Name:        sha3_512xN
+ *
+ * Description: SHA3-512 with non-incremental API
+ *
+ * Arguments:   - uint8_t *const h[]: keccakxN_lanes() outputs (64 bytes)
+ *              - const uint8_t *const in[]: keccakxN_lanes() inputs
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void sha3_512xN(uint8_t *const h[],
+                const uint8_t *const in[],
+                size_t inlen)
+{
+  keccakxN(h, 64, SHA3_512_RATE, in, inlen, 0x06);
+}
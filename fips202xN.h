@@ -0,0 +1,82 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#ifndef FIPS202XN_H
+#define FIPS202XN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "fips202x2.h"
+
+/*
+ * Vector-length agnostic: one message per 64-bit SVE element,
+ * keccakxN_lanes() messages at once. Without SVE, and on other
+ * architectures, the 2-way kernel is used.
+ */
+#define KECCAKXN_MAX_LANES 32
+
+/*
+ * Lane i of message l at s[i * n + l]
+ */
+typedef struct {
+  uint64_t s[25 * KECCAKXN_MAX_LANES];
+  unsigned int n;
+} keccakxN_state;
+
+unsigned int keccakxN_lanes(void);
+
+const char *keccakxN_get_kernel(void);
+int keccakxN_set_kernel(const char *name);
+
+void KeccakF1600_StatePermutexN(uint64_t *state);
+
+/*
+ * in[] and out[] hold keccakxN_lanes() pointers
+ */
+void shake128xN_absorb(keccakxN_state *state,
+                       const uint8_t *const in[],
+                       size_t inlen);
+
+void shake128xN_squeezeblocks(uint8_t *const out[],
+                              size_t nblocks,
+                              keccakxN_state *state);
+
+void shake256xN_absorb(keccakxN_state *state,
+                       const uint8_t *const in[],
+                       size_t inlen);
+
+void shake256xN_squeezeblocks(uint8_t *const out[],
+                              size_t nblocks,
+                              keccakxN_state *state);
+
+void shake128xN(uint8_t *const out[],
+                size_t outlen,
+                const uint8_t *const in[],
+                size_t inlen);
+
+void shake256xN(uint8_t *const out[],
+                size_t outlen,
+                const uint8_t *const in[],
+                size_t inlen);
+
+void sha3_256xN(uint8_t *const h[],
+                const uint8_t *const in[],
+                size_t inlen);
+
+void sha3_512xN(uint8_t *const h[],
+                const uint8_t *const in[],
+                size_t inlen);
+
+#endif
@@ -0,0 +1,507 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "fips202.h"
+#include "fips202x2.h"
+#include "kangarootwelve.h"
+
+// Bitwise-XOR: c = a ^ b
+#define vxor(c, a, b) c = v128_xor(a, b);
+
+/*
+ * KangarooTwelve input S = M || C || length_encode(|C|),
+ * read in chunks without concatenating it
+ */
+typedef struct {
+  const uint8_t *in;
+  size_t inlen;
+  const uint8_t *custom;
+  size_t customlen;
+  uint8_t enc[9];
+  size_t enclen;
+} kt128_input;
+
+/*************************************************
+ * Name:        kt128_length_encode
+ *
+ * Description: length_encode of RFC 9861: big-endian bytes of x without
+ *              leading zeros, then their number
+ *
+ * Arguments:   - uint8_t *enc: output, at most 9 bytes
+ *              - size_t x: value to encode
+ *
+ * Returns the number of bytes written
+ **************************************************/
+static size_t kt128_length_encode(uint8_t enc[9], size_t x)
+{
+  size_t i, n = 0;
+  uint8_t t[8];
+
+  while (x > 0)
+  {
+    t[n++] = (uint8_t)x;
+    x >>= 8;
+  }
+
+  for (i = 0; i < n; ++i)
+    enc[i] = t[n - 1 - i];
+  enc[n] = (uint8_t)n;
+
+  return n + 1;
+}
+
+/*************************************************
+ * Name:        turbo_absorb
+ *
+ * Description: Incremental absorb for the scalar sponge
+ *
+ * Arguments:   - uint64_t *s: pointer to input/output Keccak state
+ *              - unsigned int pos: bytes of the block already absorbed
+ *              - unsigned int r: rate in bytes
+ *              - const uint8_t *in: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *
+ * Returns the new position in the block
+ **************************************************/
+static unsigned int turbo_absorb(uint64_t s[25],
+                                 unsigned int pos,
+                                 unsigned int r,
+                                 const uint8_t *in,
+                                 size_t inlen)
+{
+  unsigned int i;
+
+  while (inlen > 0)
+  {
+    // Whole blocks
+    if (pos == 0 && inlen >= r)
+    {
+      for (i = 0; i < r / 8; ++i)
+        s[i] ^= v128_load64(&in[8 * i]);
+      KeccakP1600_12_StatePermute(s);
+      in += r;
+      inlen -= r;
+      continue;
+    }
+
+    s[pos / 8] ^= (uint64_t)*in++ << 8 * (pos % 8);
+    inlen--;
+
+    if (++pos == r)
+    {
+      KeccakP1600_12_StatePermute(s);
+      pos = 0;
+    }
+  }
+
+  return pos;
+}
+
+/*************************************************
+ * Name:        turbo_squeeze
+ *
+ * Description: Pad with d, then squeeze outlen bytes from the
+ *              scalar sponge
+ *
+ * Arguments:   - uint8_t *out: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - uint64_t *s: pointer to input/output Keccak state
+ *              - unsigned int pos: bytes of the block already absorbed
+ *              - unsigned int r: rate in bytes
+ *              - uint8_t d: domain-separation byte
+ **************************************************/
+static void turbo_squeeze(uint8_t *out,
+                          size_t outlen,
+                          uint64_t s[25],
+                          unsigned int pos,
+                          unsigned int r,
+                          uint8_t d)
+{
+  unsigned int i;
+
+  s[pos / 8] ^= (uint64_t)d << 8 * (pos % 8);
+  s[r / 8 - 1] ^= 1ULL << 63;
+
+  while (outlen > 0)
+  {
+    KeccakP1600_12_StatePermute(s);
+    for (i = 0; i < r && outlen > 0; ++i, --outlen)
+      *out++ = s[i / 8] >> 8 * (i % 8);
+  }
+}
+
+/*************************************************
+ * Name:        turboshake
+ *
+ * Description: TurboSHAKE on the scalar sponge
+ *
+ * Arguments:   - uint8_t *out: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - unsigned int r: rate in bytes
+ *              - const uint8_t *in: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - uint8_t d: domain-separation byte
+ **************************************************/
+static void turboshake(uint8_t *out,
+                       size_t outlen,
+                       unsigned int r,
+                       const uint8_t *in,
+                       size_t inlen,
+                       uint8_t d)
+{
+  unsigned int pos;
+  uint64_t s[25] = {0};
+
+  pos = turbo_absorb(s, 0, r, in, inlen);
+  turbo_squeeze(out, outlen, s, pos, r, d);
+}
+
+/*************************************************
+ * Name:        turbox2_absorb
+ *
+ * Description: Absorb two inputs of the same length and pad them with d,
+ *              non-incremental, starts by zeroeing the state
+ *
+ * Arguments:   - v128 *s: pointer to (uninitialized) output Keccak state
+ *              - unsigned int r: rate in bytes, 168 or 136
+ *              - const uint8_t *in0, *in1: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - uint8_t d: domain-separation byte
+ **************************************************/
+static void turbox2_absorb(v128 s[25],
+                           unsigned int r,
+                           const uint8_t *in0,
+                           const uint8_t *in1,
+                           size_t inlen,
+                           uint8_t d)
+{
+  unsigned int i;
+  uint8_t t[2][200];
+  v128 a0, a1, b0, b1, tmp;
+
+  for (i = 0; i < 25; ++i)
+    s[i] = v128_zero();
+
+  while (inlen >= r)
+  {
+    for (i = 0; i < r / 8 - 1; i += 4)
+    {
+      a0 = v128_load(&in0[8 * i]);
+      a1 = v128_load(&in0[8 * i + 16]);
+      b0 = v128_load(&in1[8 * i]);
+      b1 = v128_load(&in1[8 * i + 16]);
+
+      vxor(s[i + 0], s[i + 0], v128_zip0(a0, b0));
+      vxor(s[i + 1], s[i + 1], v128_zip1(a0, b0));
+      vxor(s[i + 2], s[i + 2], v128_zip0(a1, b1));
+      vxor(s[i + 3], s[i + 3], v128_zip1(a1, b1));
+    }
+    // Last iteration
+    tmp = v128_load2(&in0[8 * i], &in1[8 * i]);
+    vxor(s[i], s[i], tmp);
+
+    KeccakP1600_12_StatePermutex2(s);
+    in0 += r;
+    in1 += r;
+    inlen -= r;
+  }
+
+  // Padded last block
+  memset(t, 0, sizeof(t));
+  memcpy(t[0], in0, inlen);
+  memcpy(t[1], in1, inlen);
+  t[0][inlen] = d;
+  t[1][inlen] = d;
+  t[0][r - 1] |= 0x80;
+  t[1][r - 1] |= 0x80;
+
+  for (i = 0; i < r / 8; ++i)
+  {
+    tmp = v128_load2(&t[0][8 * i], &t[1][8 * i]);
+    vxor(s[i], s[i], tmp);
+  }
+}
+
+/*************************************************
+ * Name:        turbox2_squeeze
+ *
+ * Description: Squeeze outlen bytes from each lane
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - unsigned int r: rate in bytes
+ *              - v128 *s: pointer to input/output Keccak state
+ **************************************************/
+static void turbox2_squeeze(uint8_t *out0,
+                            uint8_t *out1,
+                            size_t outlen,
+                            unsigned int r,
+                            v128 s[25])
+{
+  unsigned int i;
+  size_t n;
+  uint8_t t[2][200];
+
+  while (outlen > 0)
+  {
+    KeccakP1600_12_StatePermutex2(s);
+
+    for (i = 0; i + 2 <= r / 8; i += 2)
+    {
+      v128_store(&t[0][8 * i], v128_zip0(s[i], s[i + 1]));
+      v128_store(&t[1][8 * i], v128_zip1(s[i], s[i + 1]));
+    }
+    if (i < r / 8)
+      v128_store2(&t[0][8 * i], &t[1][8 * i], s[i]);
+
+    n = outlen < r ? outlen : r;
+    memcpy(out0, t[0], n);
+    memcpy(out1, t[1], n);
+    out0 += n;
+    out1 += n;
+    outlen -= n;
+  }
+}
+
+/*************************************************
+ * Name:        kt128_chunk
+ *
+ * Description: Bytes [off, off + len) of S, in place when they lie
+ *              in M, copied to buf otherwise
+ *
+ * Arguments:   - const kt128_input *x: pointer to the pieces of S
+ *              - uint8_t *buf: scratch, KT128_CHUNK bytes
+ *              - size_t off: offset in S
+ *              - size_t len: at most KT128_CHUNK
+ *
+ * Returns a pointer to the bytes
+ **************************************************/
+static const uint8_t *kt128_chunk(const kt128_input *x,
+                                  uint8_t *buf,
+                                  size_t off,
+                                  size_t len)
+{
+  size_t n, i = 0;
+
+  if (off + len <= x->inlen)
+    return &x->in[off];
+
+  if (off < x->inlen)
+  {
+    n = x->inlen - off;
+    memcpy(buf, &x->in[off], n);
+    i = n;
+    off += n;
+  }
+  off -= x->inlen;
+
+  if (i < len && off < x->customlen)
+  {
+    n = x->customlen - off;
+    if (n > len - i)
+      n = len - i;
+    memcpy(&buf[i], &x->custom[off], n);
+    i += n;
+    off += n;
+  }
+  off -= x->customlen;
+
+  if (i < len)
+    memcpy(&buf[i], &x->enc[off], len - i);
+
+  return buf;
+}
+
+/*************************************************
+ * Name:        turboshake128
+ *
+ * Description: TurboSHAKE128 XOF
+ *
+ * Arguments:   - uint8_t *out: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - uint8_t d: domain-separation byte
+ **************************************************/
+void turboshake128(uint8_t *out,
+                   size_t outlen,
+                   const uint8_t *in,
+                   size_t inlen,
+                   uint8_t d)
+{
+  turboshake(out, outlen, TURBOSHAKE128_RATE, in, inlen, d);
+}
+
+/*************************************************
+ * Name:        turboshake256
+ *
+ * Description: TurboSHAKE256 XOF
+ *
+ * Arguments:   - uint8_t *out: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - uint8_t d: domain-separation byte
+ **************************************************/
+void turboshake256(uint8_t *out,
+                   size_t outlen,
+                   const uint8_t *in,
+                   size_t inlen,
+                   uint8_t d)
+{
+  turboshake(out, outlen, TURBOSHAKE256_RATE, in, inlen, d);
+}
+
+/*************************************************
+ * Name:        turboshake128x2
+ *
+ * Description: TurboSHAKE128 XOF on two inputs of the same length
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in0, *in1: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - uint8_t d: domain-separation byte
+ **************************************************/
+void turboshake128x2(uint8_t *out0,
+                     uint8_t *out1,
+                     size_t outlen,
+                     const uint8_t *in0,
+                     const uint8_t *in1,
+                     size_t inlen,
+                     uint8_t d)
+{
+  v128 s[25];
+
+  turbox2_absorb(s, TURBOSHAKE128_RATE, in0, in1, inlen, d);
+  turbox2_squeeze(out0, out1, outlen, TURBOSHAKE128_RATE, s);
+}
+
+/*************************************************
+ * Name:        turboshake256x2
+ *
+ * Description: TurboSHAKE256 XOF on two inputs of the same length
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in0, *in1: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - uint8_t d: domain-separation byte
+ **************************************************/
+void turboshake256x2(uint8_t *out0,
+                     uint8_t *out1,
+                     size_t outlen,
+                     const uint8_t *in0,
+                     const uint8_t *in1,
+                     size_t inlen,
+                     uint8_t d)
+{
+  v128 s[25];
+
+  turbox2_absorb(s, TURBOSHAKE256_RATE, in0, in1, inlen, d);
+  turbox2_squeeze(out0, out1, outlen, TURBOSHAKE256_RATE, s);
+}
+
+/*************************************************
+ * Name:        kangarootwelve
+ *
+ * Description: KangarooTwelve (KT128) XOF. Inputs of more than one
+ *              chunk are hashed as a tree: the leaves go through
+ *              TurboSHAKE128 two at a time, their chaining values
+ *              into the final node.
+ *
+ * Arguments:   - uint8_t *out: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - const uint8_t *custom: pointer to customization string
+ *              - size_t customlen: length of customization string in bytes
+ **************************************************/
+void kangarootwelve(uint8_t *out,
+                    size_t outlen,
+                    const uint8_t *in,
+                    size_t inlen,
+                    const uint8_t *custom,
+                    size_t customlen)
+{
+  static const uint8_t marker[8] = {0x03, 0, 0, 0, 0, 0, 0, 0};
+  static const uint8_t terminator[2] = {0xFF, 0xFF};
+  size_t i, nleaves, slen, off, len0, len1;
+  unsigned int pos;
+  uint8_t buf[2][KT128_CHUNK], cv[2][32], enc[9];
+  const uint8_t *p0, *p1;
+  uint64_t s[25] = {0};
+  kt128_input x;
+
+  x.in = in;
+  x.inlen = inlen;
+  x.custom = custom;
+  x.customlen = customlen;
+  x.enclen = kt128_length_encode(x.enc, customlen);
+  slen = inlen + customlen + x.enclen;
+
+  // Single node
+  if (slen <= KT128_CHUNK)
+  {
+    p0 = kt128_chunk(&x, buf[0], 0, slen);
+    pos = turbo_absorb(s, 0, TURBOSHAKE128_RATE, p0, slen);
+    turbo_squeeze(out, outlen, s, pos, TURBOSHAKE128_RATE, 0x07);
+    return;
+  }
+
+  p0 = kt128_chunk(&x, buf[0], 0, KT128_CHUNK);
+  pos = turbo_absorb(s, 0, TURBOSHAKE128_RATE, p0, KT128_CHUNK);
+  pos = turbo_absorb(s, pos, TURBOSHAKE128_RATE, marker, sizeof(marker));
+
+  // Leaves S_1 .. S_n, all but the last one are full chunks
+  nleaves = (slen - 1) / KT128_CHUNK;
+  for (i = 0; i < nleaves; i += 2)
+  {
+    off = (i + 1) * KT128_CHUNK;
+    len0 = slen - off < KT128_CHUNK ? slen - off : KT128_CHUNK;
+    p0 = kt128_chunk(&x, buf[0], off, len0);
+
+    if (i + 1 == nleaves)
+    {
+      turboshake128(cv[0], 32, p0, len0, 0x0B);
+      pos = turbo_absorb(s, pos, TURBOSHAKE128_RATE, cv[0], 32);
+      break;
+    }
+
+    off += KT128_CHUNK;
+    len1 = slen - off < KT128_CHUNK ? slen - off : KT128_CHUNK;
+    p1 = kt128_chunk(&x, buf[1], off, len1);
+
+    if (len0 == len1)
+    {
+      turboshake128x2(cv[0], cv[1], 32, p0, p1, len0, 0x0B);
+    }
+    else
+    {
+      turboshake128(cv[0], 32, p0, len0, 0x0B);
+      turboshake128(cv[1], 32, p1, len1, 0x0B);
+    }
+    pos = turbo_absorb(s, pos, TURBOSHAKE128_RATE, cv[0], 32);
+    pos = turbo_absorb(s, pos, TURBOSHAKE128_RATE, cv[1], 32);
+  }
+
+  pos = turbo_absorb(s, pos, TURBOSHAKE128_RATE, enc,
+                     kt128_length_encode(enc, nleaves));
+  pos = turbo_absorb(s, pos, TURBOSHAKE128_RATE, terminator, sizeof(terminator));
+  turbo_squeeze(out, outlen, s, pos, TURBOSHAKE128_RATE, 0x06);
+}
@@ -0,0 +1,69 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#ifndef KANGAROOTWELVE_H
+#define KANGAROOTWELVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * TurboSHAKE and KangarooTwelve (KT128), RFC 9861, on Keccak-p[1600, 12].
+ * KangarooTwelve hashes its 8192-byte leaves two at a time on
+ * KeccakP1600_12_StatePermutex2.
+ */
+#define TURBOSHAKE128_RATE 168
+#define TURBOSHAKE256_RATE 136
+#define KT128_CHUNK 8192
+
+/*
+ * d: domain-separation byte, 0x01 to 0x7F, 0x1F by default
+ */
+void turboshake128(uint8_t *out,
+                   size_t outlen,
+                   const uint8_t *in,
+                   size_t inlen,
+                   uint8_t d);
+
+void turboshake256(uint8_t *out,
+                   size_t outlen,
+                   const uint8_t *in,
+                   size_t inlen,
+                   uint8_t d);
+
+void turboshake128x2(uint8_t *out0,
+                     uint8_t *out1,
+                     size_t outlen,
+                     const uint8_t *in0,
+                     const uint8_t *in1,
+                     size_t inlen,
+                     uint8_t d);
+
+void turboshake256x2(uint8_t *out0,
+                     uint8_t *out1,
+                     size_t outlen,
+                     const uint8_t *in0,
+                     const uint8_t *in1,
+                     size_t inlen,
+                     uint8_t d);
+
+void kangarootwelve(uint8_t *out,
+                    size_t outlen,
+                    const uint8_t *in,
+                    size_t inlen,
+                    const uint8_t *custom,
+                    size_t customlen);
+
+#endif
@@ -0,0 +1,360 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#ifndef KECCAKF1600_ROUNDS_H
+#define KECCAKF1600_ROUNDS_H
+
+#include <stdint.h>
+
+#define NROUNDS 24
+
+/* Keccak round constants */
+static const uint64_t KeccakF_RoundConstants[NROUNDS] = {
+    (uint64_t)0x0000000000000001ULL,
+    (uint64_t)0x0000000000008082ULL,
+    (uint64_t)0x800000000000808aULL,
+    (uint64_t)0x8000000080008000ULL,
+    (uint64_t)0x000000000000808bULL,
+    (uint64_t)0x0000000080000001ULL,
+    (uint64_t)0x8000000080008081ULL,
+    (uint64_t)0x8000000000008009ULL,
+    (uint64_t)0x000000000000008aULL,
+    (uint64_t)0x0000000000000088ULL,
+    (uint64_t)0x0000000080008009ULL,
+    (uint64_t)0x000000008000000aULL,
+    (uint64_t)0x000000008000808bULL,
+    (uint64_t)0x800000000000008bULL,
+    (uint64_t)0x8000000000008089ULL,
+    (uint64_t)0x8000000000008003ULL,
+    (uint64_t)0x8000000000008002ULL,
+    (uint64_t)0x8000000000000080ULL,
+    (uint64_t)0x000000000000800aULL,
+    (uint64_t)0x800000008000000aULL,
+    (uint64_t)0x8000000080008081ULL,
+    (uint64_t)0x8000000000008080ULL,
+    (uint64_t)0x0000000080000001ULL,
+    (uint64_t)0x8000000080008008ULL};
+
+// Scalar operation set s, for the kernels that interleave a scalar state
+
+#define ROL(a, offset) (((a) << (offset)) ^ ((a) >> (64 - (offset))))
+
+#define sxor(c, a, b) c = (a) ^ (b);
+
+#define sXOR5(out, a, b, c, d, e) out = (a) ^ (b) ^ (c) ^ (d) ^ (e);
+
+#define sRXOR(c, a, b) c = (a) ^ ROL(b, 1);
+
+#define sXORR(c, a, b, n) \
+  a ^= (b);               \
+  c = ROL(a, 64 - (n));
+
+#define sXNA(out, a, b, c) out = (a) ^ ((~(b)) & (c));
+
+#define sIOTA(a, round) a ^= KeccakF_RoundConstants[round];
+
+/*
+ * One Keccak round from state A to state E, in steps small enough to
+ * interleave several independent states. OP selects the operation set
+ * defined by the kernel: OP##xor, OP##XOR5, OP##RXOR, OP##XORR, OP##XNA,
+ * OP##IOTA, e.g. v for NEON, s for scalar. BC and D are the temporaries
+ * of the round.
+ */
+
+// Theta: column parities
+#define THETA(OP, A, BC, D)                            \
+  OP##XOR5(BC##a, A##ba, A##ga, A##ka, A##ma, A##sa);  \
+  OP##XOR5(BC##e, A##be, A##ge, A##ke, A##me, A##se);  \
+  OP##XOR5(BC##i, A##bi, A##gi, A##ki, A##mi, A##si);  \
+  OP##XOR5(BC##o, A##bo, A##go, A##ko, A##mo, A##so);  \
+  OP##XOR5(BC##u, A##bu, A##gu, A##ku, A##mu, A##su);  \
+                                                       \
+  OP##RXOR(D##a, BC##u, BC##e);                        \
+  OP##RXOR(D##e, BC##a, BC##i);                        \
+  OP##RXOR(D##i, BC##e, BC##o);                        \
+  OP##RXOR(D##o, BC##i, BC##u);                        \
+  OP##RXOR(D##u, BC##o, BC##a);
+
+// Chi of one plane
+#define CHI(OP, E, BC)                     \
+  OP##XNA(E##a, BC##a, BC##e, BC##i);      \
+  OP##XNA(E##e, BC##e, BC##i, BC##o);      \
+  OP##XNA(E##i, BC##i, BC##o, BC##u);      \
+  OP##XNA(E##o, BC##o, BC##u, BC##a);      \
+  OP##XNA(E##u, BC##u, BC##a, BC##e);
+
+// Rho, Pi, Chi, Iota of plane b
+#define PLANE_B(OP, A, E, BC, D, round)        \
+  OP##xor(A##ba, A##ba, D##a);                 \
+  OP##XORR(BC##e, A##ge, D##e, 20);            \
+  OP##XORR(BC##i, A##ki, D##i, 21);            \
+  OP##XORR(BC##o, A##mo, D##o, 43);            \
+  OP##XORR(BC##u, A##su, D##u, 50);            \
+                                               \
+  OP##XNA(E##ba, A##ba, BC##e, BC##i);         \
+  OP##IOTA(E##ba, round);                      \
+  OP##XNA(E##be, BC##e, BC##i, BC##o);         \
+  OP##XNA(E##bi, BC##i, BC##o, BC##u);         \
+  OP##XNA(E##bo, BC##o, BC##u, A##ba);         \
+  OP##XNA(E##bu, BC##u, A##ba, BC##e);
+
+// Rho, Pi, Chi of plane g
+#define PLANE_G(OP, A, E, BC, D)           \
+  OP##XORR(BC##a, A##bo, D##o, 36);        \
+  OP##XORR(BC##e, A##gu, D##u, 44);        \
+  OP##XORR(BC##i, A##ka, D##a, 61);        \
+  OP##XORR(BC##o, A##me, D##e, 19);        \
+  OP##XORR(BC##u, A##si, D##i, 3);         \
+  CHI(OP, E##g, BC)
+
+// Rho, Pi, Chi of plane k
+#define PLANE_K(OP, A, E, BC, D)           \
+  OP##XORR(BC##a, A##be, D##e, 63);        \
+  OP##XORR(BC##e, A##gi, D##i, 58);        \
+  OP##XORR(BC##i, A##ko, D##o, 39);        \
+  OP##XORR(BC##o, A##mu, D##u, 56);        \
+  OP##XORR(BC##u, A##sa, D##a, 46);        \
+  CHI(OP, E##k, BC)
+
+// Rho, Pi, Chi of plane m
+#define PLANE_M(OP, A, E, BC, D)           \
+  OP##XORR(BC##a, A##bu, D##u, 37);        \
+  OP##XORR(BC##e, A##ga, D##a, 28);        \
+  OP##XORR(BC##i, A##ke, D##e, 54);        \
+  OP##XORR(BC##o, A##mi, D##i, 49);        \
+  OP##XORR(BC##u, A##so, D##o, 8);         \
+  CHI(OP, E##m, BC)
+
+// Rho, Pi, Chi of plane s
+#define PLANE_S(OP, A, E, BC, D)           \
+  OP##XORR(BC##a, A##bi, D##i, 2);         \
+  OP##XORR(BC##e, A##go, D##o, 9);         \
+  OP##XORR(BC##i, A##ku, D##u, 25);        \
+  OP##XORR(BC##o, A##ma, D##a, 23);        \
+  OP##XORR(BC##u, A##se, D##e, 62);        \
+  CHI(OP, E##s, BC)
+
+#define DECLARE_ROW(T, X) T X##a, X##e, X##i, X##o, X##u;
+
+#define DECLARE_LANES(T, A)                                    \
+  T A##ba, A##be, A##bi, A##bo, A##bu;                         \
+  T A##ga, A##ge, A##gi, A##go, A##gu;                         \
+  T A##ka, A##ke, A##ki, A##ko, A##ku;                         \
+  T A##ma, A##me, A##mi, A##mo, A##mu;                         \
+  T A##sa, A##se, A##si, A##so, A##su;
+
+#define LOAD_LANES(A, state)                                   \
+  A##ba = state[0];  A##be = state[1];  A##bi = state[2];      \
+  A##bo = state[3];  A##bu = state[4];  A##ga = state[5];      \
+  A##ge = state[6];  A##gi = state[7];  A##go = state[8];      \
+  A##gu = state[9];  A##ka = state[10]; A##ke = state[11];     \
+  A##ki = state[12]; A##ko = state[13]; A##ku = state[14];     \
+  A##ma = state[15]; A##me = state[16]; A##mi = state[17];     \
+  A##mo = state[18]; A##mu = state[19]; A##sa = state[20];     \
+  A##se = state[21]; A##si = state[22]; A##so = state[23];     \
+  A##su = state[24];
+
+#define STORE_LANES(state, A)                                  \
+  state[0] = A##ba;  state[1] = A##be;  state[2] = A##bi;      \
+  state[3] = A##bo;  state[4] = A##bu;  state[5] = A##ga;      \
+  state[6] = A##ge;  state[7] = A##gi;  state[8] = A##go;      \
+  state[9] = A##gu;  state[10] = A##ka; state[11] = A##ke;     \
+  state[12] = A##ki; state[13] = A##ko; state[14] = A##ku;     \
+  state[15] = A##ma; state[16] = A##me; state[17] = A##mi;     \
+  state[18] = A##mo; state[19] = A##mu; state[20] = A##sa;     \
+  state[21] = A##se; state[22] = A##si; state[23] = A##so;     \
+  state[24] = A##su;
+
+/*
+ * Absorb one block of n = r / 8 lanes of two messages into the lane
+ * variables of A: two lanes of each message per load, zipped into one
+ * lane of each, an odd last lane with v128_load2. The comparisons
+ * only depend on the rate. Needs v128.h
+ */
+#define ABSORB_PAIR(A0, A1, in0, in1, l, n)                     \
+  if ((n) >= (l) + 2)                                           \
+  {                                                             \
+    v128 in0_ = v128_load(&(in0)[8 * (l)]);                     \
+    v128 in1_ = v128_load(&(in1)[8 * (l)]);                     \
+    A0 = v128_xor(A0, v128_zip0(in0_, in1_));                   \
+    A1 = v128_xor(A1, v128_zip1(in0_, in1_));                   \
+  }                                                             \
+  else if ((n) == (l) + 1)                                      \
+    A0 = v128_xor(A0, v128_load2(&(in0)[8 * (l)], &(in1)[8 * (l)]));
+
+#define ABSORB_LANES(A, in0, in1, n)                            \
+  ABSORB_PAIR(A##ba, A##be, in0, in1, 0, n)                   \
+  ABSORB_PAIR(A##bi, A##bo, in0, in1, 2, n)                   \
+  ABSORB_PAIR(A##bu, A##ga, in0, in1, 4, n)                   \
+  ABSORB_PAIR(A##ge, A##gi, in0, in1, 6, n)                   \
+  ABSORB_PAIR(A##go, A##gu, in0, in1, 8, n)                   \
+  ABSORB_PAIR(A##ka, A##ke, in0, in1, 10, n)                  \
+  ABSORB_PAIR(A##ki, A##ko, in0, in1, 12, n)                  \
+  ABSORB_PAIR(A##ku, A##ma, in0, in1, 14, n)                  \
+  ABSORB_PAIR(A##me, A##mi, in0, in1, 16, n)                  \
+  ABSORB_PAIR(A##mo, A##mu, in0, in1, 18, n)                  \
+  ABSORB_PAIR(A##sa, A##se, in0, in1, 20, n)                  \
+  ABSORB_PAIR(A##si, A##so, in0, in1, 22, n)                  \
+  if ((n) == 25)                                              \
+    A##su = v128_xor(A##su, v128_load2(&(in0)[192], &(in1)[192]));
+
+/*
+ * Store the first n = r / 8 lanes of A to two outputs: two lanes at a
+ * time, unzipped into one store per output, an odd last lane with
+ * v128_store2. Needs v128.h
+ */
+#define SQUEEZE_PAIR(A0, A1, out0, out1, l, n)                  \
+  if ((n) >= (l) + 2)                                           \
+  {                                                             \
+    v128_store(&(out0)[8 * (l)], v128_zip0(A0, A1));            \
+    v128_store(&(out1)[8 * (l)], v128_zip1(A0, A1));            \
+  }                                                             \
+  else if ((n) == (l) + 1)                                      \
+    v128_store2(&(out0)[8 * (l)], &(out1)[8 * (l)], A0);
+
+#define SQUEEZE_LANES(A, out0, out1, n)                         \
+  SQUEEZE_PAIR(A##ba, A##be, out0, out1, 0, n)                \
+  SQUEEZE_PAIR(A##bi, A##bo, out0, out1, 2, n)                \
+  SQUEEZE_PAIR(A##bu, A##ga, out0, out1, 4, n)                \
+  SQUEEZE_PAIR(A##ge, A##gi, out0, out1, 6, n)                \
+  SQUEEZE_PAIR(A##go, A##gu, out0, out1, 8, n)                \
+  SQUEEZE_PAIR(A##ka, A##ke, out0, out1, 10, n)               \
+  SQUEEZE_PAIR(A##ki, A##ko, out0, out1, 12, n)               \
+  SQUEEZE_PAIR(A##ku, A##ma, out0, out1, 14, n)               \
+  SQUEEZE_PAIR(A##me, A##mi, out0, out1, 16, n)               \
+  SQUEEZE_PAIR(A##mo, A##mu, out0, out1, 18, n)               \
+  SQUEEZE_PAIR(A##sa, A##se, out0, out1, 20, n)               \
+  SQUEEZE_PAIR(A##si, A##so, out0, out1, 22, n)               \
+  if ((n) == 25)                                              \
+    v128_store2(&(out0)[192], &(out1)[192], A##su);
+
+/*
+ * The same with lane-interleaved buffers: word l of message 0, then
+ * word l of message 1, 16 bytes per lane, which is the layout of a v128;
+ * plain loads and stores, no zip
+ */
+#define ABSORB_LANES_INTERLEAVED(A, in, n)                      \
+  if ((n) > 0)                                                \
+    A##ba = v128_xor(A##ba, v128_load(&(in)[0]));             \
+  if ((n) > 1)                                                \
+    A##be = v128_xor(A##be, v128_load(&(in)[16]));            \
+  if ((n) > 2)                                                \
+    A##bi = v128_xor(A##bi, v128_load(&(in)[32]));            \
+  if ((n) > 3)                                                \
+    A##bo = v128_xor(A##bo, v128_load(&(in)[48]));            \
+  if ((n) > 4)                                                \
+    A##bu = v128_xor(A##bu, v128_load(&(in)[64]));            \
+  if ((n) > 5)                                                \
+    A##ga = v128_xor(A##ga, v128_load(&(in)[80]));            \
+  if ((n) > 6)                                                \
+    A##ge = v128_xor(A##ge, v128_load(&(in)[96]));            \
+  if ((n) > 7)                                                \
+    A##gi = v128_xor(A##gi, v128_load(&(in)[112]));           \
+  if ((n) > 8)                                                \
+    A##go = v128_xor(A##go, v128_load(&(in)[128]));           \
+  if ((n) > 9)                                                \
+    A##gu = v128_xor(A##gu, v128_load(&(in)[144]));           \
+  if ((n) > 10)                                               \
+    A##ka = v128_xor(A##ka, v128_load(&(in)[160]));           \
+  if ((n) > 11)                                               \
+    A##ke = v128_xor(A##ke, v128_load(&(in)[176]));           \
+  if ((n) > 12)                                               \
+    A##ki = v128_xor(A##ki, v128_load(&(in)[192]));           \
+  if ((n) > 13)                                               \
+    A##ko = v128_xor(A##ko, v128_load(&(in)[208]));           \
+  if ((n) > 14)                                               \
+    A##ku = v128_xor(A##ku, v128_load(&(in)[224]));           \
+  if ((n) > 15)                                               \
+    A##ma = v128_xor(A##ma, v128_load(&(in)[240]));           \
+  if ((n) > 16)                                               \
+    A##me = v128_xor(A##me, v128_load(&(in)[256]));           \
+  if ((n) > 17)                                               \
+    A##mi = v128_xor(A##mi, v128_load(&(in)[272]));           \
+  if ((n) > 18)                                               \
+    A##mo = v128_xor(A##mo, v128_load(&(in)[288]));           \
+  if ((n) > 19)                                               \
+    A##mu = v128_xor(A##mu, v128_load(&(in)[304]));           \
+  if ((n) > 20)                                               \
+    A##sa = v128_xor(A##sa, v128_load(&(in)[320]));           \
+  if ((n) > 21)                                               \
+    A##se = v128_xor(A##se, v128_load(&(in)[336]));           \
+  if ((n) > 22)                                               \
+    A##si = v128_xor(A##si, v128_load(&(in)[352]));           \
+  if ((n) > 23)                                               \
+    A##so = v128_xor(A##so, v128_load(&(in)[368]));           \
+  if ((n) > 24)                                               \
+    A##su = v128_xor(A##su, v128_load(&(in)[384]));
+
+#define SQUEEZE_LANES_INTERLEAVED(A, out, n)                    \
+  if ((n) > 0)                                                \
+    v128_store(&(out)[0], A##ba);                             \
+  if ((n) > 1)                                                \
+    v128_store(&(out)[16], A##be);                            \
+  if ((n) > 2)                                                \
+    v128_store(&(out)[32], A##bi);                            \
+  if ((n) > 3)                                                \
+    v128_store(&(out)[48], A##bo);                            \
+  if ((n) > 4)                                                \
+    v128_store(&(out)[64], A##bu);                            \
+  if ((n) > 5)                                                \
+    v128_store(&(out)[80], A##ga);                            \
+  if ((n) > 6)                                                \
+    v128_store(&(out)[96], A##ge);                            \
+  if ((n) > 7)                                                \
+    v128_store(&(out)[112], A##gi);                           \
+  if ((n) > 8)                                                \
+    v128_store(&(out)[128], A##go);                           \
+  if ((n) > 9)                                                \
+    v128_store(&(out)[144], A##gu);                           \
+  if ((n) > 10)                                               \
+    v128_store(&(out)[160], A##ka);                           \
+  if ((n) > 11)                                               \
+    v128_store(&(out)[176], A##ke);                           \
+  if ((n) > 12)                                               \
+    v128_store(&(out)[192], A##ki);                           \
+  if ((n) > 13)                                               \
+    v128_store(&(out)[208], A##ko);                           \
+  if ((n) > 14)                                               \
+    v128_store(&(out)[224], A##ku);                           \
+  if ((n) > 15)                                               \
+    v128_store(&(out)[240], A##ma);                           \
+  if ((n) > 16)                                               \
+    v128_store(&(out)[256], A##me);                           \
+  if ((n) > 17)                                               \
+    v128_store(&(out)[272], A##mi);                           \
+  if ((n) > 18)                                               \
+    v128_store(&(out)[288], A##mo);                           \
+  if ((n) > 19)                                               \
+    v128_store(&(out)[304], A##mu);                           \
+  if ((n) > 20)                                               \
+    v128_store(&(out)[320], A##sa);                           \
+  if ((n) > 21)                                               \
+    v128_store(&(out)[336], A##se);                           \
+  if ((n) > 22)                                               \
+    v128_store(&(out)[352], A##si);                           \
+  if ((n) > 23)                                               \
+    v128_store(&(out)[368], A##so);                           \
+  if ((n) > 24)                                               \
+    v128_store(&(out)[384], A##su);
+
+#define KECCAK_ROUND(OP, A, E, BC, D, round) \
+  THETA(OP, A, BC, D)                        \
+  PLANE_B(OP, A, E, BC, D, round)            \
+  PLANE_G(OP, A, E, BC, D)                   \
+  PLANE_K(OP, A, E, BC, D)                   \
+  PLANE_M(OP, A, E, BC, D)                   \
+  PLANE_S(OP, A, E, BC, D)
+
+#endif
@@ -0,0 +1,575 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#include <arm_neon.h>
+#include <stddef.h>
+#include "keccakf1600x2.h"
+#include "keccakf1600_rounds.h"
+
+/*
+ * SHA3 == 1 needs at least ARMv8.2-sha3 and builds
+ * KeccakF1600_StatePermutex2_sha3, SHA3 == 0 builds the plain NEON
+ * KeccakF1600_StatePermutex2_neon. The Makefile compiles this file once
+ * for each, the kernel is picked at run time by keccakf1600x2_dispatch.c
+ */
+#ifndef SHA3
+#define SHA3 0
+#endif
+
+#if SHA3 == 1
+#define KECCAKX2_KERNEL(name) name##_sha3
+#else
+#define KECCAKX2_KERNEL(name) name##_neon
+#endif
+
+/*
+ * Using vld1q_u64_x4 is consider harmful
+ */
+#ifndef MEM
+#define MEM 0
+#endif
+
+/*
+ * 32-bit Arm (ARMv7-A NEON, or ARMv8-A in AArch32) has neither the SHA3
+ * instructions nor vld1q_u64_x4; the plain NEON kernel only needs the
+ * 64-bit element VSHL/VSRI/VEOR/VBIC, which AArch32 has
+ */
+#if defined(V128_NEON_A32) && (SHA3 == 1 || MEM == 1)
+#error "32-bit Arm builds only the plain NEON kernel, SHA3=0 MEM=0"
+#endif
+
+// Define NEON operation
+
+// Bitwise-XOR: c = a ^ b
+#define vxor(c, a, b) c = veorq_u64(a, b);
+
+#define pack(out, a, b, c, d) \
+  out.val[0] = a;             \
+  out.val[1] = b;             \
+  out.val[2] = c;             \
+  out.val[3] = d;
+
+#define unpack(a, b, c, d, out) \
+  a = out.val[0];               \
+  b = out.val[1];               \
+  c = out.val[2];               \
+  d = out.val[3];
+
+#if SHA3 == 1
+
+/*
+ * At least ARMv8.2-sha3 supported
+ */
+
+// Xor chain: out = a ^ b ^ c ^ d ^ e
+#define vXOR5(out, a, b, c, d, e) \
+  out = veor3q_u64(a, b, c);      \
+  out = veor3q_u64(out, d, e);
+
+// Rotate left by 1 bit, then XOR: a ^ ROL(b)
+#define vRXOR(c, a, b) c = vrax1q_u64(a, b);
+
+// XOR then Rotate by n bit: c = ROL(a^b, n)
+#define vXORR(c, a, b, n) c = vxarq_u64(a, b, n);
+
+// Xor Not And: out = a ^ ( (~b) & c)
+#define vXNA(out, a, b, c) out = vbcaxq_u64(a, c, b);
+
+#else
+
+// Rotate left by n bit
+#define vROL(out, a, offset)      \
+  out = vshlq_n_u64(a, (offset)); \
+  out = vsriq_n_u64(out, a, 64 - (offset));
+
+// Xor chain: out = a ^ b ^ c ^ d ^ e
+#define vXOR5(out, a, b, c, d, e) \
+  out = veorq_u64(a, b);          \
+  out = veorq_u64(out, c);        \
+  out = veorq_u64(out, d);        \
+  out = veorq_u64(out, e);
+
+// Xor Not And: out = a ^ ( (~b) & c)
+#define vXNA(out, a, b, c) \
+  out = vbicq_u64(c, b);   \
+  out = veorq_u64(out, a);
+
+#define vRXOR(c, a, b) \
+  vROL(c, b, 1);       \
+  vxor(c, c, a);
+
+#define vXORR(c, a, b, n) \
+  a = veorq_u64(a, b);    \
+  vROL(c, a, 64 - n);
+
+#endif
+
+// End
+
+// Iota: xor round constant
+#define vIOTA(a, round) vxor(a, a, vld1q_dup_u64(&KeccakF_RoundConstants[round]));
+
+/*************************************************
+ * Name:        keccakx2_permute
+ *
+ * Description: The last NROUNDS - first rounds of the
+ *              Keccak F1600 Permutation, first even
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - int first: index of the first round
+ **************************************************/
+static void keccakx2_permute(v128 state[25], int first)
+{
+
+  v128 Aba, Abe, Abi, Abo, Abu;
+  v128 Aga, Age, Agi, Ago, Agu;
+  v128 Aka, Ake, Aki, Ako, Aku;
+  v128 Ama, Ame, Ami, Amo, Amu;
+  v128 Asa, Ase, Asi, Aso, Asu;
+  v128 BCa, BCe, BCi, BCo, BCu; // tmp
+  v128 Da, De, Di, Do, Du;      // D
+  v128 Eba, Ebe, Ebi, Ebo, Ebu;
+  v128 Ega, Ege, Egi, Ego, Egu;
+  v128 Eka, Eke, Eki, Eko, Eku;
+  v128 Ema, Eme, Emi, Emo, Emu;
+  v128 Esa, Ese, Esi, Eso, Esu;
+
+#if MEM == 1
+  uint64x2x4_t holder;
+
+  holder = vld1q_u64_x4((uint64_t *)&state[0]);
+  unpack(Aba, Abe, Abi, Abo, holder);
+
+  holder = vld1q_u64_x4((uint64_t *)&state[4]);
+  unpack(Abu, Aga, Age, Agi, holder);
+
+  holder = vld1q_u64_x4((uint64_t *)&state[8]);
+  unpack(Ago, Agu, Aka, Ake, holder);
+
+  holder = vld1q_u64_x4((uint64_t *)&state[12]);
+  unpack(Aki, Ako, Aku, Ama, holder);
+
+  holder = vld1q_u64_x4((uint64_t *)&state[16]);
+  unpack(Ame, Ami, Amo, Amu, holder);
+
+  holder = vld1q_u64_x4((uint64_t *)&state[20]);
+  unpack(Asa, Ase, Asi, Aso, holder);
+
+  Asu = vld1q_u64((uint64_t *)&state[24]);
+#else
+  Aba = state[0];
+  Abe = state[1];
+  Abi = state[2];
+  Abo = state[3];
+  Abu = state[4];
+  Aga = state[5];
+  Age = state[6];
+  Agi = state[7];
+  Ago = state[8];
+  Agu = state[9];
+  Aka = state[10];
+  Ake = state[11];
+  Aki = state[12];
+  Ako = state[13];
+  Aku = state[14];
+  Ama = state[15];
+  Ame = state[16];
+  Ami = state[17];
+  Amo = state[18];
+  Amu = state[19];
+  Asa = state[20];
+  Ase = state[21];
+  Asi = state[22];
+  Aso = state[23];
+  Asu = state[24];
+#endif
+
+  for (int round = first; round < NROUNDS; round += 2)
+  {
+    KECCAK_ROUND(v, A, E, BC, D, round)
+    KECCAK_ROUND(v, E, A, BC, D, round + 1)
+  }
+
+#if MEM == 1
+  pack(holder, Aba, Abe, Abi, Abo);
+  vst1q_u64_x4((uint64_t *)&state[0], holder);
+
+  pack(holder, Abu, Aga, Age, Agi);
+  vst1q_u64_x4((uint64_t *)&state[4], holder);
+
+  pack(holder, Ago, Agu, Aka, Ake);
+  vst1q_u64_x4((uint64_t *)&state[8], holder);
+
+  pack(holder, Aki, Ako, Aku, Ama);
+  vst1q_u64_x4((uint64_t *)&state[12], holder);
+
+  pack(holder, Ame, Ami, Amo, Amu);
+  vst1q_u64_x4((uint64_t *)&state[16], holder);
+
+  pack(holder, Asa, Ase, Asi, Aso);
+  vst1q_u64_x4((uint64_t *)&state[20], holder);
+
+  vst1q_u64((uint64_t *)&state[24], Asu);
+#else
+  state[0] = Aba;
+  state[1] = Abe;
+  state[2] = Abi;
+  state[3] = Abo;
+  state[4] = Abu;
+  state[5] = Aga;
+  state[6] = Age;
+  state[7] = Agi;
+  state[8] = Ago;
+  state[9] = Agu;
+  state[10] = Aka;
+  state[11] = Ake;
+  state[12] = Aki;
+  state[13] = Ako;
+  state[14] = Aku;
+  state[15] = Ama;
+  state[16] = Ame;
+  state[17] = Ami;
+  state[18] = Amo;
+  state[19] = Amu;
+  state[20] = Asa;
+  state[21] = Ase;
+  state[22] = Asi;
+  state[23] = Aso;
+  state[24] = Asu;
+#endif
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutex2_sha3, KeccakF1600_StatePermutex2_neon
+ *
+ * Description: The Keccak F1600 Permutation
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ **************************************************/
+void KECCAKX2_KERNEL(KeccakF1600_StatePermutex2)(v128 state[25])
+{
+  keccakx2_permute(state, 0);
+}
+
+/*************************************************
+ * Name:        KeccakP1600_12_StatePermutex2_sha3, KeccakP1600_12_StatePermutex2_neon
+ *
+ * Description: Keccak-p[1600, 12], the last 12 rounds of the
+ *              Keccak F1600 Permutation
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ **************************************************/
+void KECCAKX2_KERNEL(KeccakP1600_12_StatePermutex2)(v128 state[25])
+{
+  keccakx2_permute(state, NROUNDS - 12);
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StateAbsorbx2_sha3, KeccakF1600_StateAbsorbx2_neon
+ *
+ * Description: Absorb full blocks of r bytes, permuting after each
+ *              block. The state is loaded once, every block is XORed
+ *              into the lane registers and the state is stored back
+ *              after the last permutation.
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - const uint8_t *in0, *in1: pointer to input blocks
+ *              - size_t nblocks: number of blocks to be absorbed
+ **************************************************/
+void KECCAKX2_KERNEL(KeccakF1600_StateAbsorbx2)(v128 state[25],
+                                                unsigned int r,
+                                                const uint8_t *in0,
+                                                const uint8_t *in1,
+                                                size_t nblocks)
+{
+  const unsigned int n = r / 8;
+
+  DECLARE_LANES(v128, A)
+  DECLARE_LANES(v128, E)
+  DECLARE_ROW(v128, BC) // tmp
+  DECLARE_ROW(v128, D)
+
+  LOAD_LANES(A, state)
+
+  for (; nblocks > 0; --nblocks)
+  {
+    ABSORB_LANES(A, in0, in1, n)
+
+    for (int round = 0; round < NROUNDS; round += 2)
+    {
+      KECCAK_ROUND(v, A, E, BC, D, round)
+      KECCAK_ROUND(v, E, A, BC, D, round + 1)
+    }
+
+    in0 += r;
+    in1 += r;
+  }
+
+  STORE_LANES(state, A)
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StateSqueezex2_sha3, KeccakF1600_StateSqueezex2_neon
+ *
+ * Description: Squeeze full blocks of r bytes, permuting before each
+ *              block. The state is loaded once, every block is stored
+ *              to the outputs straight from the lane registers and the
+ *              state is stored back after the last permutation.
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - uint8_t *out0, *out1: pointer to output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ **************************************************/
+void KECCAKX2_KERNEL(KeccakF1600_StateSqueezex2)(v128 state[25],
+                                                 unsigned int r,
+                                                 uint8_t *out0,
+                                                 uint8_t *out1,
+                                                 size_t nblocks)
+{
+  const unsigned int n = r / 8;
+
+  DECLARE_LANES(v128, A)
+  DECLARE_LANES(v128, E)
+  DECLARE_ROW(v128, BC) // tmp
+  DECLARE_ROW(v128, D)
+
+  LOAD_LANES(A, state)
+
+  for (; nblocks > 0; --nblocks)
+  {
+    for (int round = 0; round < NROUNDS; round += 2)
+    {
+      KECCAK_ROUND(v, A, E, BC, D, round)
+      KECCAK_ROUND(v, E, A, BC, D, round + 1)
+    }
+
+    SQUEEZE_LANES(A, out0, out1, n)
+
+    out0 += r;
+    out1 += r;
+  }
+
+  STORE_LANES(state, A)
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StateAbsorbInterleavedx2_sha3, KeccakF1600_StateAbsorbInterleavedx2_neon
+ *
+ * Description: KeccakF1600_StateAbsorbx2 on lane-interleaved blocks
+ *              of 2 * r bytes
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - const uint8_t *in: pointer to interleaved input blocks
+ *              - size_t nblocks: number of blocks to be absorbed
+ **************************************************/
+void KECCAKX2_KERNEL(KeccakF1600_StateAbsorbInterleavedx2)(v128 state[25],
+                                                           unsigned int r,
+                                                           const uint8_t *in,
+                                                           size_t nblocks)
+{
+  const unsigned int n = r / 8;
+
+  DECLARE_LANES(v128, A)
+  DECLARE_LANES(v128, E)
+  DECLARE_ROW(v128, BC) // tmp
+  DECLARE_ROW(v128, D)
+
+  LOAD_LANES(A, state)
+
+  for (; nblocks > 0; --nblocks)
+  {
+    ABSORB_LANES_INTERLEAVED(A, in, n)
+
+    for (int round = 0; round < NROUNDS; round += 2)
+    {
+      KECCAK_ROUND(v, A, E, BC, D, round)
+      KECCAK_ROUND(v, E, A, BC, D, round + 1)
+    }
+
+    in += 2 * r;
+  }
+
+  STORE_LANES(state, A)
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StateSqueezeInterleavedx2_sha3, KeccakF1600_StateSqueezeInterleavedx2_neon
+ *
+ * Description: KeccakF1600_StateSqueezex2 to lane-interleaved blocks
+ *              of 2 * r bytes
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - uint8_t *out: pointer to interleaved output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ **************************************************/
+void KECCAKX2_KERNEL(KeccakF1600_StateSqueezeInterleavedx2)(v128 state[25],
+                                                            unsigned int r,
+                                                            uint8_t *out,
+                                                            size_t nblocks)
+{
+  const unsigned int n = r / 8;
+
+  DECLARE_LANES(v128, A)
+  DECLARE_LANES(v128, E)
+  DECLARE_ROW(v128, BC) // tmp
+  DECLARE_ROW(v128, D)
+
+  LOAD_LANES(A, state)
+
+  for (; nblocks > 0; --nblocks)
+  {
+    for (int round = 0; round < NROUNDS; round += 2)
+    {
+      KECCAK_ROUND(v, A, E, BC, D, round)
+      KECCAK_ROUND(v, E, A, BC, D, round + 1)
+    }
+
+    SQUEEZE_LANES_INTERLEAVED(A, out, n)
+
+    out += 2 * r;
+  }
+
+  STORE_LANES(state, A)
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutex3_sha3, KeccakF1600_StatePermutex3_neon
+ *
+ * Description: The Keccak F1600 Permutation on three states: two in the
+ *              NEON lanes, the third in general-purpose registers.
+ *              The scalar round is interleaved plane by plane with the
+ *              NEON round, so the integer pipes work while NEON does.
+ *
+ * Arguments:   - v128 *state: pointer to input/output 2-way Keccak state
+ *              - uint64_t *state2: pointer to input/output scalar Keccak state
+ **************************************************/
+void KECCAKX2_KERNEL(KeccakF1600_StatePermutex3)(v128 state[25],
+                                                 uint64_t state2[25])
+{
+  DECLARE_LANES(v128, A)
+  DECLARE_LANES(v128, E)
+  DECLARE_ROW(v128, BC) // tmp
+  DECLARE_ROW(v128, D)
+
+  DECLARE_LANES(uint64_t, SA)
+  DECLARE_LANES(uint64_t, SE)
+  DECLARE_ROW(uint64_t, SBC) // tmp
+  DECLARE_ROW(uint64_t, SD)
+
+  LOAD_LANES(A, state)
+  LOAD_LANES(SA, state2)
+
+  for (int round = 0; round < NROUNDS; round += 2)
+  {
+    THETA(v, A, BC, D)
+    THETA(s, SA, SBC, SD)
+    PLANE_B(v, A, E, BC, D, round)
+    PLANE_B(s, SA, SE, SBC, SD, round)
+    PLANE_G(v, A, E, BC, D)
+    PLANE_G(s, SA, SE, SBC, SD)
+    PLANE_K(v, A, E, BC, D)
+    PLANE_K(s, SA, SE, SBC, SD)
+    PLANE_M(v, A, E, BC, D)
+    PLANE_M(s, SA, SE, SBC, SD)
+    PLANE_S(v, A, E, BC, D)
+    PLANE_S(s, SA, SE, SBC, SD)
+
+    // Next Round
+
+    THETA(v, E, BC, D)
+    THETA(s, SE, SBC, SD)
+    PLANE_B(v, E, A, BC, D, round + 1)
+    PLANE_B(s, SE, SA, SBC, SD, round + 1)
+    PLANE_G(v, E, A, BC, D)
+    PLANE_G(s, SE, SA, SBC, SD)
+    PLANE_K(v, E, A, BC, D)
+    PLANE_K(s, SE, SA, SBC, SD)
+    PLANE_M(v, E, A, BC, D)
+    PLANE_M(s, SE, SA, SBC, SD)
+    PLANE_S(v, E, A, BC, D)
+    PLANE_S(s, SE, SA, SBC, SD)
+  }
+
+  STORE_LANES(state, A)
+  STORE_LANES(state2, SA)
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutex4_sha3, KeccakF1600_StatePermutex4_neon
+ *
+ * Description: The Keccak F1600 Permutation on two 2-way states.
+ *              The two instruction streams are independent and
+ *              interleaved plane by plane, so one hides the latency of
+ *              the other. 50 state lanes do not fit in 32 registers:
+ *              interleaving at plane granularity keeps only the planes
+ *              being rewritten live, and lets the compiler spill the
+ *              untouched lanes of the other state.
+ *
+ * Arguments:   - v128 *state0, *state1: pointer to input/output Keccak states
+ **************************************************/
+void KECCAKX2_KERNEL(KeccakF1600_StatePermutex4)(v128 state0[25],
+                                                 v128 state1[25])
+{
+  DECLARE_LANES(v128, A)
+  DECLARE_LANES(v128, E)
+  DECLARE_ROW(v128, BC) // tmp
+  DECLARE_ROW(v128, D)
+
+  DECLARE_LANES(v128, A2)
+  DECLARE_LANES(v128, E2)
+  DECLARE_ROW(v128, BC2) // tmp
+  DECLARE_ROW(v128, D2)
+
+  LOAD_LANES(A, state0)
+  LOAD_LANES(A2, state1)
+
+  for (int round = 0; round < NROUNDS; round += 2)
+  {
+    THETA(v, A, BC, D)
+    THETA(v, A2, BC2, D2)
+    PLANE_B(v, A, E, BC, D, round)
+    PLANE_B(v, A2, E2, BC2, D2, round)
+    PLANE_G(v, A, E, BC, D)
+    PLANE_G(v, A2, E2, BC2, D2)
+    PLANE_K(v, A, E, BC, D)
+    PLANE_K(v, A2, E2, BC2, D2)
+    PLANE_M(v, A, E, BC, D)
+    PLANE_M(v, A2, E2, BC2, D2)
+    PLANE_S(v, A, E, BC, D)
+    PLANE_S(v, A2, E2, BC2, D2)
+
+    // Next Round
+
+    THETA(v, E, BC, D)
+    THETA(v, E2, BC2, D2)
+    PLANE_B(v, E, A, BC, D, round + 1)
+    PLANE_B(v, E2, A2, BC2, D2, round + 1)
+    PLANE_G(v, E, A, BC, D)
+    PLANE_G(v, E2, A2, BC2, D2)
+    PLANE_K(v, E, A, BC, D)
+    PLANE_K(v, E2, A2, BC2, D2)
+    PLANE_M(v, E, A, BC, D)
+    PLANE_M(v, E2, A2, BC2, D2)
+    PLANE_S(v, E, A, BC, D)
+    PLANE_S(v, E2, A2, BC2, D2)
+  }
+
+  STORE_LANES(state0, A)
+  STORE_LANES(state1, A2)
+}
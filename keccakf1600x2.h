@@ -0,0 +1,181 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#ifndef KECCAKF1600X2_H
+#define KECCAKF1600X2_H
+
+#include "fips202x2.h"
+
+// The kernel objects are always compiled as C, benchmark.cxx is not
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Permutation kernels built from keccakf1600x2.c (AArch64) and
+ * keccakf1600x2_x86.c (x86-64), callers go through the dispatcher
+ * in keccakf1600x2_dispatch.c
+ */
+
+#if defined(V128_NEON)
+
+// Needs ARMv8.2-sha3: EOR3, RAX1, XAR, BCAX
+void KeccakF1600_StatePermutex2_sha3(v128 state[25]);
+
+// Any ARMv8-A
+void KeccakF1600_StatePermutex2_neon(v128 state[25]);
+
+// Hand-scheduled assembly, keccakf1600x2_asm.S
+void KeccakF1600_StatePermutex2_sha3_asm(v128 state[25]);
+
+void KeccakF1600_StatePermutex2_neon_asm(v128 state[25]);
+
+// Two NEON lanes plus one scalar state
+void KeccakF1600_StatePermutex3_sha3(v128 state[25], uint64_t state2[25]);
+
+void KeccakF1600_StatePermutex3_neon(v128 state[25], uint64_t state2[25]);
+
+// Two 2-way states interleaved
+void KeccakF1600_StatePermutex4_sha3(v128 state0[25], v128 state1[25]);
+
+void KeccakF1600_StatePermutex4_neon(v128 state0[25], v128 state1[25]);
+
+// Keccak-p[1600, 12]
+void KeccakP1600_12_StatePermutex2_sha3(v128 state[25]);
+
+void KeccakP1600_12_StatePermutex2_neon(v128 state[25]);
+
+// Full blocks of r bytes in or out, the state stays in registers
+// between them
+void KeccakF1600_StateAbsorbx2_sha3(v128 state[25],
+                                    unsigned int r,
+                                    const uint8_t *in0,
+                                    const uint8_t *in1,
+                                    size_t nblocks);
+
+void KeccakF1600_StateAbsorbx2_neon(v128 state[25],
+                                    unsigned int r,
+                                    const uint8_t *in0,
+                                    const uint8_t *in1,
+                                    size_t nblocks);
+
+void KeccakF1600_StateSqueezex2_sha3(v128 state[25],
+                                     unsigned int r,
+                                     uint8_t *out0,
+                                     uint8_t *out1,
+                                     size_t nblocks);
+
+void KeccakF1600_StateSqueezex2_neon(v128 state[25],
+                                     unsigned int r,
+                                     uint8_t *out0,
+                                     uint8_t *out1,
+                                     size_t nblocks);
+
+void KeccakF1600_StateAbsorbInterleavedx2_sha3(v128 state[25],
+                                               unsigned int r,
+                                               const uint8_t *in,
+                                               size_t nblocks);
+
+void KeccakF1600_StateAbsorbInterleavedx2_neon(v128 state[25],
+                                               unsigned int r,
+                                               const uint8_t *in,
+                                               size_t nblocks);
+
+void KeccakF1600_StateSqueezeInterleavedx2_sha3(v128 state[25],
+                                                unsigned int r,
+                                                uint8_t *out,
+                                                size_t nblocks);
+
+void KeccakF1600_StateSqueezeInterleavedx2_neon(v128 state[25],
+                                                unsigned int r,
+                                                uint8_t *out,
+                                                size_t nblocks);
+
+#elif defined(V128_SSE2)
+
+// Needs AVX2
+void KeccakF1600_StatePermutex2_avx2(v128 state[25]);
+
+// Any x86-64
+void KeccakF1600_StatePermutex2_sse2(v128 state[25]);
+
+// Two SSE lanes plus one scalar state
+void KeccakF1600_StatePermutex3_avx2(v128 state[25], uint64_t state2[25]);
+
+void KeccakF1600_StatePermutex3_sse2(v128 state[25], uint64_t state2[25]);
+
+// Two 2-way states, in one ymm register per lane for AVX2
+void KeccakF1600_StatePermutex4_avx2(v128 state0[25], v128 state1[25]);
+
+void KeccakF1600_StatePermutex4_sse2(v128 state0[25], v128 state1[25]);
+
+// Keccak-p[1600, 12]
+void KeccakP1600_12_StatePermutex2_avx2(v128 state[25]);
+
+void KeccakP1600_12_StatePermutex2_sse2(v128 state[25]);
+
+// Full blocks of r bytes in or out, the state stays in registers
+// between them
+void KeccakF1600_StateAbsorbx2_avx2(v128 state[25],
+                                    unsigned int r,
+                                    const uint8_t *in0,
+                                    const uint8_t *in1,
+                                    size_t nblocks);
+
+void KeccakF1600_StateAbsorbx2_sse2(v128 state[25],
+                                    unsigned int r,
+                                    const uint8_t *in0,
+                                    const uint8_t *in1,
+                                    size_t nblocks);
+
+void KeccakF1600_StateSqueezex2_avx2(v128 state[25],
+                                     unsigned int r,
+                                     uint8_t *out0,
+                                     uint8_t *out1,
+                                     size_t nblocks);
+
+void KeccakF1600_StateSqueezex2_sse2(v128 state[25],
+                                     unsigned int r,
+                                     uint8_t *out0,
+                                     uint8_t *out1,
+                                     size_t nblocks);
+
+void KeccakF1600_StateAbsorbInterleavedx2_avx2(v128 state[25],
+                                               unsigned int r,
+                                               const uint8_t *in,
+                                               size_t nblocks);
+
+void KeccakF1600_StateAbsorbInterleavedx2_sse2(v128 state[25],
+                                               unsigned int r,
+                                               const uint8_t *in,
+                                               size_t nblocks);
+
+void KeccakF1600_StateSqueezeInterleavedx2_avx2(v128 state[25],
+                                                unsigned int r,
+                                                uint8_t *out,
+                                                size_t nblocks);
+
+void KeccakF1600_StateSqueezeInterleavedx2_sse2(v128 state[25],
+                                                unsigned int r,
+                                                uint8_t *out,
+                                                size_t nblocks);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,878 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fips202.h"
+#include "fips202x2.h"
+#include "fips202x3.h"
+#include "fips202x4.h"
+#include "keccakf1600x2.h"
+
+#if defined(V128_NEON)
+#if defined(__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP_SHA3
+#define HWCAP_SHA3 (1 << 17)
+#endif
+#elif defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+#endif
+
+/*
+ * Environment variable to pin a kernel by name, e.g. SHA3X2_KERNEL=neon
+ * or SHA3X2_KERNEL=sse2.
+ * Unknown names, or kernels the CPU cannot run, are ignored.
+ */
+#define KECCAKX2_KERNEL_ENV "SHA3X2_KERNEL"
+
+typedef struct {
+  const char *name;
+  int (*supported)(void);
+  void (*permutex2)(v128 state[25]);
+  void (*permutex3)(v128 state[25], uint64_t state2[25]);
+  void (*permutex4)(v128 state0[25], v128 state1[25]);
+  void (*permutex2_12)(v128 state[25]);
+  void (*absorbx2)(v128 state[25], unsigned int r,
+                   const uint8_t *in0, const uint8_t *in1, size_t nblocks);
+  void (*squeezex2)(v128 state[25], unsigned int r,
+                    uint8_t *out0, uint8_t *out1, size_t nblocks);
+  void (*absorbx2_interleaved)(v128 state[25], unsigned int r,
+                               const uint8_t *in, size_t nblocks);
+  void (*squeezex2_interleaved)(v128 state[25], unsigned int r,
+                                uint8_t *out, size_t nblocks);
+} keccakx2_kernels;
+
+#if defined(V128_NEON) && !defined(V128_NEON_A32)
+
+/*************************************************
+ * Name:        cpu_has_sha3
+ *
+ * Description: Check for the ARMv8.2-sha3 instructions at run time
+ *
+ * Returns 1 if EOR3, RAX1, XAR and BCAX are available, 0 otherwise
+ **************************************************/
+static int cpu_has_sha3(void)
+{
+#if defined(__linux__)
+  return (getauxval(AT_HWCAP) & HWCAP_SHA3) != 0;
+#elif defined(__APPLE__)
+  int r = 0;
+  size_t len = sizeof(r);
+
+  if (sysctlbyname("hw.optional.armv8_2_sha3", &r, &len, NULL, 0))
+    return 0;
+  return r != 0;
+#elif defined(__ARM_FEATURE_SHA3)
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+#endif
+
+#if defined(V128_NEON)
+
+/*************************************************
+ * Name:        cpu_has_neon
+ *
+ * Description: ASIMD is mandatory in ARMv8-A, 32-bit builds are
+ *              compiled with -mfpu=neon throughout
+ *
+ * Returns 1
+ **************************************************/
+static int cpu_has_neon(void)
+{
+  return 1;
+}
+
+#elif defined(V128_SSE2)
+
+/*************************************************
+ * Name:        cpu_has_avx2
+ *
+ * Description: Check for AVX2 at run time
+ *
+ * Returns 1 if AVX2 is available and enabled by the OS, 0 otherwise
+ **************************************************/
+static int cpu_has_avx2(void)
+{
+  // Constructors may run before the one initializing the CPU model
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+}
+
+/*************************************************
+ * Name:        cpu_has_sse2
+ *
+ * Description: SSE2 is part of x86-64
+ *
+ * Returns 1
+ **************************************************/
+static int cpu_has_sse2(void)
+{
+  return 1;
+}
+
+#endif
+
+/*************************************************
+ * Name:        cpu_has_scalar
+ *
+ * Description: The scalar kernels run everywhere
+ *
+ * Returns 1
+ **************************************************/
+static int cpu_has_scalar(void)
+{
+  return 1;
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutex2_scalar
+ *
+ * Description: The Keccak F1600 Permutation, one lane after the other
+ *              with the scalar KeccakF1600_StatePermute
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ **************************************************/
+static void KeccakF1600_StatePermutex2_scalar(v128 state[25])
+{
+  unsigned int i;
+  uint64_t s0[25], s1[25];
+
+  for (i = 0; i < 25; ++i)
+  {
+    s0[i] = v128_lane0(state[i]);
+    s1[i] = v128_lane1(state[i]);
+  }
+
+  KeccakF1600_StatePermute(s0);
+  KeccakF1600_StatePermute(s1);
+
+  for (i = 0; i < 25; ++i)
+    state[i] = v128_set(s0[i], s1[i]);
+}
+
+/*************************************************
+ * Name:        KeccakP1600_12_StatePermutex2_scalar
+ *
+ * Description: Keccak-p[1600, 12], one lane after the other
+ *              with the scalar KeccakP1600_12_StatePermute
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ **************************************************/
+static void KeccakP1600_12_StatePermutex2_scalar(v128 state[25])
+{
+  unsigned int i;
+  uint64_t s0[25], s1[25];
+
+  for (i = 0; i < 25; ++i)
+  {
+    s0[i] = v128_lane0(state[i]);
+    s1[i] = v128_lane1(state[i]);
+  }
+
+  KeccakP1600_12_StatePermute(s0);
+  KeccakP1600_12_StatePermute(s1);
+
+  for (i = 0; i < 25; ++i)
+    state[i] = v128_set(s0[i], s1[i]);
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StateAbsorbx2_scalar
+ *
+ * Description: Absorb full blocks of r bytes into two scalar states,
+ *              one after the other with KeccakF1600_StatePermute
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - const uint8_t *in0, *in1: pointer to input blocks
+ *              - size_t nblocks: number of blocks to be absorbed
+ **************************************************/
+static void KeccakF1600_StateAbsorbx2_scalar(v128 state[25],
+                                             unsigned int r,
+                                             const uint8_t *in0,
+                                             const uint8_t *in1,
+                                             size_t nblocks)
+{
+  unsigned int i;
+  uint64_t s0[25], s1[25];
+
+  for (i = 0; i < 25; ++i)
+  {
+    s0[i] = v128_lane0(state[i]);
+    s1[i] = v128_lane1(state[i]);
+  }
+
+  for (; nblocks > 0; --nblocks)
+  {
+    for (i = 0; i < r / 8; ++i)
+    {
+      s0[i] ^= v128_load64(&in0[8 * i]);
+      s1[i] ^= v128_load64(&in1[8 * i]);
+    }
+    KeccakF1600_StatePermute(s0);
+    KeccakF1600_StatePermute(s1);
+
+    in0 += r;
+    in1 += r;
+  }
+
+  for (i = 0; i < 25; ++i)
+    state[i] = v128_set(s0[i], s1[i]);
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StateSqueezex2_scalar
+ *
+ * Description: Squeeze full blocks of r bytes from two scalar states,
+ *              one after the other with KeccakF1600_StatePermute
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - uint8_t *out0, *out1: pointer to output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ **************************************************/
+static void KeccakF1600_StateSqueezex2_scalar(v128 state[25],
+                                              unsigned int r,
+                                              uint8_t *out0,
+                                              uint8_t *out1,
+                                              size_t nblocks)
+{
+  unsigned int i;
+  uint64_t s0[25], s1[25];
+
+  for (i = 0; i < 25; ++i)
+  {
+    s0[i] = v128_lane0(state[i]);
+    s1[i] = v128_lane1(state[i]);
+  }
+
+  for (; nblocks > 0; --nblocks)
+  {
+    KeccakF1600_StatePermute(s0);
+    KeccakF1600_StatePermute(s1);
+    for (i = 0; i < r / 8; ++i)
+    {
+      v128_store64(&out0[8 * i], s0[i]);
+      v128_store64(&out1[8 * i], s1[i]);
+    }
+
+    out0 += r;
+    out1 += r;
+  }
+
+  for (i = 0; i < 25; ++i)
+    state[i] = v128_set(s0[i], s1[i]);
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StateAbsorbInterleavedx2_scalar
+ *
+ * Description: Absorb lane-interleaved blocks of 2 * r bytes,
+ *              one lane after the other with KeccakF1600_StatePermute
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - const uint8_t *in: pointer to interleaved input blocks
+ *              - size_t nblocks: number of blocks to be absorbed
+ **************************************************/
+static void KeccakF1600_StateAbsorbInterleavedx2_scalar(v128 state[25],
+                                                        unsigned int r,
+                                                        const uint8_t *in,
+                                                        size_t nblocks)
+{
+  unsigned int i;
+  uint64_t s0[25], s1[25];
+
+  for (i = 0; i < 25; ++i)
+  {
+    s0[i] = v128_lane0(state[i]);
+    s1[i] = v128_lane1(state[i]);
+  }
+
+  for (; nblocks > 0; --nblocks)
+  {
+    for (i = 0; i < r / 8; ++i)
+    {
+      s0[i] ^= v128_load64(&in[16 * i]);
+      s1[i] ^= v128_load64(&in[16 * i + 8]);
+    }
+    KeccakF1600_StatePermute(s0);
+    KeccakF1600_StatePermute(s1);
+
+    in += 2 * r;
+  }
+
+  for (i = 0; i < 25; ++i)
+    state[i] = v128_set(s0[i], s1[i]);
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StateSqueezeInterleavedx2_scalar
+ *
+ * Description: Squeeze lane-interleaved blocks of 2 * r bytes,
+ *              one lane after the other with KeccakF1600_StatePermute
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - uint8_t *out: pointer to interleaved output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ **************************************************/
+static void KeccakF1600_StateSqueezeInterleavedx2_scalar(v128 state[25],
+                                                         unsigned int r,
+                                                         uint8_t *out,
+                                                         size_t nblocks)
+{
+  unsigned int i;
+  uint64_t s0[25], s1[25];
+
+  for (i = 0; i < 25; ++i)
+  {
+    s0[i] = v128_lane0(state[i]);
+    s1[i] = v128_lane1(state[i]);
+  }
+
+  for (; nblocks > 0; --nblocks)
+  {
+    KeccakF1600_StatePermute(s0);
+    KeccakF1600_StatePermute(s1);
+    for (i = 0; i < r / 8; ++i)
+    {
+      v128_store64(&out[16 * i], s0[i]);
+      v128_store64(&out[16 * i + 8], s1[i]);
+    }
+
+    out += 2 * r;
+  }
+
+  for (i = 0; i < 25; ++i)
+    state[i] = v128_set(s0[i], s1[i]);
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutex3_scalar
+ *
+ * Description: The Keccak F1600 Permutation on three states,
+ *              one after the other with KeccakF1600_StatePermute
+ *
+ * Arguments:   - v128 *state: pointer to input/output 2-way Keccak state
+ *              - uint64_t *state2: pointer to input/output scalar Keccak state
+ **************************************************/
+static void KeccakF1600_StatePermutex3_scalar(v128 state[25],
+                                              uint64_t state2[25])
+{
+  KeccakF1600_StatePermutex2_scalar(state);
+  KeccakF1600_StatePermute(state2);
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutex4_scalar
+ *
+ * Description: The Keccak F1600 Permutation on two 2-way states,
+ *              lane by lane with KeccakF1600_StatePermute
+ *
+ * Arguments:   - v128 *state0, *state1: pointer to input/output Keccak states
+ **************************************************/
+static void KeccakF1600_StatePermutex4_scalar(v128 state0[25],
+                                              v128 state1[25])
+{
+  KeccakF1600_StatePermutex2_scalar(state0);
+  KeccakF1600_StatePermutex2_scalar(state1);
+}
+
+/*
+ * In order of preference
+ */
+#if defined(V128_NEON) && !defined(V128_NEON_A32)
+/*************************************************
+ * Name:        keccakx2_asm_absorb
+ *
+ * Description: Absorb full blocks of r bytes of each input, one call of
+ *              permute per block, for the keccakf1600x2_asm.S kernels
+ *
+ * Arguments:   - void (*permute)(v128 *): 2-way permutation
+ *              - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - const uint8_t *in0, *in1: pointer to input blocks
+ *              - size_t nblocks: number of blocks to be absorbed
+ **************************************************/
+static void keccakx2_asm_absorb(void (*permute)(v128 state[25]),
+                                v128 state[25],
+                                unsigned int r,
+                                const uint8_t *in0,
+                                const uint8_t *in1,
+                                size_t nblocks)
+{
+  unsigned int i;
+  v128 a, b;
+
+  for (; nblocks > 0; --nblocks)
+  {
+    for (i = 0; i + 2 <= r / 8; i += 2)
+    {
+      a = v128_load(&in0[8 * i]);
+      b = v128_load(&in1[8 * i]);
+      state[i] = v128_xor(state[i], v128_zip0(a, b));
+      state[i + 1] = v128_xor(state[i + 1], v128_zip1(a, b));
+    }
+    if (i < r / 8)
+      state[i] = v128_xor(state[i], v128_load2(&in0[8 * i], &in1[8 * i]));
+    permute(state);
+
+    in0 += r;
+    in1 += r;
+  }
+}
+
+/*************************************************
+ * Name:        keccakx2_asm_squeeze
+ *
+ * Description: Squeeze full blocks of r bytes to each output, one call
+ *              of permute per block, for the keccakf1600x2_asm.S kernels
+ *
+ * Arguments:   - void (*permute)(v128 *): 2-way permutation
+ *              - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - uint8_t *out0, *out1: pointer to output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ **************************************************/
+static void keccakx2_asm_squeeze(void (*permute)(v128 state[25]),
+                                 v128 state[25],
+                                 unsigned int r,
+                                 uint8_t *out0,
+                                 uint8_t *out1,
+                                 size_t nblocks)
+{
+  unsigned int i;
+
+  for (; nblocks > 0; --nblocks)
+  {
+    permute(state);
+    for (i = 0; i + 2 <= r / 8; i += 2)
+    {
+      v128_store(&out0[8 * i], v128_zip0(state[i], state[i + 1]));
+      v128_store(&out1[8 * i], v128_zip1(state[i], state[i + 1]));
+    }
+    if (i < r / 8)
+      v128_store2(&out0[8 * i], &out1[8 * i], state[i]);
+
+    out0 += r;
+    out1 += r;
+  }
+}
+
+/*************************************************
+ * Name:        keccakx2_asm_absorb_interleaved
+ *
+ * Description: keccakx2_asm_absorb on lane-interleaved blocks of
+ *              2 * r bytes
+ *
+ * Arguments:   - void (*permute)(v128 *): 2-way permutation
+ *              - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - const uint8_t *in: pointer to interleaved input blocks
+ *              - size_t nblocks: number of blocks to be absorbed
+ **************************************************/
+static void keccakx2_asm_absorb_interleaved(void (*permute)(v128 state[25]),
+                                            v128 state[25],
+                                            unsigned int r,
+                                            const uint8_t *in,
+                                            size_t nblocks)
+{
+  unsigned int i;
+
+  for (; nblocks > 0; --nblocks)
+  {
+    for (i = 0; i < r / 8; ++i)
+      state[i] = v128_xor(state[i], v128_load(&in[16 * i]));
+    permute(state);
+
+    in += 2 * r;
+  }
+}
+
+/*************************************************
+ * Name:        keccakx2_asm_squeeze_interleaved
+ *
+ * Description: keccakx2_asm_squeeze to lane-interleaved blocks of
+ *              2 * r bytes
+ *
+ * Arguments:   - void (*permute)(v128 *): 2-way permutation
+ *              - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - uint8_t *out: pointer to interleaved output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ **************************************************/
+static void keccakx2_asm_squeeze_interleaved(void (*permute)(v128 state[25]),
+                                             v128 state[25],
+                                             unsigned int r,
+                                             uint8_t *out,
+                                             size_t nblocks)
+{
+  unsigned int i;
+
+  for (; nblocks > 0; --nblocks)
+  {
+    permute(state);
+    for (i = 0; i < r / 8; ++i)
+      v128_store(&out[16 * i], state[i]);
+
+    out += 2 * r;
+  }
+}
+
+/*
+ * Absorb and squeeze entries of the sha3_asm and neon_asm kernels: the
+ * loops above around KeccakF1600_StatePermutex2_<k>
+ */
+#define KECCAKX2_ASM_SPONGE(k)                                              \
+  static void KeccakF1600_StateAbsorbx2_##k(v128 state[25], unsigned int r, \
+                                            const uint8_t *in0,             \
+                                            const uint8_t *in1,             \
+                                            size_t nblocks)                 \
+  {                                                                         \
+    keccakx2_asm_absorb(KeccakF1600_StatePermutex2_##k, state, r,           \
+                        in0, in1, nblocks);                                 \
+  }                                                                         \
+  static void KeccakF1600_StateSqueezex2_##k(v128 state[25], unsigned int r,\
+                                             uint8_t *out0, uint8_t *out1,  \
+                                             size_t nblocks)                \
+  {                                                                         \
+    keccakx2_asm_squeeze(KeccakF1600_StatePermutex2_##k, state, r,          \
+                         out0, out1, nblocks);                              \
+  }                                                                         \
+  static void KeccakF1600_StateAbsorbInterleavedx2_##k(v128 state[25],      \
+                                                       unsigned int r,      \
+                                                       const uint8_t *in,   \
+                                                       size_t nblocks)      \
+  {                                                                         \
+    keccakx2_asm_absorb_interleaved(KeccakF1600_StatePermutex2_##k, state,  \
+                                    r, in, nblocks);                        \
+  }                                                                         \
+  static void KeccakF1600_StateSqueezeInterleavedx2_##k(v128 state[25],     \
+                                                        unsigned int r,     \
+                                                        uint8_t *out,       \
+                                                        size_t nblocks)     \
+  {                                                                         \
+    keccakx2_asm_squeeze_interleaved(KeccakF1600_StatePermutex2_##k, state, \
+                                     r, out, nblocks);                      \
+  }
+
+KECCAKX2_ASM_SPONGE(sha3_asm)
+KECCAKX2_ASM_SPONGE(neon_asm)
+
+/*
+ * KECCAKX2_ASM == 1 (make ASM=1) prefers the hand-scheduled permutations
+ * of keccakf1600x2_asm.S, otherwise they are only picked by name. Absorb
+ * and squeeze run the asm permutation too; the x3/x4 and 12-round
+ * entries are the intrinsics ones.
+ */
+#ifndef KECCAKX2_ASM
+#define KECCAKX2_ASM 0
+#endif
+
+#define KECCAKX2_ASM_KERNELS                        \
+  {"sha3_asm", cpu_has_sha3,                        \
+   KeccakF1600_StatePermutex2_sha3_asm,             \
+   KeccakF1600_StatePermutex3_sha3,                 \
+   KeccakF1600_StatePermutex4_sha3,                 \
+   KeccakP1600_12_StatePermutex2_sha3,              \
+   KeccakF1600_StateAbsorbx2_sha3_asm,              \
+   KeccakF1600_StateSqueezex2_sha3_asm,             \
+   KeccakF1600_StateAbsorbInterleavedx2_sha3_asm,   \
+   KeccakF1600_StateSqueezeInterleavedx2_sha3_asm}, \
+  {"neon_asm", cpu_has_neon,                        \
+   KeccakF1600_StatePermutex2_neon_asm,             \
+   KeccakF1600_StatePermutex3_neon,                 \
+   KeccakF1600_StatePermutex4_neon,                 \
+   KeccakP1600_12_StatePermutex2_neon,              \
+   KeccakF1600_StateAbsorbx2_neon_asm,              \
+   KeccakF1600_StateSqueezex2_neon_asm,             \
+   KeccakF1600_StateAbsorbInterleavedx2_neon_asm,   \
+   KeccakF1600_StateSqueezeInterleavedx2_neon_asm},
+#endif
+
+static const keccakx2_kernels kernels[] = {
+#if defined(V128_NEON) && !defined(V128_NEON_A32)
+#if KECCAKX2_ASM == 1
+    KECCAKX2_ASM_KERNELS
+#endif
+    {"sha3", cpu_has_sha3,
+     KeccakF1600_StatePermutex2_sha3,
+     KeccakF1600_StatePermutex3_sha3,
+     KeccakF1600_StatePermutex4_sha3,
+     KeccakP1600_12_StatePermutex2_sha3,
+     KeccakF1600_StateAbsorbx2_sha3,
+     KeccakF1600_StateSqueezex2_sha3,
+     KeccakF1600_StateAbsorbInterleavedx2_sha3,
+     KeccakF1600_StateSqueezeInterleavedx2_sha3},
+#endif
+#if defined(V128_NEON)
+    {"neon", cpu_has_neon,
+     KeccakF1600_StatePermutex2_neon,
+     KeccakF1600_StatePermutex3_neon,
+     KeccakF1600_StatePermutex4_neon,
+     KeccakP1600_12_StatePermutex2_neon,
+     KeccakF1600_StateAbsorbx2_neon,
+     KeccakF1600_StateSqueezex2_neon,
+     KeccakF1600_StateAbsorbInterleavedx2_neon,
+     KeccakF1600_StateSqueezeInterleavedx2_neon},
+#if KECCAKX2_ASM == 0 && !defined(V128_NEON_A32)
+    KECCAKX2_ASM_KERNELS
+#endif
+#elif defined(V128_SSE2)
+    {"avx2", cpu_has_avx2,
+     KeccakF1600_StatePermutex2_avx2,
+     KeccakF1600_StatePermutex3_avx2,
+     KeccakF1600_StatePermutex4_avx2,
+     KeccakP1600_12_StatePermutex2_avx2,
+     KeccakF1600_StateAbsorbx2_avx2,
+     KeccakF1600_StateSqueezex2_avx2,
+     KeccakF1600_StateAbsorbInterleavedx2_avx2,
+     KeccakF1600_StateSqueezeInterleavedx2_avx2},
+    {"sse2", cpu_has_sse2,
+     KeccakF1600_StatePermutex2_sse2,
+     KeccakF1600_StatePermutex3_sse2,
+     KeccakF1600_StatePermutex4_sse2,
+     KeccakP1600_12_StatePermutex2_sse2,
+     KeccakF1600_StateAbsorbx2_sse2,
+     KeccakF1600_StateSqueezex2_sse2,
+     KeccakF1600_StateAbsorbInterleavedx2_sse2,
+     KeccakF1600_StateSqueezeInterleavedx2_sse2},
+#endif
+    {"scalar", cpu_has_scalar,
+     KeccakF1600_StatePermutex2_scalar,
+     KeccakF1600_StatePermutex3_scalar,
+     KeccakF1600_StatePermutex4_scalar,
+     KeccakP1600_12_StatePermutex2_scalar,
+     KeccakF1600_StateAbsorbx2_scalar,
+     KeccakF1600_StateSqueezex2_scalar,
+     KeccakF1600_StateAbsorbInterleavedx2_scalar,
+     KeccakF1600_StateSqueezeInterleavedx2_scalar},
+};
+
+#define NKERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+// Plain NEON (or neon_asm) or SSE2 runs everywhere, used until the
+// constructor has run; on 32-bit Arm it is the first kernel
+#if defined(V128_NEON_A32)
+static const keccakx2_kernels *active = &kernels[0];
+#elif defined(V128_NEON) || defined(V128_SSE2)
+static const keccakx2_kernels *active = &kernels[1];
+#else
+static const keccakx2_kernels *active = &kernels[0];
+#endif
+
+/*************************************************
+ * Name:        keccakx2_set_kernel
+ *
+ * Description: Select the permutation kernel by name.
+ *              Not thread-safe against concurrent hashing.
+ *
+ * Arguments:   - const char *name: "sha3", "neon", "sha3_asm", "neon_asm",
+ *                "avx2", "sse2" or "scalar"
+ *
+ * Returns 0 on success, -1 if the kernel is unknown or
+ * not supported by this CPU
+ **************************************************/
+int keccakx2_set_kernel(const char *name)
+{
+  size_t i;
+
+  for (i = 0; i < NKERNELS; ++i)
+  {
+    if (strcmp(name, kernels[i].name) == 0)
+    {
+      if (!kernels[i].supported())
+        return -1;
+      active = &kernels[i];
+      return 0;
+    }
+  }
+  return -1;
+}
+
+/*************************************************
+ * Name:        keccakx2_get_kernel
+ *
+ * Description: Name of the permutation kernel in use
+ *
+ * Returns "sha3", "neon", "sha3_asm", "neon_asm", "avx2", "sse2"
+ * or "scalar"
+ **************************************************/
+const char *keccakx2_get_kernel(void)
+{
+  return active->name;
+}
+
+/*************************************************
+ * Name:        keccakx2_select_kernel
+ *
+ * Description: Runs at load time: honours SHA3X2_KERNEL, otherwise
+ *              picks the first kernel supported by this CPU
+ **************************************************/
+__attribute__((constructor)) static void keccakx2_select_kernel(void)
+{
+  size_t i;
+  const char *env = getenv(KECCAKX2_KERNEL_ENV);
+
+  if (env != NULL && keccakx2_set_kernel(env) == 0)
+    return;
+
+  for (i = 0; i < NKERNELS; ++i)
+  {
+    if (kernels[i].supported())
+    {
+      active = &kernels[i];
+      return;
+    }
+  }
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutex2
+ *
+ * Description: The Keccak F1600 Permutation, runs the selected kernel
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ **************************************************/
+void KeccakF1600_StatePermutex2(v128 state[25])
+{
+  active->permutex2(state);
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutex3
+ *
+ * Description: The Keccak F1600 Permutation on two NEON lanes plus
+ *              one scalar state, runs the selected kernel
+ *
+ * Arguments:   - v128 *state: pointer to input/output 2-way Keccak state
+ *              - uint64_t *state2: pointer to input/output scalar Keccak state
+ **************************************************/
+void KeccakF1600_StatePermutex3(v128 state[25], uint64_t state2[25])
+{
+  active->permutex3(state, state2);
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutex4
+ *
+ * Description: The Keccak F1600 Permutation on two 2-way states,
+ *              runs the selected kernel
+ *
+ * Arguments:   - v128 *state0, *state1: pointer to input/output Keccak states
+ **************************************************/
+void KeccakF1600_StatePermutex4(v128 state0[25], v128 state1[25])
+{
+  active->permutex4(state0, state1);
+}
+
+/*************************************************
+ * Name:        KeccakP1600_12_StatePermutex2
+ *
+ * Description: Keccak-p[1600, 12], the last 12 rounds of the
+ *              Keccak F1600 Permutation, runs the selected kernel
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ **************************************************/
+void KeccakP1600_12_StatePermutex2(v128 state[25])
+{
+  active->permutex2_12(state);
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StateAbsorbx2
+ *
+ * Description: Absorb full blocks of r bytes, permuting after each
+ *              block, runs the selected kernel
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - const uint8_t *in0, *in1: pointer to input blocks
+ *              - size_t nblocks: number of blocks to be absorbed
+ **************************************************/
+void KeccakF1600_StateAbsorbx2(v128 state[25],
+                               unsigned int r,
+                               const uint8_t *in0,
+                               const uint8_t *in1,
+                               size_t nblocks)
+{
+  active->absorbx2(state, r, in0, in1, nblocks);
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StateSqueezex2
+ *
+ * Description: Squeeze full blocks of r bytes, permuting before each
+ *              block, runs the selected kernel
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - uint8_t *out0, *out1: pointer to output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ **************************************************/
+void KeccakF1600_StateSqueezex2(v128 state[25],
+                                unsigned int r,
+                                uint8_t *out0,
+                                uint8_t *out1,
+                                size_t nblocks)
+{
+  active->squeezex2(state, r, out0, out1, nblocks);
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StateAbsorbInterleavedx2
+ *
+ * Description: Absorb lane-interleaved blocks of 2 * r bytes,
+ *              runs the selected kernel
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - const uint8_t *in: pointer to interleaved input blocks
+ *              - size_t nblocks: number of blocks to be absorbed
+ **************************************************/
+void KeccakF1600_StateAbsorbInterleavedx2(v128 state[25],
+                                          unsigned int r,
+                                          const uint8_t *in,
+                                          size_t nblocks)
+{
+  active->absorbx2_interleaved(state, r, in, nblocks);
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StateSqueezeInterleavedx2
+ *
+ * Description: Squeeze lane-interleaved blocks of 2 * r bytes,
+ *              runs the selected kernel
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - uint8_t *out: pointer to interleaved output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ **************************************************/
+void KeccakF1600_StateSqueezeInterleavedx2(v128 state[25],
+                                           unsigned int r,
+                                           uint8_t *out,
+                                           size_t nblocks)
+{
+  active->squeezex2_interleaved(state, r, out, nblocks);
+}
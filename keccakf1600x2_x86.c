@@ -0,0 +1,539 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#include <immintrin.h>
+#include <stddef.h>
+#include "keccakf1600x2.h"
+#include "keccakf1600_rounds.h"
+
+/*
+ * AVX2 == 1 needs AVX2 and builds the _avx2 kernels: the 2-way ones are
+ * the SSE2 code in VEX encoding with byte-shuffle rotates, the 4-way one
+ * holds both 2-way states in one ymm register per lane. AVX2 == 0 builds
+ * the _sse2 kernels, SSE2 is in every x86-64 CPU. The Makefile compiles
+ * this file once for each, the kernel is picked at run time by
+ * keccakf1600x2_dispatch.c
+ */
+#ifndef AVX2
+#define AVX2 0
+#endif
+
+#if AVX2 == 1
+#define KECCAKX2_KERNEL(name) name##_avx2
+#else
+#define KECCAKX2_KERNEL(name) name##_sse2
+#endif
+
+// Define SSE2 operation, op set x
+
+// Bitwise-XOR: c = a ^ b
+#define xxor(c, a, b) c = _mm_xor_si128(a, b);
+
+#if AVX2 == 1
+
+// Rotate left by n bit, whole bytes with one shuffle
+#define xROL(out, a, offset)                                           \
+  out = (offset) == 8                                                  \
+            ? _mm_shuffle_epi8(a, _mm256_castsi256_si128(rho8))        \
+        : (offset) == 56                                               \
+            ? _mm_shuffle_epi8(a, _mm256_castsi256_si128(rho56))       \
+            : _mm_or_si128(_mm_slli_epi64(a, (offset)),                \
+                           _mm_srli_epi64(a, 64 - (offset)));
+
+#else
+
+// Rotate left by n bit
+#define xROL(out, a, offset)                       \
+  out = _mm_or_si128(_mm_slli_epi64(a, (offset)),  \
+                     _mm_srli_epi64(a, 64 - (offset)));
+
+#endif
+
+// Xor chain: out = a ^ b ^ c ^ d ^ e, as a tree
+#define xXOR5(out, a, b, c, d, e)                                \
+  out = _mm_xor_si128(_mm_xor_si128(a, b), _mm_xor_si128(c, d)); \
+  out = _mm_xor_si128(out, e);
+
+// Rotate left by 1 bit, then XOR: a ^ ROL(b)
+#define xRXOR(c, a, b) \
+  xROL(c, b, 1);       \
+  xxor(c, c, a);
+
+// XOR then Rotate by n bit: c = ROL(a^b, 64 - n)
+#define xXORR(c, a, b, n)  \
+  a = _mm_xor_si128(a, b); \
+  xROL(c, a, 64 - n);
+
+// Xor Not And: out = a ^ ( (~b) & c)
+#define xXNA(out, a, b, c) out = _mm_xor_si128(a, _mm_andnot_si128(b, c));
+
+// Iota: xor round constant
+#define xIOTA(a, round) xxor(a, a, _mm_set1_epi64x((long long)KeccakF_RoundConstants[round]));
+
+// End
+
+#if AVX2 == 1
+
+// Define AVX2 operation, op set y, same shape as x
+
+#define yxor(c, a, b) c = _mm256_xor_si256(a, b);
+
+#define yROL(out, a, offset)                                           \
+  out = (offset) == 8                                                  \
+            ? _mm256_shuffle_epi8(a, rho8)                             \
+        : (offset) == 56                                               \
+            ? _mm256_shuffle_epi8(a, rho56)                            \
+            : _mm256_or_si256(_mm256_slli_epi64(a, (offset)),          \
+                              _mm256_srli_epi64(a, 64 - (offset)));
+
+#define yXOR5(out, a, b, c, d, e)                                         \
+  out = _mm256_xor_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(c, d)); \
+  out = _mm256_xor_si256(out, e);
+
+#define yRXOR(c, a, b) \
+  yROL(c, b, 1);       \
+  yxor(c, c, a);
+
+#define yXORR(c, a, b, n)     \
+  a = _mm256_xor_si256(a, b); \
+  yROL(c, a, 64 - n);
+
+#define yXNA(out, a, b, c) out = _mm256_xor_si256(a, _mm256_andnot_si256(b, c));
+
+#define yIOTA(a, round) yxor(a, a, _mm256_set1_epi64x((long long)KeccakF_RoundConstants[round]));
+
+// End
+
+// Byte shuffles for ROL 8 and ROL 56 of every 64-bit lane
+#define DECLARE_RHO                                                        \
+  const __m256i rho8 = _mm256_setr_epi8(7, 0, 1, 2, 3, 4, 5, 6,           \
+                                        15, 8, 9, 10, 11, 12, 13, 14,     \
+                                        7, 0, 1, 2, 3, 4, 5, 6,           \
+                                        15, 8, 9, 10, 11, 12, 13, 14);    \
+  const __m256i rho56 = _mm256_setr_epi8(1, 2, 3, 4, 5, 6, 7, 0,          \
+                                         9, 10, 11, 12, 13, 14, 15, 8,    \
+                                         1, 2, 3, 4, 5, 6, 7, 0,          \
+                                         9, 10, 11, 12, 13, 14, 15, 8);
+
+#else
+
+#define DECLARE_RHO
+
+#endif
+
+/*************************************************
+ * Name:        keccakx2_permute
+ *
+ * Description: The last NROUNDS - first rounds of the
+ *              Keccak F1600 Permutation, first even
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - int first: index of the first round
+ **************************************************/
+static void keccakx2_permute(v128 state[25], int first)
+{
+  DECLARE_RHO
+
+  DECLARE_LANES(__m128i, A)
+  DECLARE_LANES(__m128i, E)
+  DECLARE_ROW(__m128i, BC) // tmp
+  DECLARE_ROW(__m128i, D)
+
+  LOAD_LANES(A, state)
+
+  for (int round = first; round < NROUNDS; round += 2)
+  {
+    KECCAK_ROUND(x, A, E, BC, D, round)
+    KECCAK_ROUND(x, E, A, BC, D, round + 1)
+  }
+
+  STORE_LANES(state, A)
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutex2_sse2, KeccakF1600_StatePermutex2_avx2
+ *
+ * Description: The Keccak F1600 Permutation
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ **************************************************/
+void KECCAKX2_KERNEL(KeccakF1600_StatePermutex2)(v128 state[25])
+{
+  keccakx2_permute(state, 0);
+}
+
+/*************************************************
+ * Name:        KeccakP1600_12_StatePermutex2_sse2, KeccakP1600_12_StatePermutex2_avx2
+ *
+ * Description: Keccak-p[1600, 12], the last 12 rounds of the
+ *              Keccak F1600 Permutation
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ **************************************************/
+void KECCAKX2_KERNEL(KeccakP1600_12_StatePermutex2)(v128 state[25])
+{
+  keccakx2_permute(state, NROUNDS - 12);
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StateAbsorbx2_sse2, KeccakF1600_StateAbsorbx2_avx2
+ *
+ * Description: Absorb full blocks of r bytes, permuting after each
+ *              block. The state is loaded once, every block is XORed
+ *              into the lane variables and the state is stored back
+ *              after the last permutation.
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - const uint8_t *in0, *in1: pointer to input blocks
+ *              - size_t nblocks: number of blocks to be absorbed
+ **************************************************/
+void KECCAKX2_KERNEL(KeccakF1600_StateAbsorbx2)(v128 state[25],
+                                                unsigned int r,
+                                                const uint8_t *in0,
+                                                const uint8_t *in1,
+                                                size_t nblocks)
+{
+  const unsigned int n = r / 8;
+
+  DECLARE_RHO
+
+  DECLARE_LANES(__m128i, A)
+  DECLARE_LANES(__m128i, E)
+  DECLARE_ROW(__m128i, BC) // tmp
+  DECLARE_ROW(__m128i, D)
+
+  LOAD_LANES(A, state)
+
+  for (; nblocks > 0; --nblocks)
+  {
+    ABSORB_LANES(A, in0, in1, n)
+
+    for (int round = 0; round < NROUNDS; round += 2)
+    {
+      KECCAK_ROUND(x, A, E, BC, D, round)
+      KECCAK_ROUND(x, E, A, BC, D, round + 1)
+    }
+
+    in0 += r;
+    in1 += r;
+  }
+
+  STORE_LANES(state, A)
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StateSqueezex2_sse2, KeccakF1600_StateSqueezex2_avx2
+ *
+ * Description: Squeeze full blocks of r bytes, permuting before each
+ *              block. The state is loaded once, every block is stored
+ *              to the outputs straight from the lane variables and the
+ *              state is stored back after the last permutation.
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - uint8_t *out0, *out1: pointer to output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ **************************************************/
+void KECCAKX2_KERNEL(KeccakF1600_StateSqueezex2)(v128 state[25],
+                                                 unsigned int r,
+                                                 uint8_t *out0,
+                                                 uint8_t *out1,
+                                                 size_t nblocks)
+{
+  const unsigned int n = r / 8;
+
+  DECLARE_RHO
+
+  DECLARE_LANES(__m128i, A)
+  DECLARE_LANES(__m128i, E)
+  DECLARE_ROW(__m128i, BC) // tmp
+  DECLARE_ROW(__m128i, D)
+
+  LOAD_LANES(A, state)
+
+  for (; nblocks > 0; --nblocks)
+  {
+    for (int round = 0; round < NROUNDS; round += 2)
+    {
+      KECCAK_ROUND(x, A, E, BC, D, round)
+      KECCAK_ROUND(x, E, A, BC, D, round + 1)
+    }
+
+    SQUEEZE_LANES(A, out0, out1, n)
+
+    out0 += r;
+    out1 += r;
+  }
+
+  STORE_LANES(state, A)
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StateAbsorbInterleavedx2_sse2, KeccakF1600_StateAbsorbInterleavedx2_avx2
+ *
+ * Description: KeccakF1600_StateAbsorbx2 on lane-interleaved blocks
+ *              of 2 * r bytes
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - const uint8_t *in: pointer to interleaved input blocks
+ *              - size_t nblocks: number of blocks to be absorbed
+ **************************************************/
+void KECCAKX2_KERNEL(KeccakF1600_StateAbsorbInterleavedx2)(v128 state[25],
+                                                           unsigned int r,
+                                                           const uint8_t *in,
+                                                           size_t nblocks)
+{
+  const unsigned int n = r / 8;
+
+  DECLARE_RHO
+
+  DECLARE_LANES(__m128i, A)
+  DECLARE_LANES(__m128i, E)
+  DECLARE_ROW(__m128i, BC) // tmp
+  DECLARE_ROW(__m128i, D)
+
+  LOAD_LANES(A, state)
+
+  for (; nblocks > 0; --nblocks)
+  {
+    ABSORB_LANES_INTERLEAVED(A, in, n)
+
+    for (int round = 0; round < NROUNDS; round += 2)
+    {
+      KECCAK_ROUND(x, A, E, BC, D, round)
+      KECCAK_ROUND(x, E, A, BC, D, round + 1)
+    }
+
+    in += 2 * r;
+  }
+
+  STORE_LANES(state, A)
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StateSqueezeInterleavedx2_sse2, KeccakF1600_StateSqueezeInterleavedx2_avx2
+ *
+ * Description: KeccakF1600_StateSqueezex2 to lane-interleaved blocks
+ *              of 2 * r bytes
+ *
+ * Arguments:   - v128 *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes (e.g., 168 for SHAKE128)
+ *              - uint8_t *out: pointer to interleaved output blocks
+ *              - size_t nblocks: number of blocks to be squeezed
+ **************************************************/
+void KECCAKX2_KERNEL(KeccakF1600_StateSqueezeInterleavedx2)(v128 state[25],
+                                                            unsigned int r,
+                                                            uint8_t *out,
+                                                            size_t nblocks)
+{
+  const unsigned int n = r / 8;
+
+  DECLARE_RHO
+
+  DECLARE_LANES(__m128i, A)
+  DECLARE_LANES(__m128i, E)
+  DECLARE_ROW(__m128i, BC) // tmp
+  DECLARE_ROW(__m128i, D)
+
+  LOAD_LANES(A, state)
+
+  for (; nblocks > 0; --nblocks)
+  {
+    for (int round = 0; round < NROUNDS; round += 2)
+    {
+      KECCAK_ROUND(x, A, E, BC, D, round)
+      KECCAK_ROUND(x, E, A, BC, D, round + 1)
+    }
+
+    SQUEEZE_LANES_INTERLEAVED(A, out, n)
+
+    out += 2 * r;
+  }
+
+  STORE_LANES(state, A)
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutex3_sse2, KeccakF1600_StatePermutex3_avx2
+ *
+ * Description: The Keccak F1600 Permutation on three states: two in the
+ *              SSE lanes, the third in general-purpose registers,
+ *              interleaved plane by plane.
+ *
+ * Arguments:   - v128 *state: pointer to input/output 2-way Keccak state
+ *              - uint64_t *state2: pointer to input/output scalar Keccak state
+ **************************************************/
+void KECCAKX2_KERNEL(KeccakF1600_StatePermutex3)(v128 state[25],
+                                                 uint64_t state2[25])
+{
+  DECLARE_RHO
+
+  DECLARE_LANES(__m128i, A)
+  DECLARE_LANES(__m128i, E)
+  DECLARE_ROW(__m128i, BC) // tmp
+  DECLARE_ROW(__m128i, D)
+
+  DECLARE_LANES(uint64_t, SA)
+  DECLARE_LANES(uint64_t, SE)
+  DECLARE_ROW(uint64_t, SBC) // tmp
+  DECLARE_ROW(uint64_t, SD)
+
+  LOAD_LANES(A, state)
+  LOAD_LANES(SA, state2)
+
+  for (int round = 0; round < NROUNDS; round += 2)
+  {
+    THETA(x, A, BC, D)
+    THETA(s, SA, SBC, SD)
+    PLANE_B(x, A, E, BC, D, round)
+    PLANE_B(s, SA, SE, SBC, SD, round)
+    PLANE_G(x, A, E, BC, D)
+    PLANE_G(s, SA, SE, SBC, SD)
+    PLANE_K(x, A, E, BC, D)
+    PLANE_K(s, SA, SE, SBC, SD)
+    PLANE_M(x, A, E, BC, D)
+    PLANE_M(s, SA, SE, SBC, SD)
+    PLANE_S(x, A, E, BC, D)
+    PLANE_S(s, SA, SE, SBC, SD)
+
+    // Next Round
+
+    THETA(x, E, BC, D)
+    THETA(s, SE, SBC, SD)
+    PLANE_B(x, E, A, BC, D, round + 1)
+    PLANE_B(s, SE, SA, SBC, SD, round + 1)
+    PLANE_G(x, E, A, BC, D)
+    PLANE_G(s, SE, SA, SBC, SD)
+    PLANE_K(x, E, A, BC, D)
+    PLANE_K(s, SE, SA, SBC, SD)
+    PLANE_M(x, E, A, BC, D)
+    PLANE_M(s, SE, SA, SBC, SD)
+    PLANE_S(x, E, A, BC, D)
+    PLANE_S(s, SE, SA, SBC, SD)
+  }
+
+  STORE_LANES(state, A)
+  STORE_LANES(state2, SA)
+}
+
+#if AVX2 == 1
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutex4_avx2
+ *
+ * Description: The Keccak F1600 Permutation on two 2-way states, one
+ *              ymm register per lane: state0 in the low 128 bits,
+ *              state1 in the high 128 bits
+ *
+ * Arguments:   - v128 *state0, *state1: pointer to input/output Keccak states
+ **************************************************/
+void KECCAKX2_KERNEL(KeccakF1600_StatePermutex4)(v128 state0[25],
+                                                 v128 state1[25])
+{
+  unsigned int i;
+  __m256i s[25];
+
+  DECLARE_RHO
+
+  DECLARE_LANES(__m256i, A)
+  DECLARE_LANES(__m256i, E)
+  DECLARE_ROW(__m256i, BC) // tmp
+  DECLARE_ROW(__m256i, D)
+
+  for (i = 0; i < 25; ++i)
+    s[i] = _mm256_inserti128_si256(_mm256_castsi128_si256(state0[i]),
+                                   state1[i], 1);
+
+  LOAD_LANES(A, s)
+
+  for (int round = 0; round < NROUNDS; round += 2)
+  {
+    KECCAK_ROUND(y, A, E, BC, D, round)
+    KECCAK_ROUND(y, E, A, BC, D, round + 1)
+  }
+
+  STORE_LANES(s, A)
+
+  for (i = 0; i < 25; ++i)
+  {
+    state0[i] = _mm256_castsi256_si128(s[i]);
+    state1[i] = _mm256_extracti128_si256(s[i], 1);
+  }
+}
+
+#else
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutex4_sse2
+ *
+ * Description: The Keccak F1600 Permutation on two 2-way states,
+ *              interleaved plane by plane
+ *
+ * Arguments:   - v128 *state0, *state1: pointer to input/output Keccak states
+ **************************************************/
+void KECCAKX2_KERNEL(KeccakF1600_StatePermutex4)(v128 state0[25],
+                                                 v128 state1[25])
+{
+  DECLARE_LANES(__m128i, A)
+  DECLARE_LANES(__m128i, E)
+  DECLARE_ROW(__m128i, BC) // tmp
+  DECLARE_ROW(__m128i, D)
+
+  DECLARE_LANES(__m128i, A2)
+  DECLARE_LANES(__m128i, E2)
+  DECLARE_ROW(__m128i, BC2) // tmp
+  DECLARE_ROW(__m128i, D2)
+
+  LOAD_LANES(A, state0)
+  LOAD_LANES(A2, state1)
+
+  for (int round = 0; round < NROUNDS; round += 2)
+  {
+    THETA(x, A, BC, D)
+    THETA(x, A2, BC2, D2)
+    PLANE_B(x, A, E, BC, D, round)
+    PLANE_B(x, A2, E2, BC2, D2, round)
+    PLANE_G(x, A, E, BC, D)
+    PLANE_G(x, A2, E2, BC2, D2)
+    PLANE_K(x, A, E, BC, D)
+    PLANE_K(x, A2, E2, BC2, D2)
+    PLANE_M(x, A, E, BC, D)
+    PLANE_M(x, A2, E2, BC2, D2)
+    PLANE_S(x, A, E, BC, D)
+    PLANE_S(x, A2, E2, BC2, D2)
+
+    // Next Round
+
+    THETA(x, E, BC, D)
+    THETA(x, E2, BC2, D2)
+    PLANE_B(x, E, A, BC, D, round + 1)
+    PLANE_B(x, E2, A2, BC2, D2, round + 1)
+    PLANE_G(x, E, A, BC, D)
+    PLANE_G(x, E2, A2, BC2, D2)
+    PLANE_K(x, E, A, BC, D)
+    PLANE_K(x, E2, A2, BC2, D2)
+    PLANE_M(x, E, A, BC, D)
+    PLANE_M(x, E2, A2, BC2, D2)
+    PLANE_S(x, E, A, BC, D)
+    PLANE_S(x, E2, A2, BC2, D2)
+  }
+
+  STORE_LANES(state0, A)
+  STORE_LANES(state1, A2)
+}
+
+#endif
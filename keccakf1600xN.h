@@ -0,0 +1,45 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#ifndef KECCAKF1600XN_H
+#define KECCAKF1600XN_H
+
+#include <stdint.h>
+
+// The kernel objects are always compiled as C, benchmark.cxx is not
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * SVE kernels built from keccakf1600xN_sve.c on AArch64,
+ * callers go through the dispatcher in keccakf1600xN_dispatch.c
+ */
+
+// Needs SVE2: EOR3, XAR, BCAX
+void KeccakF1600_StatePermutexN_sve2(uint64_t *state);
+
+unsigned int keccakxN_lanes_sve2(void);
+
+// Any SVE
+void KeccakF1600_StatePermutexN_sve(uint64_t *state);
+
+unsigned int keccakxN_lanes_sve(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
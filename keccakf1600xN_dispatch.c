@@ -0,0 +1,240 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fips202xN.h"
+#include "keccakf1600xN.h"
+
+#if defined(V128_NEON) && !defined(V128_NEON_A32) && defined(__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1 << 22)
+#endif
+#ifndef HWCAP2_SVE2
+#define HWCAP2_SVE2 (1 << 1)
+#endif
+#endif
+
+/*
+ * Environment variable to pin a kernel by name, e.g. SHA3XN_KERNEL=sve.
+ * Unknown names, or kernels the CPU cannot run, are ignored.
+ */
+#define KECCAKXN_KERNEL_ENV "SHA3XN_KERNEL"
+
+typedef struct {
+  const char *name;
+  int (*supported)(void);
+  void (*permutexN)(uint64_t *state);
+  unsigned int (*lanes)(void);
+} keccakxN_kernels;
+
+#if defined(V128_NEON) && !defined(V128_NEON_A32)
+
+/*************************************************
+ * Name:        cpu_has_sve2
+ *
+ * Description: Check for SVE2 at run time
+ *
+ * Returns 1 if SVE2 is available, 0 otherwise
+ **************************************************/
+static int cpu_has_sve2(void)
+{
+#if defined(__linux__)
+  return (getauxval(AT_HWCAP2) & HWCAP2_SVE2) != 0;
+#else
+  return 0;
+#endif
+}
+
+/*************************************************
+ * Name:        cpu_has_sve
+ *
+ * Description: Check for SVE at run time
+ *
+ * Returns 1 if SVE is available, 0 otherwise
+ **************************************************/
+static int cpu_has_sve(void)
+{
+#if defined(__linux__)
+  return (getauxval(AT_HWCAP) & HWCAP_SVE) != 0;
+#else
+  return 0;
+#endif
+}
+
+#endif
+
+/*************************************************
+ * Name:        cpu_has_x2
+ *
+ * Description: The 2-way fallback runs everywhere
+ *
+ * Returns 1
+ **************************************************/
+static int cpu_has_x2(void)
+{
+  return 1;
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutexN_x2
+ *
+ * Description: The Keccak F1600 Permutation on two states with
+ *              KeccakF1600_StatePermutex2; for n = 2 the layout
+ *              s[i * n + l] is the one of v128 s[25]
+ *
+ * Arguments:   - uint64_t *state: pointer to input/output Keccak states
+ **************************************************/
+static void KeccakF1600_StatePermutexN_x2(uint64_t *state)
+{
+  unsigned int i;
+  v128 s[25];
+
+  for (i = 0; i < 25; ++i)
+    s[i] = v128_load((const uint8_t *)&state[2 * i]);
+
+  KeccakF1600_StatePermutex2(s);
+
+  for (i = 0; i < 25; ++i)
+    v128_store((uint8_t *)&state[2 * i], s[i]);
+}
+
+/*************************************************
+ * Name:        keccakxN_lanes_x2
+ *
+ * Description: Number of states handled by KeccakF1600_StatePermutexN_x2
+ *
+ * Returns 2
+ **************************************************/
+static unsigned int keccakxN_lanes_x2(void)
+{
+  return 2;
+}
+
+/*
+ * In order of preference
+ */
+static const keccakxN_kernels kernels[] = {
+#if defined(V128_NEON) && !defined(V128_NEON_A32)
+    {"sve2", cpu_has_sve2,
+     KeccakF1600_StatePermutexN_sve2, keccakxN_lanes_sve2},
+    {"sve", cpu_has_sve,
+     KeccakF1600_StatePermutexN_sve, keccakxN_lanes_sve},
+#endif
+    {"x2", cpu_has_x2,
+     KeccakF1600_StatePermutexN_x2, keccakxN_lanes_x2},
+};
+
+#define NKERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+// The 2-way kernel runs everywhere, used until the constructor has run
+static const keccakxN_kernels *active = &kernels[NKERNELS - 1];
+static unsigned int active_lanes = 2;
+
+/*************************************************
+ * Name:        keccakxN_set_kernel
+ *
+ * Description: Select the N-way permutation kernel by name.
+ *              Not thread-safe against concurrent hashing;
+ *              states absorbed before the switch must not be reused.
+ *
+ * Arguments:   - const char *name: "sve2", "sve" or "x2"
+ *
+ * Returns 0 on success, -1 if the kernel is unknown or
+ * not supported by this CPU
+ **************************************************/
+int keccakxN_set_kernel(const char *name)
+{
+  size_t i;
+
+  for (i = 0; i < NKERNELS; ++i)
+  {
+    if (strcmp(name, kernels[i].name) == 0)
+    {
+      if (!kernels[i].supported())
+        return -1;
+      active = &kernels[i];
+      active_lanes = active->lanes();
+      return 0;
+    }
+  }
+  return -1;
+}
+
+/*************************************************
+ * Name:        keccakxN_get_kernel
+ *
+ * Description: Name of the N-way permutation kernel in use
+ *
+ * Returns "sve2", "sve" or "x2"
+ **************************************************/
+const char *keccakxN_get_kernel(void)
+{
+  return active->name;
+}
+
+/*************************************************
+ * Name:        keccakxN_lanes
+ *
+ * Description: Number of messages hashed at once, the SVE vector
+ *              length in 64-bit elements or 2 without SVE
+ *
+ * Returns a value in [2, KECCAKXN_MAX_LANES]
+ **************************************************/
+unsigned int keccakxN_lanes(void)
+{
+  return active_lanes;
+}
+
+/*************************************************
+ * Name:        keccakxN_select_kernel
+ *
+ * Description: Runs at load time: honours SHA3XN_KERNEL, otherwise
+ *              picks the first kernel supported by this CPU
+ **************************************************/
+__attribute__((constructor)) static void keccakxN_select_kernel(void)
+{
+  size_t i;
+  const char *env = getenv(KECCAKXN_KERNEL_ENV);
+
+  if (env != NULL && keccakxN_set_kernel(env) == 0)
+    return;
+
+  for (i = 0; i < NKERNELS; ++i)
+  {
+    if (kernels[i].supported())
+    {
+      active = &kernels[i];
+      active_lanes = active->lanes();
+      return;
+    }
+  }
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutexN
+ *
+ * Description: The Keccak F1600 Permutation on keccakxN_lanes() states,
+ *              runs the selected kernel
+ *
+ * Arguments:   - uint64_t *state: pointer to input/output Keccak states,
+ *                                 lane i of state l at state[i * n + l]
+ **************************************************/
+void KeccakF1600_StatePermutexN(uint64_t *state)
+{
+  active->permutexN(state);
+}
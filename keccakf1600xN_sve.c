@@ -0,0 +1,183 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#include <arm_sve.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "keccakf1600xN.h"
+#include "keccakf1600_rounds.h"
+
+/*
+ * SVE2 == 1 needs SVE2 and builds KeccakF1600_StatePermutexN_sve2,
+ * SVE2 == 0 builds the plain SVE KeccakF1600_StatePermutexN_sve.
+ * The Makefile compiles this file once for each.
+ */
+#ifndef SVE2
+#define SVE2 0
+#endif
+
+#if SVE2 == 1
+#define KECCAKXN_KERNEL(name) name##_sve2
+#else
+#define KECCAKXN_KERNEL(name) name##_sve
+#endif
+
+// Define SVE operation, one Keccak lane per 64-bit element
+
+// Bitwise-XOR: c = a ^ b
+#define zxor(c, a, b) c = sveor_u64_x(pg, a, b);
+
+#if SVE2 == 1
+
+// Xor chain: out = a ^ b ^ c ^ d ^ e
+#define zXOR5(out, a, b, c, d, e) \
+  out = sveor3_u64(a, b, c);      \
+  out = sveor3_u64(out, d, e);
+
+// Rotate left by 1 bit, then XOR: a ^ ROL(b), RAX1 needs SVE2-SHA3
+#define zRXOR(c, a, b) c = sveor_u64_x(pg, a, svxar_n_u64(b, zero, 63));
+
+// XOR then Rotate by n bit: c = ROL(a^b, 64 - n)
+#define zXORR(c, a, b, n) c = svxar_n_u64(a, b, n);
+
+// Xor Not And: out = a ^ ( (~b) & c)
+#define zXNA(out, a, b, c) out = svbcax_u64(a, c, b);
+
+#else
+
+// Rotate left by n bit
+#define zROL(out, a, offset)                       \
+  out = svorr_u64_x(pg, svlsl_n_u64_x(pg, a, (offset)), \
+                    svlsr_n_u64_x(pg, a, 64 - (offset)));
+
+// Xor chain: out = a ^ b ^ c ^ d ^ e
+#define zXOR5(out, a, b, c, d, e) \
+  out = sveor_u64_x(pg, a, b);    \
+  out = sveor_u64_x(pg, out, c);  \
+  out = sveor_u64_x(pg, out, d);  \
+  out = sveor_u64_x(pg, out, e);
+
+// Xor Not And: out = a ^ ( (~b) & c)
+#define zXNA(out, a, b, c) out = sveor_u64_x(pg, a, svbic_u64_x(pg, c, b));
+
+#define zRXOR(c, a, b) \
+  zROL(c, b, 1);       \
+  zxor(c, c, a);
+
+#define zXORR(c, a, b, n)       \
+  a = sveor_u64_x(pg, a, b);    \
+  zROL(c, a, 64 - n);
+
+#endif
+
+// Iota: xor round constant
+#define zIOTA(a, round) zxor(a, a, svdup_n_u64(KeccakF_RoundConstants[round]));
+
+// End
+
+#define zLOAD(X, i) X = svld1_u64(pg, &state[(i) * n]);
+#define zSTORE(X, i) svst1_u64(pg, &state[(i) * n], X);
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutexN_sve, KeccakF1600_StatePermutexN_sve2
+ *
+ * Description: The Keccak F1600 Permutation on svcntd() states at once
+ *
+ * Arguments:   - uint64_t *state: pointer to input/output Keccak states,
+ *                                 lane i of state l at state[i * svcntd() + l]
+ **************************************************/
+void KECCAKXN_KERNEL(KeccakF1600_StatePermutexN)(uint64_t *state)
+{
+  const svbool_t pg = svptrue_b64();
+  const uint64_t n = svcntd();
+#if SVE2 == 1
+  const svuint64_t zero = svdup_n_u64(0);
+#endif
+
+  DECLARE_LANES(svuint64_t, A)
+  DECLARE_LANES(svuint64_t, E)
+  DECLARE_ROW(svuint64_t, BC) // tmp
+  DECLARE_ROW(svuint64_t, D)
+
+  zLOAD(Aba, 0);
+  zLOAD(Abe, 1);
+  zLOAD(Abi, 2);
+  zLOAD(Abo, 3);
+  zLOAD(Abu, 4);
+  zLOAD(Aga, 5);
+  zLOAD(Age, 6);
+  zLOAD(Agi, 7);
+  zLOAD(Ago, 8);
+  zLOAD(Agu, 9);
+  zLOAD(Aka, 10);
+  zLOAD(Ake, 11);
+  zLOAD(Aki, 12);
+  zLOAD(Ako, 13);
+  zLOAD(Aku, 14);
+  zLOAD(Ama, 15);
+  zLOAD(Ame, 16);
+  zLOAD(Ami, 17);
+  zLOAD(Amo, 18);
+  zLOAD(Amu, 19);
+  zLOAD(Asa, 20);
+  zLOAD(Ase, 21);
+  zLOAD(Asi, 22);
+  zLOAD(Aso, 23);
+  zLOAD(Asu, 24);
+
+  for (int round = 0; round < NROUNDS; round += 2)
+  {
+    KECCAK_ROUND(z, A, E, BC, D, round)
+    KECCAK_ROUND(z, E, A, BC, D, round + 1)
+  }
+
+  zSTORE(Aba, 0);
+  zSTORE(Abe, 1);
+  zSTORE(Abi, 2);
+  zSTORE(Abo, 3);
+  zSTORE(Abu, 4);
+  zSTORE(Aga, 5);
+  zSTORE(Age, 6);
+  zSTORE(Agi, 7);
+  zSTORE(Ago, 8);
+  zSTORE(Agu, 9);
+  zSTORE(Aka, 10);
+  zSTORE(Ake, 11);
+  zSTORE(Aki, 12);
+  zSTORE(Ako, 13);
+  zSTORE(Aku, 14);
+  zSTORE(Ama, 15);
+  zSTORE(Ame, 16);
+  zSTORE(Ami, 17);
+  zSTORE(Amo, 18);
+  zSTORE(Amu, 19);
+  zSTORE(Asa, 20);
+  zSTORE(Ase, 21);
+  zSTORE(Asi, 22);
+  zSTORE(Aso, 23);
+  zSTORE(Asu, 24);
+}
+
+/*************************************************
+ * Name:        keccakxN_lanes_sve, keccakxN_lanes_sve2
+ *
+ * Description: Number of states handled by the kernel
+ *
+ * Returns svcntd(), the number of 64-bit elements in a vector
+ **************************************************/
+unsigned int KECCAKXN_KERNEL(keccakxN_lanes)(void)
+{
+  return (unsigned int)svcntd();
+}
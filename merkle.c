@@ -0,0 +1,360 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fips202.h"
+#include "fips202x2.h"
+#include "merkle.h"
+
+#define MERKLE_LEAF 0x00
+#define MERKLE_NODE 0x01
+
+/*************************************************
+ * Name:        merkle_hash
+ *
+ * Description: SHA3-256 of prefix || in
+ *
+ * Arguments:   - uint8_t *out: pointer to output (32 bytes)
+ *              - const uint8_t *in: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - uint8_t prefix: domain byte
+ **************************************************/
+static void merkle_hash(uint8_t out[MERKLE_BYTES],
+                        const uint8_t *in,
+                        size_t inlen,
+                        uint8_t prefix)
+{
+  keccak_inc_state state;
+
+  keccak_inc_init(&state);
+  keccak_inc_absorb(&state, SHA3_256_RATE, &prefix, 1);
+  keccak_inc_absorb(&state, SHA3_256_RATE, in, inlen);
+  keccak_inc_finalize(&state, SHA3_256_RATE, 0x06);
+  keccak_inc_squeeze(out, MERKLE_BYTES, &state, SHA3_256_RATE);
+}
+
+/*************************************************
+ * Name:        merkle_hash_x2
+ *
+ * Description: SHA3-256 of prefix || in0 and prefix || in1
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointers to outputs (32 bytes)
+ *              - const uint8_t *in0, *in1: pointers to inputs
+ *              - size_t inlen: length of each input in bytes
+ *              - uint8_t prefix: domain byte
+ **************************************************/
+static void merkle_hash_x2(uint8_t out0[MERKLE_BYTES],
+                           uint8_t out1[MERKLE_BYTES],
+                           const uint8_t *in0,
+                           const uint8_t *in1,
+                           size_t inlen,
+                           uint8_t prefix)
+{
+  unsigned int pos;
+  v128 s[25];
+
+  for (pos = 0; pos < 25; ++pos)
+    s[pos] = v128_zero();
+  pos = keccakx2_inc_absorb(s, 0, SHA3_256_RATE, &prefix, &prefix, 1);
+  pos = keccakx2_inc_absorb(s, pos, SHA3_256_RATE, in0, in1, inlen);
+  keccakx2_inc_finalize(s, pos, SHA3_256_RATE, 0x06);
+  keccakx2_squeeze(out0, out1, MERKLE_BYTES, SHA3_256_RATE, s);
+}
+
+/*************************************************
+ * Name:        merkle_hash_leaves
+ *
+ * Description: Hash n contiguous leaves, two at a time
+ *
+ * Arguments:   - uint8_t *out: pointer to n output nodes
+ *              - const uint8_t *leaves: pointer to n leaves
+ *              - size_t leaflen: length of each leaf in bytes
+ *              - size_t n: number of leaves
+ **************************************************/
+static void merkle_hash_leaves(uint8_t *out,
+                               const uint8_t *leaves,
+                               size_t leaflen,
+                               size_t n)
+{
+  size_t i;
+
+  for (i = 0; i + 2 <= n; i += 2)
+    merkle_hash_x2(out + i * MERKLE_BYTES, out + (i + 1) * MERKLE_BYTES,
+                   leaves + i * leaflen, leaves + (i + 1) * leaflen,
+                   leaflen, MERKLE_LEAF);
+  if (i < n)
+    merkle_hash(out + i * MERKLE_BYTES, leaves + i * leaflen, leaflen,
+                MERKLE_LEAF);
+}
+
+/*************************************************
+ * Name:        merkle_hash_level
+ *
+ * Description: Hash n nodes into the (n + 1) / 2 nodes of the next
+ *              level, two parents at a time; an odd last node is copied
+ *
+ * Arguments:   - uint8_t *out: pointer to the parents
+ *              - const uint8_t *in: pointer to n children
+ *              - size_t n: number of children
+ **************************************************/
+static void merkle_hash_level(uint8_t *out, const uint8_t *in, size_t n)
+{
+  size_t i;
+
+  // Siblings are adjacent: left || right is one 64-byte input
+  for (i = 0; i + 4 <= n; i += 4)
+    merkle_hash_x2(out + i / 2 * MERKLE_BYTES,
+                   out + (i / 2 + 1) * MERKLE_BYTES,
+                   in + i * MERKLE_BYTES, in + (i + 2) * MERKLE_BYTES,
+                   2 * MERKLE_BYTES, MERKLE_NODE);
+  if (i + 2 <= n)
+  {
+    merkle_hash(out + i / 2 * MERKLE_BYTES, in + i * MERKLE_BYTES,
+                2 * MERKLE_BYTES, MERKLE_NODE);
+    i += 2;
+  }
+  if (i < n)
+    memcpy(out + i / 2 * MERKLE_BYTES, in + i * MERKLE_BYTES, MERKLE_BYTES);
+}
+
+/*************************************************
+ * Name:        merkle_node
+ *
+ * Description: Pointer to node i of level l
+ **************************************************/
+static uint8_t *merkle_node(const merkle_tree *tree, unsigned int l, size_t i)
+{
+  return tree->nodes + (tree->level[l] + i) * MERKLE_BYTES;
+}
+
+typedef struct {
+  merkle_tree *tree;
+  const uint8_t *leaves;
+  size_t leaflen;
+  unsigned int height;
+} merkle_job;
+
+/*************************************************
+ * Name:        merkle_subtree
+ *
+ * Description: Build the lowest job->height levels above subtree i,
+ *              which covers leaves i * 2^height onwards. Subtrees are
+ *              aligned, so each one writes its own range of every level.
+ *
+ * Arguments:   - void *arg: pointer to the merkle_job
+ *              - size_t i: index of the subtree
+ **************************************************/
+static void merkle_subtree(void *arg, size_t i)
+{
+  const merkle_job *job = (const merkle_job *)arg;
+  const size_t first = i << job->height;
+  size_t n = job->tree->nleaves - first;
+  unsigned int l;
+
+  if (n > (size_t)1 << job->height)
+    n = (size_t)1 << job->height;
+
+  merkle_hash_leaves(merkle_node(job->tree, 0, first),
+                     job->leaves + first * job->leaflen, job->leaflen, n);
+  for (l = 0; l < job->height; ++l)
+  {
+    merkle_hash_level(merkle_node(job->tree, l + 1, first >> (l + 1)),
+                      merkle_node(job->tree, l, first >> l), n);
+    n = (n + 1) / 2;
+  }
+}
+
+/*************************************************
+ * Name:        merkle_tree_build
+ *
+ * Description: Build all levels of the tree over nleaves contiguous
+ *              leaves. Subtrees of 2^MERKLE_SUBTREE_HEIGHT leaves are
+ *              built depth first so their levels stay in cache, on the
+ *              pool if one is given; the levels above them follow on
+ *              the calling thread.
+ *
+ * Arguments:   - merkle_tree *tree: pointer to the output tree
+ *              - const uint8_t *leaves: pointer to nleaves leaves
+ *              - size_t leaflen: length of each leaf in bytes
+ *              - size_t nleaves: number of leaves
+ *              - keccak_pool *pool: pointer to a pool, or NULL
+ *
+ * Returns 0, or -1 if nleaves is 0 or out of memory
+ **************************************************/
+int merkle_tree_build(merkle_tree *tree,
+                      const uint8_t *leaves,
+                      size_t leaflen,
+                      size_t nleaves,
+                      keccak_pool *pool)
+{
+  unsigned int l;
+  size_t n, nsub;
+  merkle_job job;
+
+  tree->nodes = NULL;
+  if (nleaves == 0)
+    return -1;
+
+  tree->nleaves = nleaves;
+  tree->level[0] = 0;
+  for (l = 0, n = nleaves; n > 1; n = (n + 1) / 2)
+  {
+    tree->level[l + 1] = tree->level[l] + n;
+    l++;
+  }
+  tree->level[l + 1] = tree->level[l] + 1;
+  tree->nlevels = l + 1;
+
+  tree->nodes = (uint8_t *)malloc(tree->level[l + 1] * MERKLE_BYTES);
+  if (tree->nodes == NULL)
+    return -1;
+
+  job.tree = tree;
+  job.leaves = leaves;
+  job.leaflen = leaflen;
+  job.height = tree->nlevels - 1;
+  if (job.height > MERKLE_SUBTREE_HEIGHT)
+    job.height = MERKLE_SUBTREE_HEIGHT;
+
+  nsub = ((nleaves - 1) >> job.height) + 1;
+  if (pool != NULL && nsub > 1)
+    keccak_pool_for(pool, merkle_subtree, &job, nsub);
+  else
+    for (n = 0; n < nsub; ++n)
+      merkle_subtree(&job, n);
+
+  for (l = job.height; l + 1 < tree->nlevels; ++l)
+    merkle_hash_level(merkle_node(tree, l + 1, 0), merkle_node(tree, l, 0),
+                      tree->level[l + 1] - tree->level[l]);
+
+  return 0;
+}
+
+/*************************************************
+ * Name:        merkle_tree_free
+ *
+ * Description: Free the levels of a tree
+ *
+ * Arguments:   - merkle_tree *tree: pointer to the tree
+ **************************************************/
+void merkle_tree_free(merkle_tree *tree)
+{
+  free(tree->nodes);
+  tree->nodes = NULL;
+}
+
+/*************************************************
+ * Name:        merkle_root
+ *
+ * Description: Root of a tree, the only node of the last level
+ *
+ * Arguments:   - const merkle_tree *tree: pointer to the tree
+ *
+ * Returns pointer to the root (32 bytes)
+ **************************************************/
+const uint8_t *merkle_root(const merkle_tree *tree)
+{
+  return merkle_node(tree, tree->nlevels - 1, 0);
+}
+
+/*************************************************
+ * Name:        merkle_proof
+ *
+ * Description: Inclusion proof of a leaf: its sibling on each level
+ *              from the leaves up. Levels where the node was promoted
+ *              have no sibling and add nothing.
+ *
+ * Arguments:   - uint8_t *proof: pointer to output, room for
+ *                                nlevels - 1 hashes
+ *              - const merkle_tree *tree: pointer to the tree
+ *              - size_t index: index of the leaf, below nleaves
+ *
+ * Returns the number of hashes written
+ **************************************************/
+size_t merkle_proof(uint8_t *proof, const merkle_tree *tree, size_t index)
+{
+  unsigned int l;
+  size_t nproof = 0;
+
+  for (l = 0; l + 1 < tree->nlevels; ++l)
+  {
+    if ((index ^ 1) < tree->level[l + 1] - tree->level[l])
+    {
+      memcpy(proof + nproof * MERKLE_BYTES, merkle_node(tree, l, index ^ 1),
+             MERKLE_BYTES);
+      nproof++;
+    }
+    index >>= 1;
+  }
+
+  return nproof;
+}
+
+/*************************************************
+ * Name:        merkle_verify
+ *
+ * Description: Recompute the root from a leaf and its inclusion proof
+ *
+ * Arguments:   - const uint8_t *root: pointer to the expected root
+ *              - const uint8_t *leaf: pointer to the leaf
+ *              - size_t leaflen: length of the leaf in bytes
+ *              - size_t index: index of the leaf
+ *              - size_t nleaves: number of leaves in the tree
+ *              - const uint8_t *proof: pointer to nproof hashes
+ *              - size_t nproof: number of hashes in proof
+ *
+ * Returns 0 if the root matches, -1 otherwise
+ **************************************************/
+int merkle_verify(const uint8_t root[MERKLE_BYTES],
+                  const uint8_t *leaf,
+                  size_t leaflen,
+                  size_t index,
+                  size_t nleaves,
+                  const uint8_t *proof,
+                  size_t nproof)
+{
+  uint8_t buf[2 * MERKLE_BYTES];
+  size_t k = 0;
+
+  if (index >= nleaves)
+    return -1;
+
+  merkle_hash(buf, leaf, leaflen, MERKLE_LEAF);
+  for (; nleaves > 1; nleaves = (nleaves + 1) / 2)
+  {
+    if ((index ^ 1) < nleaves)
+    {
+      if (k == nproof)
+        return -1;
+      if (index & 1)
+      {
+        memcpy(buf + MERKLE_BYTES, buf, MERKLE_BYTES);
+        memcpy(buf, proof + k * MERKLE_BYTES, MERKLE_BYTES);
+      }
+      else
+        memcpy(buf + MERKLE_BYTES, proof + k * MERKLE_BYTES, MERKLE_BYTES);
+      merkle_hash(buf, buf, 2 * MERKLE_BYTES, MERKLE_NODE);
+      k++;
+    }
+    index >>= 1;
+  }
+
+  if (k != nproof || memcmp(buf, root, MERKLE_BYTES) != 0)
+    return -1;
+  return 0;
+}
@@ -0,0 +1,72 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#ifndef MERKLE_H
+#define MERKLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "fips202pool.h"
+
+/*
+ * Binary Merkle tree over fixed-size leaves with SHA3-256:
+ * leaf = H(0x00 || data), node = H(0x01 || left || right), an odd last
+ * node is promoted to the next level unchanged. Leaves and each level
+ * are hashed two at a time on the x2 permutation; every level is one
+ * contiguous array, leaves first and the root last.
+ */
+#define MERKLE_BYTES 32
+#define MERKLE_MAX_LEVELS 65
+#define MERKLE_SUBTREE_HEIGHT 12
+
+typedef struct {
+  uint8_t *nodes;
+  size_t nleaves;
+  unsigned int nlevels;
+  // Index of the first node of each level, level[nlevels] is the total
+  size_t level[MERKLE_MAX_LEVELS + 1];
+} merkle_tree;
+
+/*
+ * pool may be NULL; otherwise subtrees of 2^MERKLE_SUBTREE_HEIGHT leaves
+ * are spread over its workers. Returns 0, or -1 if nleaves is 0 or out of
+ * memory
+ */
+int merkle_tree_build(merkle_tree *tree,
+                      const uint8_t *leaves,
+                      size_t leaflen,
+                      size_t nleaves,
+                      keccak_pool *pool);
+
+void merkle_tree_free(merkle_tree *tree);
+
+const uint8_t *merkle_root(const merkle_tree *tree);
+
+/*
+ * Writes the siblings from the leaf level up, at most nlevels - 1 hashes.
+ * Returns the number of hashes
+ */
+size_t merkle_proof(uint8_t *proof, const merkle_tree *tree, size_t index);
+
+// Returns 0 if leaf is at index in the tree with this root, -1 otherwise
+int merkle_verify(const uint8_t root[MERKLE_BYTES],
+                  const uint8_t *leaf,
+                  size_t leaflen,
+                  size_t index,
+                  size_t nleaves,
+                  const uint8_t *proof,
+                  size_t nproof);
+
+#endif
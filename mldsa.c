@@ -0,0 +1,514 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "fips202.h"
+#include "fips202x2.h"
+#include "mldsa.h"
+
+/*************************************************
+ * Name:        rej_uniform_words
+ *
+ * Description: RejNTTPoly on 24 bytes of SHAKE128 output, three state
+ *              words realigned into four 48-bit groups: 8 candidates of
+ *              24 bits with the top bit cleared, each stored
+ *              unconditionally and kept if below q
+ *
+ * Arguments:   - int32_t *r: pointer to output polynomial
+ *              - unsigned int ctr: number of coefficients already sampled
+ *              - const uint64_t *q: two candidates in the low 48 bits
+ *                                   of each
+ *
+ * Returns the new number of sampled coefficients
+ **************************************************/
+static unsigned int rej_uniform_words(int32_t *r,
+                                      unsigned int ctr,
+                                      const uint64_t q[4])
+{
+  unsigned int j;
+  uint64_t t;
+
+  if (ctr + 8 <= MLDSA_N)
+  {
+    for (j = 0; j < 8; ++j)
+    {
+      t = (q[j / 2] >> 24 * (j % 2)) & 0x7FFFFF;
+      r[ctr] = (int32_t)t;
+      ctr += t < MLDSA_Q;
+    }
+  }
+  else
+  {
+    for (j = 0; j < 8; ++j)
+    {
+      t = (q[j / 2] >> 24 * (j % 2)) & 0x7FFFFF;
+      if (t < MLDSA_Q && ctr < MLDSA_N)
+        r[ctr++] = (int32_t)t;
+    }
+  }
+
+  return ctr;
+}
+
+/*************************************************
+ * Name:        rej_eta_word
+ *
+ * Description: RejBoundedPoly on one state word: 16 4-bit candidates,
+ *              low nibble first, kept if below 15 (eta = 2) or 9
+ *              (eta = 4)
+ *
+ * Arguments:   - int32_t *r: pointer to output polynomial
+ *              - unsigned int ctr: number of coefficients already sampled
+ *              - uint64_t w: state word, little-endian
+ *              - unsigned int eta: 2 or 4
+ *
+ * Returns the new number of sampled coefficients
+ **************************************************/
+static unsigned int rej_eta_word(int32_t *r,
+                                 unsigned int ctr,
+                                 uint64_t w,
+                                 unsigned int eta)
+{
+  unsigned int j, z;
+
+  if (ctr + 16 <= MLDSA_N && eta == 2)
+  {
+    for (j = 0; j < 16; ++j)
+    {
+      z = (w >> 4 * j) & 15;
+      // 2 - z mod 5
+      r[ctr] = 2 - (int32_t)(z - (205 * z >> 10) * 5);
+      ctr += z < 15;
+    }
+  }
+  else if (ctr + 16 <= MLDSA_N)
+  {
+    for (j = 0; j < 16; ++j)
+    {
+      z = (w >> 4 * j) & 15;
+      r[ctr] = 4 - (int32_t)z;
+      ctr += z < 9;
+    }
+  }
+  else
+  {
+    for (j = 0; j < 16 && ctr < MLDSA_N; ++j)
+    {
+      z = (w >> 4 * j) & 15;
+      if (eta == 2 && z < 15)
+        r[ctr++] = 2 - (int32_t)(z - (205 * z >> 10) * 5);
+      else if (eta == 4 && z < 9)
+        r[ctr++] = 4 - (int32_t)z;
+    }
+  }
+
+  return ctr;
+}
+
+/*************************************************
+ * Name:        mldsa_seed
+ *
+ * Description: Seed || 2-byte little-endian nonce, the XOF input of all
+ *              three samplers
+ *
+ * Arguments:   - uint8_t *in: pointer to output (seedlen + 2 bytes)
+ *              - const uint8_t *seed: pointer to seed
+ *              - size_t seedlen: length of seed in bytes
+ *              - uint16_t nonce: nonce
+ **************************************************/
+static void mldsa_seed(uint8_t *in,
+                       const uint8_t *seed,
+                       size_t seedlen,
+                       uint16_t nonce)
+{
+  memcpy(in, seed, seedlen);
+  in[seedlen + 0] = (uint8_t)nonce;
+  in[seedlen + 1] = (uint8_t)(nonce >> 8);
+}
+
+/*************************************************
+ * Name:        mldsa_poly_uniform
+ *
+ * Description: RejNTTPoly of FIPS 204, one entry of ExpandA, parsing
+ *              each squeezed block straight from the state
+ *
+ * Arguments:   - int32_t *r: pointer to output polynomial
+ *              - const uint8_t *rho: seed (32 bytes)
+ *              - uint16_t nonce: 256 * i + j for entry (i, j)
+ **************************************************/
+void mldsa_poly_uniform(int32_t r[MLDSA_N],
+                        const uint8_t rho[MLDSA_SEEDBYTES],
+                        uint16_t nonce)
+{
+  unsigned int i, ctr = 0;
+  uint8_t in[MLDSA_SEEDBYTES + 2];
+  uint64_t q[4];
+  keccak_state state;
+
+  mldsa_seed(in, rho, MLDSA_SEEDBYTES, nonce);
+  shake128_absorb(&state, in, sizeof(in));
+
+  while (ctr < MLDSA_N)
+  {
+    KeccakF1600_StatePermute(state.s);
+    for (i = 0; i < SHAKE128_RATE / 8 && ctr < MLDSA_N; i += 3)
+    {
+      q[0] = state.s[i];
+      q[1] = state.s[i] >> 48 | state.s[i + 1] << 16;
+      q[2] = state.s[i + 1] >> 32 | state.s[i + 2] << 32;
+      q[3] = state.s[i + 2] >> 16;
+      ctr = rej_uniform_words(r, ctr, q);
+    }
+  }
+}
+
+/*************************************************
+ * Name:        mldsa_poly_uniform_x2
+ *
+ * Description: RejNTTPoly of FIPS 204 on two nonces; each permutation
+ *              feeds both polynomials, and blocks are squeezed until
+ *              both are full. The 48-bit groups of both lanes are
+ *              realigned in one v128 each, the rejection runs per lane.
+ *
+ * Arguments:   - int32_t *r0, *r1: pointer to output polynomials
+ *              - const uint8_t *rho: seed (32 bytes)
+ *              - uint16_t nonce0, nonce1: 256 * i + j for entry (i, j)
+ **************************************************/
+void mldsa_poly_uniform_x2(int32_t r0[MLDSA_N],
+                           int32_t r1[MLDSA_N],
+                           const uint8_t rho[MLDSA_SEEDBYTES],
+                           uint16_t nonce0,
+                           uint16_t nonce1)
+{
+  unsigned int i, j, ctr0 = 0, ctr1 = 0;
+  uint8_t in[2][MLDSA_SEEDBYTES + 2];
+  uint64_t q0[4], q1[4];
+  v128 s[25], q[4];
+
+  mldsa_seed(in[0], rho, MLDSA_SEEDBYTES, nonce0);
+  mldsa_seed(in[1], rho, MLDSA_SEEDBYTES, nonce1);
+  keccakx2_absorb(s, SHAKE128_RATE, in[0], in[1], sizeof(in[0]), 0x1F);
+
+  while (ctr0 < MLDSA_N || ctr1 < MLDSA_N)
+  {
+    KeccakF1600_StatePermutex2(s);
+    for (i = 0; i < SHAKE128_RATE / 8; i += 3)
+    {
+      q[0] = s[i];
+      q[1] = v128_or(v128_shr(s[i], 48), v128_shl(s[i + 1], 16));
+      q[2] = v128_or(v128_shr(s[i + 1], 32), v128_shl(s[i + 2], 32));
+      q[3] = v128_shr(s[i + 2], 16);
+      for (j = 0; j < 4; ++j)
+      {
+        q0[j] = v128_lane0(q[j]);
+        q1[j] = v128_lane1(q[j]);
+      }
+      if (ctr0 < MLDSA_N)
+        ctr0 = rej_uniform_words(r0, ctr0, q0);
+      if (ctr1 < MLDSA_N)
+        ctr1 = rej_uniform_words(r1, ctr1, q1);
+    }
+  }
+}
+
+/*************************************************
+ * Name:        mldsa_poly_uniform_eta
+ *
+ * Description: RejBoundedPoly of FIPS 204, one polynomial of ExpandS,
+ *              parsing each squeezed block straight from the state
+ *
+ * Arguments:   - int32_t *r: pointer to output polynomial
+ *              - const uint8_t *rhoprime: seed (64 bytes)
+ *              - uint16_t nonce: index of the polynomial in s1 || s2
+ *              - unsigned int eta: 2 or 4
+ *
+ * Returns 0 on success, -1 if eta is neither 2 nor 4
+ **************************************************/
+int mldsa_poly_uniform_eta(int32_t r[MLDSA_N],
+                           const uint8_t rhoprime[MLDSA_CRHBYTES],
+                           uint16_t nonce,
+                           unsigned int eta)
+{
+  unsigned int i, ctr = 0;
+  uint8_t in[MLDSA_CRHBYTES + 2];
+  keccak_state state;
+
+  if (eta != 2 && eta != 4)
+    return -1;
+
+  mldsa_seed(in, rhoprime, MLDSA_CRHBYTES, nonce);
+  shake256_absorb(&state, in, sizeof(in));
+
+  while (ctr < MLDSA_N)
+  {
+    KeccakF1600_StatePermute(state.s);
+    for (i = 0; i < SHAKE256_RATE / 8 && ctr < MLDSA_N; ++i)
+      ctr = rej_eta_word(r, ctr, state.s[i], eta);
+  }
+  return 0;
+}
+
+/*************************************************
+ * Name:        mldsa_poly_uniform_eta_x2
+ *
+ * Description: RejBoundedPoly of FIPS 204 on two nonces, parsing both
+ *              lanes of each squeezed block straight from the state
+ *
+ * Arguments:   - int32_t *r0, *r1: pointer to output polynomials
+ *              - const uint8_t *rhoprime: seed (64 bytes)
+ *              - uint16_t nonce0, nonce1: index of the polynomials
+ *              - unsigned int eta: 2 or 4
+ *
+ * Returns 0 on success, -1 if eta is neither 2 nor 4
+ **************************************************/
+int mldsa_poly_uniform_eta_x2(int32_t r0[MLDSA_N],
+                              int32_t r1[MLDSA_N],
+                              const uint8_t rhoprime[MLDSA_CRHBYTES],
+                              uint16_t nonce0,
+                              uint16_t nonce1,
+                              unsigned int eta)
+{
+  unsigned int i, ctr0 = 0, ctr1 = 0;
+  uint8_t in[2][MLDSA_CRHBYTES + 2];
+  v128 s[25];
+
+  if (eta != 2 && eta != 4)
+    return -1;
+
+  mldsa_seed(in[0], rhoprime, MLDSA_CRHBYTES, nonce0);
+  mldsa_seed(in[1], rhoprime, MLDSA_CRHBYTES, nonce1);
+  keccakx2_absorb(s, SHAKE256_RATE, in[0], in[1], sizeof(in[0]), 0x1F);
+
+  while (ctr0 < MLDSA_N || ctr1 < MLDSA_N)
+  {
+    KeccakF1600_StatePermutex2(s);
+    for (i = 0; i < SHAKE256_RATE / 8; ++i)
+    {
+      if (ctr0 < MLDSA_N)
+        ctr0 = rej_eta_word(r0, ctr0, v128_lane0(s[i]), eta);
+      if (ctr1 < MLDSA_N)
+        ctr1 = rej_eta_word(r1, ctr1, v128_lane1(s[i]), eta);
+    }
+  }
+  return 0;
+}
+
+/*************************************************
+ * Name:        mldsa_poly_uniform_gamma1
+ *
+ * Description: One polynomial of ExpandMask of FIPS 204: BitUnpack of
+ *              18-bit (gamma1 = 2^17) or 20-bit (gamma1 = 2^19)
+ *              little-endian fields, read straight from the state words
+ *              of each squeezed block
+ *
+ * Arguments:   - int32_t *r: pointer to output polynomial
+ *              - const uint8_t *rhoprime: seed (64 bytes)
+ *              - uint16_t nonce: kappa + index of the polynomial
+ *              - int32_t gamma1: 2^17 or 2^19
+ **************************************************/
+void mldsa_poly_uniform_gamma1(int32_t r[MLDSA_N],
+                               const uint8_t rhoprime[MLDSA_CRHBYTES],
+                               uint16_t nonce,
+                               int32_t gamma1)
+{
+  unsigned int i, k, sh, bits = gamma1 == (1 << 17) ? 18 : 20;
+  size_t o, base;
+  uint8_t in[MLDSA_CRHBYTES + 2];
+  uint64_t carry = 0, lo, t, mask = (1U << bits) - 1;
+  keccak_state state;
+
+  mldsa_seed(in, rhoprime, MLDSA_CRHBYTES, nonce);
+  shake256_absorb(&state, in, sizeof(in));
+
+  // base: bit offset of state word 0 in the output stream
+  for (i = 0, base = 0; i < MLDSA_N; base += 8 * SHAKE256_RATE)
+  {
+    KeccakF1600_StatePermute(state.s);
+    // Fields ending in this block, the first may start in carry
+    for (; i < MLDSA_N && bits * (i + 1) <= base + 8 * SHAKE256_RATE; ++i)
+    {
+      o = bits * i + 64 - base;
+      k = (unsigned int)(o / 64);
+      sh = (unsigned int)(o % 64);
+      lo = k == 0 ? carry : state.s[k - 1];
+      // Bits of state.s[k] land above the field unless it straddles,
+      // two shifts keep the count below 64 for sh = 0
+      t = lo >> sh | (state.s[k] << 1) << (63 - sh);
+      r[i] = gamma1 - (int32_t)(t & mask);
+    }
+    carry = state.s[SHAKE256_RATE / 8 - 1];
+  }
+}
+
+/*************************************************
+ * Name:        mldsa_poly_uniform_gamma1_x2
+ *
+ * Description: Two polynomials of ExpandMask of FIPS 204. The fields sit
+ *              at the same offsets in both lanes, so each one is
+ *              shifted and masked out of the state for both at once.
+ *
+ * Arguments:   - int32_t *r0, *r1: pointer to output polynomials
+ *              - const uint8_t *rhoprime: seed (64 bytes)
+ *              - uint16_t nonce0, nonce1: kappa + index of the polynomials
+ *              - int32_t gamma1: 2^17 or 2^19
+ **************************************************/
+void mldsa_poly_uniform_gamma1_x2(int32_t r0[MLDSA_N],
+                                  int32_t r1[MLDSA_N],
+                                  const uint8_t rhoprime[MLDSA_CRHBYTES],
+                                  uint16_t nonce0,
+                                  uint16_t nonce1,
+                                  int32_t gamma1)
+{
+  unsigned int i, j, k, sh, bits = gamma1 == (1 << 17) ? 18 : 20;
+  size_t o, base;
+  uint8_t in[2][MLDSA_CRHBYTES + 2];
+  uint64_t w;
+  v128 s[25], carry = v128_zero(), lo, t[2];
+  v128 mask = v128_dup((1U << bits) - 1), g = v128_dup((uint64_t)gamma1);
+
+  mldsa_seed(in[0], rhoprime, MLDSA_CRHBYTES, nonce0);
+  mldsa_seed(in[1], rhoprime, MLDSA_CRHBYTES, nonce1);
+  keccakx2_absorb(s, SHAKE256_RATE, in[0], in[1], sizeof(in[0]), 0x1F);
+
+  // base: bit offset of state word 0 in the output stream
+  for (i = 0, base = 0; i < MLDSA_N; base += 8 * SHAKE256_RATE)
+  {
+    KeccakF1600_StatePermutex2(s);
+    // Field pairs ending in this block, the first may start in carry
+    for (; i < MLDSA_N && bits * (i + 2) <= base + 8 * SHAKE256_RATE; i += 2)
+    {
+      for (j = 0; j < 2; ++j)
+      {
+        o = bits * (i + j) + 64 - base;
+        k = (unsigned int)(o / 64);
+        sh = (unsigned int)(o % 64);
+        lo = k == 0 ? carry : s[k - 1];
+        // Bits of s[k] land above the field unless it straddles,
+        // two shifts keep the count below 64 for sh = 0
+        t[j] = v128_or(v128_shr(lo, sh), v128_shl(v128_shl(s[k], 1), 63 - sh));
+        t[j] = v128_sub(g, v128_and(t[j], mask));
+      }
+      // Coefficients i and i + 1 of each lane in one 64-bit word
+      t[0] = v128_or(v128_and(t[0], v128_dup(0xFFFFFFFF)), v128_shl(t[1], 32));
+      w = v128_lane0(t[0]);
+      r0[i] = (int32_t)(uint32_t)w;
+      r0[i + 1] = (int32_t)(uint32_t)(w >> 32);
+      w = v128_lane1(t[0]);
+      r1[i] = (int32_t)(uint32_t)w;
+      r1[i + 1] = (int32_t)(uint32_t)(w >> 32);
+    }
+    carry = s[SHAKE256_RATE / 8 - 1];
+  }
+}
+
+/*************************************************
+ * Name:        mldsa_expand_a
+ *
+ * Description: ExpandA of FIPS 204, two entries per call
+ *
+ * Arguments:   - int32_t *a: pointer to output, k * l polynomials
+ *              - const uint8_t *rho: seed (32 bytes)
+ *              - unsigned int k, l: matrix dimensions
+ **************************************************/
+void mldsa_expand_a(int32_t *a,
+                    const uint8_t rho[MLDSA_SEEDBYTES],
+                    unsigned int k,
+                    unsigned int l)
+{
+  unsigned int n;
+
+  for (n = 0; n + 2 <= k * l; n += 2)
+    mldsa_poly_uniform_x2(&a[n * MLDSA_N], &a[(n + 1) * MLDSA_N], rho,
+                          (uint16_t)((n / l) << 8 | n % l),
+                          (uint16_t)(((n + 1) / l) << 8 | (n + 1) % l));
+
+  if (n < k * l)
+    mldsa_poly_uniform(&a[n * MLDSA_N], rho,
+                       (uint16_t)((n / l) << 8 | n % l));
+}
+
+/*************************************************
+ * Name:        mldsa_expand_s
+ *
+ * Description: ExpandS of FIPS 204, two polynomials per call, pairs may
+ *              span s1 and s2
+ *
+ * Arguments:   - int32_t *s1: pointer to output, l polynomials
+ *              - int32_t *s2: pointer to output, k polynomials
+ *              - const uint8_t *rhoprime: seed (64 bytes)
+ *              - unsigned int l, k: vector lengths
+ *              - unsigned int eta: 2 or 4
+ *
+ * Returns 0 on success, -1 if eta is neither 2 nor 4
+ **************************************************/
+int mldsa_expand_s(int32_t *s1,
+                   int32_t *s2,
+                   const uint8_t rhoprime[MLDSA_CRHBYTES],
+                   unsigned int l,
+                   unsigned int k,
+                   unsigned int eta)
+{
+  unsigned int n;
+  int32_t *r0, *r1;
+
+  if (eta != 2 && eta != 4)
+    return -1;
+
+  for (n = 0; n + 2 <= l + k; n += 2)
+  {
+    r0 = n < l ? &s1[n * MLDSA_N] : &s2[(n - l) * MLDSA_N];
+    r1 = n + 1 < l ? &s1[(n + 1) * MLDSA_N] : &s2[(n + 1 - l) * MLDSA_N];
+    mldsa_poly_uniform_eta_x2(r0, r1, rhoprime, (uint16_t)n,
+                              (uint16_t)(n + 1), eta);
+  }
+
+  if (n < l + k)
+  {
+    r0 = n < l ? &s1[n * MLDSA_N] : &s2[(n - l) * MLDSA_N];
+    mldsa_poly_uniform_eta(r0, rhoprime, (uint16_t)n, eta);
+  }
+  return 0;
+}
+
+/*************************************************
+ * Name:        mldsa_expand_mask
+ *
+ * Description: ExpandMask of FIPS 204, two polynomials per call
+ *
+ * Arguments:   - int32_t *y: pointer to output, l polynomials
+ *              - const uint8_t *rhoprime: seed (64 bytes)
+ *              - uint16_t kappa: nonce of the first polynomial
+ *              - unsigned int l: vector length
+ *              - int32_t gamma1: 2^17 or 2^19
+ **************************************************/
+void mldsa_expand_mask(int32_t *y,
+                       const uint8_t rhoprime[MLDSA_CRHBYTES],
+                       uint16_t kappa,
+                       unsigned int l,
+                       int32_t gamma1)
+{
+  unsigned int n;
+
+  for (n = 0; n + 2 <= l; n += 2)
+    mldsa_poly_uniform_gamma1_x2(&y[n * MLDSA_N], &y[(n + 1) * MLDSA_N],
+                                 rhoprime, (uint16_t)(kappa + n),
+                                 (uint16_t)(kappa + n + 1), gamma1);
+
+  if (n < l)
+    mldsa_poly_uniform_gamma1(&y[n * MLDSA_N], rhoprime,
+                              (uint16_t)(kappa + n), gamma1);
+}
@@ -0,0 +1,95 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#ifndef MLDSA_H
+#define MLDSA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * ML-DSA (FIPS 204) samplers, two polynomials per call on the x2
+ * permutation: ExpandA (RejNTTPoly, SHAKE128), ExpandS (RejBoundedPoly,
+ * SHAKE256) and ExpandMask (SHAKE256 and BitUnpack). Each squeezed block
+ * is parsed straight from the state. The single-polynomial versions run
+ * on fips202.c and fill the odd polynomial of a vector.
+ */
+#define MLDSA_N 256
+#define MLDSA_Q 8380417
+#define MLDSA_SEEDBYTES 32
+#define MLDSA_CRHBYTES 64
+
+// ExpandA entry (i, j): seed rho, nonce = 256 * i + j
+void mldsa_poly_uniform(int32_t r[MLDSA_N],
+                        const uint8_t rho[MLDSA_SEEDBYTES],
+                        uint16_t nonce);
+
+void mldsa_poly_uniform_x2(int32_t r0[MLDSA_N],
+                           int32_t r1[MLDSA_N],
+                           const uint8_t rho[MLDSA_SEEDBYTES],
+                           uint16_t nonce0,
+                           uint16_t nonce1);
+
+// ExpandS: eta = 2 or 4, coefficients in [-eta, eta]; -1 for any other eta
+int mldsa_poly_uniform_eta(int32_t r[MLDSA_N],
+                           const uint8_t rhoprime[MLDSA_CRHBYTES],
+                           uint16_t nonce,
+                           unsigned int eta);
+
+int mldsa_poly_uniform_eta_x2(int32_t r0[MLDSA_N],
+                              int32_t r1[MLDSA_N],
+                              const uint8_t rhoprime[MLDSA_CRHBYTES],
+                              uint16_t nonce0,
+                              uint16_t nonce1,
+                              unsigned int eta);
+
+// ExpandMask: gamma1 = 2^17 or 2^19, coefficients in (-gamma1, gamma1]
+void mldsa_poly_uniform_gamma1(int32_t r[MLDSA_N],
+                               const uint8_t rhoprime[MLDSA_CRHBYTES],
+                               uint16_t nonce,
+                               int32_t gamma1);
+
+void mldsa_poly_uniform_gamma1_x2(int32_t r0[MLDSA_N],
+                                  int32_t r1[MLDSA_N],
+                                  const uint8_t rhoprime[MLDSA_CRHBYTES],
+                                  uint16_t nonce0,
+                                  uint16_t nonce1,
+                                  int32_t gamma1);
+
+/*
+ * Whole vectors and matrices, polynomials stored one after the other:
+ * a: k * l polynomials, row-major
+ * s1: l polynomials with nonces 0 to l - 1, s2: k with nonces l to l + k - 1
+ * y: l polynomials with nonces kappa to kappa + l - 1
+ */
+void mldsa_expand_a(int32_t *a,
+                    const uint8_t rho[MLDSA_SEEDBYTES],
+                    unsigned int k,
+                    unsigned int l);
+
+int mldsa_expand_s(int32_t *s1,
+                   int32_t *s2,
+                   const uint8_t rhoprime[MLDSA_CRHBYTES],
+                   unsigned int l,
+                   unsigned int k,
+                   unsigned int eta);
+
+void mldsa_expand_mask(int32_t *y,
+                       const uint8_t rhoprime[MLDSA_CRHBYTES],
+                       uint16_t kappa,
+                       unsigned int l,
+                       int32_t gamma1);
+
+#endif
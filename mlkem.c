@@ -0,0 +1,175 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "fips202.h"
+#include "fips202x2.h"
+#include "mlkem.h"
+
+/*************************************************
+ * Name:        rej_uniform_words
+ *
+ * Description: Rejection sampling on 24 bytes of SHAKE128 output, given
+ *              as three state words: 16 candidates of 12 bits, each
+ *              stored unconditionally and kept if below q
+ *
+ * Arguments:   - int16_t *r: pointer to output polynomial
+ *              - unsigned int ctr: number of coefficients already sampled
+ *              - uint64_t w0, w1, w2: state words, little-endian
+ *
+ * Returns the new number of sampled coefficients
+ **************************************************/
+static unsigned int rej_uniform_words(int16_t *r,
+                                      unsigned int ctr,
+                                      uint64_t w0,
+                                      uint64_t w1,
+                                      uint64_t w2)
+{
+  unsigned int i, j;
+  uint64_t q[4], d;
+
+  // Four candidates in the low 48 bits of each
+  q[0] = w0;
+  q[1] = w0 >> 48 | w1 << 16;
+  q[2] = w1 >> 32 | w2 << 32;
+  q[3] = w2 >> 16;
+
+  if (ctr + 16 <= MLKEM_N)
+  {
+    for (i = 0; i < 4; ++i)
+      for (j = 0; j < 4; ++j)
+      {
+        d = (q[i] >> 12 * j) & 0xFFF;
+        r[ctr] = (int16_t)d;
+        ctr += d < MLKEM_Q;
+      }
+  }
+  else
+  {
+    for (i = 0; i < 4; ++i)
+      for (j = 0; j < 4; ++j)
+      {
+        d = (q[i] >> 12 * j) & 0xFFF;
+        if (d < MLKEM_Q && ctr < MLKEM_N)
+          r[ctr++] = (int16_t)d;
+      }
+  }
+
+  return ctr;
+}
+
+/*************************************************
+ * Name:        mlkem_sample_ntt
+ *
+ * Description: SampleNTT of FIPS 203 on one seed, parsing each squeezed
+ *              block straight from the state
+ *
+ * Arguments:   - int16_t *r: pointer to output polynomial
+ *              - const uint8_t *in: rho || j || i (34 bytes)
+ **************************************************/
+void mlkem_sample_ntt(int16_t r[MLKEM_N], const uint8_t in[MLKEM_SYMBYTES + 2])
+{
+  unsigned int i, ctr = 0;
+  keccak_state state;
+
+  shake128_absorb(&state, in, MLKEM_SYMBYTES + 2);
+
+  while (ctr < MLKEM_N)
+  {
+    KeccakF1600_StatePermute(state.s);
+    for (i = 0; i < SHAKE128_RATE / 8 && ctr < MLKEM_N; i += 3)
+      ctr = rej_uniform_words(r, ctr, state.s[i], state.s[i + 1],
+                              state.s[i + 2]);
+  }
+}
+
+/*************************************************
+ * Name:        mlkem_sample_ntt_x2
+ *
+ * Description: SampleNTT of FIPS 203 on two seeds; each permutation
+ *              feeds both polynomials, and blocks are squeezed until
+ *              both are full
+ *
+ * Arguments:   - int16_t *r0, *r1: pointer to output polynomials
+ *              - const uint8_t *in0, *in1: rho || j || i (34 bytes)
+ **************************************************/
+void mlkem_sample_ntt_x2(int16_t r0[MLKEM_N],
+                         int16_t r1[MLKEM_N],
+                         const uint8_t in0[MLKEM_SYMBYTES + 2],
+                         const uint8_t in1[MLKEM_SYMBYTES + 2])
+{
+  unsigned int i, ctr0 = 0, ctr1 = 0;
+  v128 s[25];
+
+  keccakx2_absorb(s, SHAKE128_RATE, in0, in1, MLKEM_SYMBYTES + 2, 0x1F);
+
+  while (ctr0 < MLKEM_N || ctr1 < MLKEM_N)
+  {
+    KeccakF1600_StatePermutex2(s);
+    for (i = 0; i < SHAKE128_RATE / 8; i += 3)
+    {
+      if (ctr0 < MLKEM_N)
+        ctr0 = rej_uniform_words(r0, ctr0, v128_lane0(s[i]),
+                                 v128_lane0(s[i + 1]), v128_lane0(s[i + 2]));
+      if (ctr1 < MLKEM_N)
+        ctr1 = rej_uniform_words(r1, ctr1, v128_lane1(s[i]),
+                                 v128_lane1(s[i + 1]), v128_lane1(s[i + 2]));
+    }
+  }
+}
+
+/*************************************************
+ * Name:        mlkem_gen_matrix
+ *
+ * Description: Expand the ML-KEM matrix A (or its transpose) from rho,
+ *              two entries per call to mlkem_sample_ntt_x2 and the odd
+ *              one (k = 3) on the scalar permutation
+ *
+ * Arguments:   - int16_t *a: pointer to output, k * k polynomials
+ *              - const uint8_t *rho: seed (32 bytes)
+ *              - unsigned int k: module rank, 2 to 4
+ *              - int transposed: nonzero for A^T
+ **************************************************/
+void mlkem_gen_matrix(int16_t *a,
+                      const uint8_t rho[MLKEM_SYMBYTES],
+                      unsigned int k,
+                      int transposed)
+{
+  unsigned int n, i, j;
+  uint8_t in[2][MLKEM_SYMBYTES + 2];
+
+  memcpy(in[0], rho, MLKEM_SYMBYTES);
+  memcpy(in[1], rho, MLKEM_SYMBYTES);
+
+  for (n = 0; n + 2 <= k * k; n += 2)
+  {
+    for (j = 0; j < 2; ++j)
+    {
+      i = n + j;
+      in[j][MLKEM_SYMBYTES + 0] = transposed ? i / k : i % k;
+      in[j][MLKEM_SYMBYTES + 1] = transposed ? i % k : i / k;
+    }
+    mlkem_sample_ntt_x2(&a[n * MLKEM_N], &a[(n + 1) * MLKEM_N], in[0], in[1]);
+  }
+
+  if (n < k * k)
+  {
+    in[0][MLKEM_SYMBYTES + 0] = transposed ? n / k : n % k;
+    in[0][MLKEM_SYMBYTES + 1] = transposed ? n % k : n / k;
+    mlkem_sample_ntt(&a[n * MLKEM_N], in[0]);
+  }
+}
@@ -0,0 +1,49 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#ifndef MLKEM_H
+#define MLKEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * ML-KEM (FIPS 203) matrix expansion: SampleNTT parses SHAKE128 output
+ * into 12-bit candidates and keeps those below q. The candidates are
+ * read from the state words after each permutation, two polynomials at
+ * a time on the x2 permutation, without an output buffer.
+ */
+#define MLKEM_N 256
+#define MLKEM_Q 3329
+#define MLKEM_SYMBYTES 32
+
+// in: rho || j || i, 34 bytes; r: coefficients in [0, q)
+void mlkem_sample_ntt(int16_t r[MLKEM_N], const uint8_t in[MLKEM_SYMBYTES + 2]);
+
+void mlkem_sample_ntt_x2(int16_t r0[MLKEM_N],
+                         int16_t r1[MLKEM_N],
+                         const uint8_t in0[MLKEM_SYMBYTES + 2],
+                         const uint8_t in1[MLKEM_SYMBYTES + 2]);
+
+/*
+ * a: k * k polynomials, row-major; a[i][j] = SampleNTT(rho || j || i),
+ * or SampleNTT(rho || i || j) if transposed, k = 2, 3 or 4
+ */
+void mlkem_gen_matrix(int16_t *a,
+                      const uint8_t rho[MLKEM_SYMBYTES],
+                      unsigned int k,
+                      int transposed);
+
+#endif
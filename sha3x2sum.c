@@ -0,0 +1,118 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "filehash.h"
+
+/*
+Usage: sha3x2sum [-a sha3-256|sha3-512|shake128|shake256] [-l bytes] [file...]
+Prints one "digest  file" line per file, like sha256sum; no file or "-"
+reads standard input. -l sets the output length of the XOFs.
+*/
+
+static const struct {
+  const char *name;
+  filehash_fn fn;
+  size_t outlen;
+} algs[] = {
+  { "sha3-256", FILEHASH_SHA3_256, 32 },
+  { "sha3-512", FILEHASH_SHA3_512, 64 },
+  { "shake128", FILEHASH_SHAKE128, 32 },
+  { "shake256", FILEHASH_SHAKE256, 64 }
+};
+
+static void usage(const char *prog)
+{
+  fprintf(stderr, "usage: %s [-a sha3-256|sha3-512|shake128|shake256] "
+                  "[-l bytes] [file...]\n", prog);
+  exit(2);
+}
+
+int main(int argc, char **argv)
+{
+  static const char *stdin_path[] = { "-" };
+  const char *const *path;
+  uint8_t **out;
+  uint8_t *buf;
+  size_t i, j, n, outlen = 0, a = 0;
+  int c, ret, *err;
+
+  while ((c = getopt(argc, argv, "a:l:")) != -1)
+  {
+    switch (c)
+    {
+    case 'a':
+      for (a = 0; a < sizeof(algs) / sizeof(algs[0]); ++a)
+        if (strcmp(optarg, algs[a].name) == 0)
+          break;
+      if (a == sizeof(algs) / sizeof(algs[0]))
+        usage(argv[0]);
+      break;
+    case 'l':
+      outlen = strtoul(optarg, NULL, 10);
+      if (outlen == 0)
+        usage(argv[0]);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (outlen == 0 || algs[a].fn == FILEHASH_SHA3_256 ||
+      algs[a].fn == FILEHASH_SHA3_512)
+    outlen = algs[a].outlen;
+
+  n = (size_t)(argc - optind);
+  path = (const char *const *)&argv[optind];
+  if (n == 0)
+  {
+    n = 1;
+    path = stdin_path;
+  }
+
+  buf = (uint8_t *)malloc(n * outlen);
+  out = (uint8_t **)malloc(n * sizeof(out[0]));
+  err = (int *)malloc(n * sizeof(err[0]));
+  if (buf == NULL || out == NULL || err == NULL)
+  {
+    perror(argv[0]);
+    return 1;
+  }
+  for (i = 0; i < n; ++i)
+    out[i] = buf + i * outlen;
+
+  ret = filehash(algs[a].fn, out, outlen, path, err, n) != 0;
+
+  for (i = 0; i < n; ++i)
+  {
+    if (err[i] != 0)
+    {
+      fprintf(stderr, "%s: %s: %s\n", argv[0], path[i], strerror(err[i]));
+      continue;
+    }
+    for (j = 0; j < outlen; ++j)
+      printf("%02x", out[i][j]);
+    printf("  %s\n", path[i]);
+  }
+
+  free(err);
+  free(out);
+  free(buf);
+  return ret;
+}
@@ -0,0 +1,433 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "fips202.h"
+#include "fips202x2.h"
+#include "slhdsa.h"
+
+// ADRS word offsets, 4-byte big-endian words
+#define ADDR_TYPE 16
+#define ADDR_KEYPAIR 20
+#define ADDR_CHAIN 24
+#define ADDR_HASH 28
+#define ADDR_HEIGHT 24
+#define ADDR_INDEX 28
+
+/*************************************************
+ * Name:        set_addr_word
+ *
+ * Description: Set one 4-byte big-endian word of ADRS
+ *
+ * Arguments:   - uint8_t *addr: pointer to ADRS (32 bytes)
+ *              - unsigned int off: byte offset of the word
+ *              - uint32_t v: value
+ **************************************************/
+static void set_addr_word(uint8_t addr[SLHDSA_ADDR_BYTES],
+                          unsigned int off,
+                          uint32_t v)
+{
+  addr[off + 0] = (uint8_t)(v >> 24);
+  addr[off + 1] = (uint8_t)(v >> 16);
+  addr[off + 2] = (uint8_t)(v >> 8);
+  addr[off + 3] = (uint8_t)v;
+}
+
+/*************************************************
+ * Name:        slhdsa_ctx_init
+ *
+ * Description: Load PK.seed into both lanes once per key
+ *
+ * Arguments:   - slhdsa_ctx *ctx: pointer to output context
+ *              - const uint8_t *pk_seed: PK.seed (n bytes)
+ *              - unsigned int n: security parameter, 16, 24 or 32
+ **************************************************/
+void slhdsa_ctx_init(slhdsa_ctx *ctx, const uint8_t *pk_seed, unsigned int n)
+{
+  unsigned int i;
+
+  for (i = 0; i < n / 8; ++i)
+    ctx->pk_seed[i] = v128_dup(v128_load64(&pk_seed[8 * i]));
+  memcpy(ctx->pk_seed_bytes, pk_seed, n);
+  ctx->n = n;
+}
+
+/*************************************************
+ * Name:        thash_x2_block
+ *
+ * Description: Two-lane tweakable hash for PK.seed || ADRS || M of at
+ *              most SHAKE256_RATE - 8 bytes: every lane of the block is
+ *              written once, the padding lanes are constants, and only
+ *              the n output bytes are stored
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointer to output (n bytes)
+ *              - const uint8_t *in0, *in1: pointer to M (inblocks * n bytes)
+ *              - unsigned int inblocks: number of n-byte blocks of M
+ *              - const slhdsa_ctx *ctx: pointer to context
+ *              - const uint8_t *addr0, *addr1: pointer to ADRS
+ **************************************************/
+static void thash_x2_block(uint8_t *out0,
+                           uint8_t *out1,
+                           const uint8_t *in0,
+                           const uint8_t *in1,
+                           unsigned int inblocks,
+                           const slhdsa_ctx *ctx,
+                           const uint8_t *addr0,
+                           const uint8_t *addr1)
+{
+  unsigned int i, j, nlanes = ctx->n / 8, mlanes = inblocks * nlanes;
+  v128 s[25], a, b;
+
+  for (i = 0; i < nlanes; ++i)
+    s[i] = ctx->pk_seed[i];
+
+  for (j = 0; j < SLHDSA_ADDR_BYTES; j += 16, i += 2)
+  {
+    a = v128_load(&addr0[j]);
+    b = v128_load(&addr1[j]);
+    s[i + 0] = v128_zip0(a, b);
+    s[i + 1] = v128_zip1(a, b);
+  }
+
+  for (j = 0; j + 2 <= mlanes; j += 2, i += 2)
+  {
+    a = v128_load(&in0[8 * j]);
+    b = v128_load(&in1[8 * j]);
+    s[i + 0] = v128_zip0(a, b);
+    s[i + 1] = v128_zip1(a, b);
+  }
+  if (j < mlanes)
+    s[i++] = v128_load2(&in0[8 * j], &in1[8 * j]);
+
+  // SHAKE padding, the input length is a multiple of 8
+  s[i++] = v128_dup(0x1F);
+  for (; i < 25; ++i)
+    s[i] = v128_zero();
+  s[SHAKE256_RATE / 8 - 1] = v128_xor(s[SHAKE256_RATE / 8 - 1],
+                                      v128_dup(1ULL << 63));
+
+  KeccakF1600_StatePermutex2(s);
+
+  for (i = 0; i + 2 <= nlanes; i += 2)
+  {
+    v128_store(&out0[8 * i], v128_zip0(s[i], s[i + 1]));
+    v128_store(&out1[8 * i], v128_zip1(s[i], s[i + 1]));
+  }
+  if (i < nlanes)
+    v128_store2(&out0[8 * i], &out1[8 * i], s[i]);
+}
+
+/*************************************************
+ * Name:        slhdsa_thash
+ *
+ * Description: Tweakable hash T_l of SLH-DSA-SHAKE on one input
+ *
+ * Arguments:   - uint8_t *out: pointer to output (n bytes)
+ *              - const uint8_t *in: pointer to M (inblocks * n bytes)
+ *              - unsigned int inblocks: number of n-byte blocks of M
+ *              - const slhdsa_ctx *ctx: pointer to context
+ *              - const uint8_t *addr: pointer to ADRS
+ **************************************************/
+void slhdsa_thash(uint8_t *out,
+                  const uint8_t *in,
+                  unsigned int inblocks,
+                  const slhdsa_ctx *ctx,
+                  const uint8_t addr[SLHDSA_ADDR_BYTES])
+{
+  keccak_inc_state state;
+
+  keccak_inc_init(&state);
+  keccak_inc_absorb(&state, SHAKE256_RATE, ctx->pk_seed_bytes, ctx->n);
+  keccak_inc_absorb(&state, SHAKE256_RATE, addr, SLHDSA_ADDR_BYTES);
+  keccak_inc_absorb(&state, SHAKE256_RATE, in, inblocks * ctx->n);
+  keccak_inc_finalize(&state, SHAKE256_RATE, 0x1F);
+  keccak_inc_squeeze(out, ctx->n, &state, SHAKE256_RATE);
+}
+
+/*************************************************
+ * Name:        slhdsa_thash_x2
+ *
+ * Description: Tweakable hash T_l of SLH-DSA-SHAKE on two inputs of the
+ *              same length; F, H and PRF take the single-block path
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointer to output (n bytes)
+ *              - const uint8_t *in0, *in1: pointer to M (inblocks * n bytes)
+ *              - unsigned int inblocks: number of n-byte blocks of M
+ *              - const slhdsa_ctx *ctx: pointer to context
+ *              - const uint8_t *addr0, *addr1: pointer to ADRS
+ **************************************************/
+void slhdsa_thash_x2(uint8_t *out0,
+                     uint8_t *out1,
+                     const uint8_t *in0,
+                     const uint8_t *in1,
+                     unsigned int inblocks,
+                     const slhdsa_ctx *ctx,
+                     const uint8_t addr0[SLHDSA_ADDR_BYTES],
+                     const uint8_t addr1[SLHDSA_ADDR_BYTES])
+{
+  unsigned int pos;
+  v128 s[25];
+
+  if ((inblocks + 1) * ctx->n + SLHDSA_ADDR_BYTES < SHAKE256_RATE)
+  {
+    thash_x2_block(out0, out1, in0, in1, inblocks, ctx, addr0, addr1);
+    return;
+  }
+
+  // WOTS+ public key and FORS roots: several blocks
+  for (pos = 0; pos < 25; ++pos)
+    s[pos] = v128_zero();
+  pos = keccakx2_inc_absorb(s, 0, SHAKE256_RATE, ctx->pk_seed_bytes,
+                            ctx->pk_seed_bytes, ctx->n);
+  pos = keccakx2_inc_absorb(s, pos, SHAKE256_RATE, addr0, addr1,
+                            SLHDSA_ADDR_BYTES);
+  pos = keccakx2_inc_absorb(s, pos, SHAKE256_RATE, in0, in1,
+                            inblocks * ctx->n);
+  keccakx2_inc_finalize(s, pos, SHAKE256_RATE, 0x1F);
+  keccakx2_squeeze(out0, out1, ctx->n, SHAKE256_RATE, s);
+}
+
+/*************************************************
+ * Name:        slhdsa_wots_gen_sk
+ *
+ * Description: WOTS+ secret key, PRF of each chain address
+ *
+ * Arguments:   - uint8_t *sk: pointer to output (len * n bytes)
+ *              - const uint8_t *sk_seed: SK.seed (n bytes)
+ *              - unsigned int len: number of chains
+ *              - const slhdsa_ctx *ctx: pointer to context
+ *              - const uint8_t *addr: pointer to ADRS of the key pair
+ **************************************************/
+void slhdsa_wots_gen_sk(uint8_t *sk,
+                        const uint8_t *sk_seed,
+                        unsigned int len,
+                        const slhdsa_ctx *ctx,
+                        const uint8_t addr[SLHDSA_ADDR_BYTES])
+{
+  unsigned int i;
+  const unsigned int n = ctx->n;
+  uint8_t a[2][SLHDSA_ADDR_BYTES];
+
+  for (i = 0; i < 2; ++i)
+  {
+    memcpy(a[i], addr, SLHDSA_ADDR_BYTES);
+    set_addr_word(a[i], ADDR_TYPE, SLHDSA_ADDR_WOTS_PRF);
+    set_addr_word(a[i], ADDR_HASH, 0);
+  }
+
+  for (i = 0; i + 2 <= len; i += 2)
+  {
+    set_addr_word(a[0], ADDR_CHAIN, i);
+    set_addr_word(a[1], ADDR_CHAIN, i + 1);
+    slhdsa_thash_x2(&sk[i * n], &sk[(i + 1) * n], sk_seed, sk_seed, 1,
+                    ctx, a[0], a[1]);
+  }
+
+  if (i < len)
+  {
+    set_addr_word(a[0], ADDR_CHAIN, i);
+    slhdsa_thash(&sk[i * n], sk_seed, 1, ctx, a[0]);
+  }
+}
+
+/*************************************************
+ * Name:        slhdsa_wots_chains
+ *
+ * Description: Run len WOTS+ chains on the two lanes; the chains are
+ *              taken longest first and a lane picks up the next chain as
+ *              soon as its own is done, so only the last chain may run
+ *              alone
+ *
+ * Arguments:   - uint8_t *out: pointer to output (len * n bytes)
+ *              - const uint8_t *in: pointer to input (len * n bytes)
+ *              - const unsigned int *start: start position of each chain
+ *              - const unsigned int *steps: number of steps of each chain
+ *              - unsigned int len: number of chains, at most 128
+ *              - const slhdsa_ctx *ctx: pointer to context
+ *              - const uint8_t *addr: pointer to ADRS of the key pair
+ **************************************************/
+void slhdsa_wots_chains(uint8_t *out,
+                        const uint8_t *in,
+                        const unsigned int *start,
+                        const unsigned int *steps,
+                        unsigned int len,
+                        const slhdsa_ctx *ctx,
+                        const uint8_t addr[SLHDSA_ADDR_BYTES])
+{
+  unsigned int i, j, t, next = 0;
+  unsigned int c[2], pos[2], left[2] = {0, 0};
+  const unsigned int n = ctx->n;
+  uint8_t order[128], a[2][SLHDSA_ADDR_BYTES];
+
+  if (out != in)
+    memmove(out, in, (size_t)len * n);
+
+  // Chains by decreasing number of steps, insertion sort
+  for (i = 0; i < len; ++i)
+  {
+    for (j = i; j > 0 && steps[order[j - 1]] < steps[i]; --j)
+      order[j] = order[j - 1];
+    order[j] = (uint8_t)i;
+  }
+
+  for (i = 0; i < 2; ++i)
+  {
+    memcpy(a[i], addr, SLHDSA_ADDR_BYTES);
+    set_addr_word(a[i], ADDR_TYPE, SLHDSA_ADDR_WOTS_HASH);
+  }
+
+  for (;;)
+  {
+    for (i = 0; i < 2; ++i)
+    {
+      if (left[i] == 0 && next < len && steps[order[next]] > 0)
+      {
+        t = order[next++];
+        c[i] = t;
+        pos[i] = start[t];
+        left[i] = steps[t];
+        set_addr_word(a[i], ADDR_CHAIN, t);
+      }
+    }
+
+    if (left[0] && left[1])
+    {
+      set_addr_word(a[0], ADDR_HASH, pos[0]++);
+      set_addr_word(a[1], ADDR_HASH, pos[1]++);
+      slhdsa_thash_x2(&out[c[0] * n], &out[c[1] * n], &out[c[0] * n],
+                      &out[c[1] * n], 1, ctx, a[0], a[1]);
+      --left[0];
+      --left[1];
+    }
+    else if (left[0] || left[1])
+    {
+      i = left[0] ? 0 : 1;
+      set_addr_word(a[i], ADDR_HASH, pos[i]++);
+      slhdsa_thash(&out[c[i] * n], &out[c[i] * n], 1, ctx, a[i]);
+      --left[i];
+    }
+    else
+    {
+      break;
+    }
+  }
+}
+
+/*************************************************
+ * Name:        slhdsa_fors_leaves
+ *
+ * Description: FORS leaves: the secret value PRF(SK.seed) with type
+ *              FORS_PRF, then F with type FORS_TREE at height 0
+ *
+ * Arguments:   - uint8_t *out: pointer to output (count * n bytes)
+ *              - const uint8_t *sk_seed: SK.seed (n bytes)
+ *              - uint32_t index: tree index of the first leaf
+ *              - unsigned int count: number of leaves
+ *              - const slhdsa_ctx *ctx: pointer to context
+ *              - const uint8_t *addr: pointer to ADRS of the key pair
+ **************************************************/
+void slhdsa_fors_leaves(uint8_t *out,
+                        const uint8_t *sk_seed,
+                        uint32_t index,
+                        unsigned int count,
+                        const slhdsa_ctx *ctx,
+                        const uint8_t addr[SLHDSA_ADDR_BYTES])
+{
+  unsigned int i, j;
+  const unsigned int n = ctx->n;
+  uint8_t a[2][SLHDSA_ADDR_BYTES];
+
+  for (i = 0; i < 2; ++i)
+  {
+    memcpy(a[i], addr, SLHDSA_ADDR_BYTES);
+    set_addr_word(a[i], ADDR_HEIGHT, 0);
+  }
+
+  for (i = 0; i + 2 <= count; i += 2)
+  {
+    for (j = 0; j < 2; ++j)
+    {
+      set_addr_word(a[j], ADDR_TYPE, SLHDSA_ADDR_FORS_PRF);
+      set_addr_word(a[j], ADDR_INDEX, index + i + j);
+    }
+    slhdsa_thash_x2(&out[i * n], &out[(i + 1) * n], sk_seed, sk_seed, 1,
+                    ctx, a[0], a[1]);
+
+    set_addr_word(a[0], ADDR_TYPE, SLHDSA_ADDR_FORS_TREE);
+    set_addr_word(a[1], ADDR_TYPE, SLHDSA_ADDR_FORS_TREE);
+    slhdsa_thash_x2(&out[i * n], &out[(i + 1) * n], &out[i * n],
+                    &out[(i + 1) * n], 1, ctx, a[0], a[1]);
+  }
+
+  if (i < count)
+  {
+    set_addr_word(a[0], ADDR_TYPE, SLHDSA_ADDR_FORS_PRF);
+    set_addr_word(a[0], ADDR_INDEX, index + i);
+    slhdsa_thash(&out[i * n], sk_seed, 1, ctx, a[0]);
+
+    set_addr_word(a[0], ADDR_TYPE, SLHDSA_ADDR_FORS_TREE);
+    slhdsa_thash(&out[i * n], &out[i * n], 1, ctx, a[0]);
+  }
+}
+
+/*************************************************
+ * Name:        slhdsa_tree_level
+ *
+ * Description: Parents of count pairs of nodes, two per call; the
+ *              inputs of a call are read before its outputs are written,
+ *              so the level can be computed in place
+ *
+ * Arguments:   - uint8_t *out: pointer to output (count * n bytes)
+ *              - const uint8_t *in: pointer to children (2 * count * n bytes)
+ *              - unsigned int height: height of the parents
+ *              - uint32_t index: tree index of the first parent
+ *              - unsigned int count: number of parents
+ *              - const slhdsa_ctx *ctx: pointer to context
+ *              - const uint8_t *addr: pointer to ADRS with the tree type
+ **************************************************/
+void slhdsa_tree_level(uint8_t *out,
+                       const uint8_t *in,
+                       unsigned int height,
+                       uint32_t index,
+                       unsigned int count,
+                       const slhdsa_ctx *ctx,
+                       const uint8_t addr[SLHDSA_ADDR_BYTES])
+{
+  unsigned int i;
+  const unsigned int n = ctx->n;
+  uint8_t a[2][SLHDSA_ADDR_BYTES];
+
+  for (i = 0; i < 2; ++i)
+  {
+    memcpy(a[i], addr, SLHDSA_ADDR_BYTES);
+    set_addr_word(a[i], ADDR_HEIGHT, height);
+  }
+
+  for (i = 0; i + 2 <= count; i += 2)
+  {
+    set_addr_word(a[0], ADDR_INDEX, index + i);
+    set_addr_word(a[1], ADDR_INDEX, index + i + 1);
+    slhdsa_thash_x2(&out[i * n], &out[(i + 1) * n], &in[2 * i * n],
+                    &in[2 * (i + 1) * n], 2, ctx, a[0], a[1]);
+  }
+
+  if (i < count)
+  {
+    set_addr_word(a[0], ADDR_INDEX, index + i);
+    slhdsa_thash(&out[i * n], &in[2 * i * n], 2, ctx, a[0]);
+  }
+}
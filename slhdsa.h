@@ -0,0 +1,117 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#ifndef SLHDSA_H
+#define SLHDSA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "v128.h"
+
+/*
+ * SLH-DSA-SHAKE (FIPS 205) tweakable hash: T_l(PK.seed, ADRS, M) =
+ * SHAKE256(PK.seed || ADRS || M, 8n), and PRF, which is T_1 with
+ * M = SK.seed. Inputs of one or two n-byte blocks fit in one SHAKE256
+ * block and are absorbed without the generic sponge loop.
+ */
+#define SLHDSA_MAX_N 32
+#define SLHDSA_ADDR_BYTES 32
+
+// ADRS types
+#define SLHDSA_ADDR_WOTS_HASH 0
+#define SLHDSA_ADDR_WOTS_PK 1
+#define SLHDSA_ADDR_TREE 2
+#define SLHDSA_ADDR_FORS_TREE 3
+#define SLHDSA_ADDR_FORS_ROOTS 4
+#define SLHDSA_ADDR_WOTS_PRF 5
+#define SLHDSA_ADDR_FORS_PRF 6
+
+/*
+ * PK.seed, set once per key and shared by both lanes of every call
+ */
+typedef struct {
+  v128 pk_seed[SLHDSA_MAX_N / 8];
+  uint8_t pk_seed_bytes[SLHDSA_MAX_N];
+  unsigned int n;
+} slhdsa_ctx;
+
+// n = 16, 24 or 32
+void slhdsa_ctx_init(slhdsa_ctx *ctx, const uint8_t *pk_seed, unsigned int n);
+
+/*
+ * M is inblocks * n bytes, the output n bytes; out may be the same
+ * buffer as in
+ */
+void slhdsa_thash(uint8_t *out,
+                  const uint8_t *in,
+                  unsigned int inblocks,
+                  const slhdsa_ctx *ctx,
+                  const uint8_t addr[SLHDSA_ADDR_BYTES]);
+
+void slhdsa_thash_x2(uint8_t *out0,
+                     uint8_t *out1,
+                     const uint8_t *in0,
+                     const uint8_t *in1,
+                     unsigned int inblocks,
+                     const slhdsa_ctx *ctx,
+                     const uint8_t addr0[SLHDSA_ADDR_BYTES],
+                     const uint8_t addr1[SLHDSA_ADDR_BYTES]);
+
+/*
+ * Batches that keep both lanes busy. addr carries the layer, tree and
+ * key pair address; the helpers set the type-specific words.
+ */
+
+// WOTS+ secret keys of chains 0 to len - 1 (PRF with type WOTS_PRF)
+void slhdsa_wots_gen_sk(uint8_t *sk,
+                        const uint8_t *sk_seed,
+                        unsigned int len,
+                        const slhdsa_ctx *ctx,
+                        const uint8_t addr[SLHDSA_ADDR_BYTES]);
+
+/*
+ * WOTS+ chains (type WOTS_HASH): chain i of in runs steps[i] steps from
+ * position start[i] into out, longest chains first; out may be in
+ */
+void slhdsa_wots_chains(uint8_t *out,
+                        const uint8_t *in,
+                        const unsigned int *start,
+                        const unsigned int *steps,
+                        unsigned int len,
+                        const slhdsa_ctx *ctx,
+                        const uint8_t addr[SLHDSA_ADDR_BYTES]);
+
+// FORS leaves F(PRF(SK.seed, index + i)) for i = 0 to count - 1
+void slhdsa_fors_leaves(uint8_t *out,
+                        const uint8_t *sk_seed,
+                        uint32_t index,
+                        unsigned int count,
+                        const slhdsa_ctx *ctx,
+                        const uint8_t addr[SLHDSA_ADDR_BYTES]);
+
+/*
+ * One level of a Merkle tree (type TREE or FORS_TREE, set in addr):
+ * out[i] = H(in[2i] || in[2i + 1]) at the given height and tree index
+ * index + i, for i = 0 to count - 1; out may be in
+ */
+void slhdsa_tree_level(uint8_t *out,
+                       const uint8_t *in,
+                       unsigned int height,
+                       uint32_t index,
+                       unsigned int count,
+                       const slhdsa_ctx *ctx,
+                       const uint8_t addr[SLHDSA_ADDR_BYTES]);
+
+#endif
@@ -0,0 +1,719 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include "fips202.h"
+#include "fips202x2.h"
+#include "sp800185.h"
+
+static const uint8_t parallelhash_name[12] = {
+    'P', 'a', 'r', 'a', 'l', 'l', 'e', 'l', 'H', 'a', 's', 'h'};
+
+static const uint8_t kmac_name[4] = {'K', 'M', 'A', 'C'};
+
+/*************************************************
+ * Name:        left_encode
+ *
+ * Description: left_encode of SP 800-185: number of bytes of x,
+ *              then x big-endian without leading zeros (at least one)
+ *
+ * Arguments:   - uint8_t *buf: output, at most 9 bytes
+ *              - uint64_t x: value to encode
+ *
+ * Returns the number of bytes written
+ **************************************************/
+static unsigned int left_encode(uint8_t buf[9], uint64_t x)
+{
+  unsigned int i, n = 1;
+
+  while (n < 8 && (x >> 8 * n) != 0)
+    n++;
+
+  buf[0] = n;
+  for (i = 1; i <= n; ++i)
+    buf[i] = x >> 8 * (n - i);
+
+  return n + 1;
+}
+
+/*************************************************
+ * Name:        right_encode
+ *
+ * Description: right_encode of SP 800-185: x big-endian without
+ *              leading zeros (at least one), then its number of bytes
+ *
+ * Arguments:   - uint8_t *buf: output, at most 9 bytes
+ *              - uint64_t x: value to encode
+ *
+ * Returns the number of bytes written
+ **************************************************/
+static unsigned int right_encode(uint8_t buf[9], uint64_t x)
+{
+  unsigned int i, n = 1;
+
+  while (n < 8 && (x >> 8 * n) != 0)
+    n++;
+
+  for (i = 0; i < n; ++i)
+    buf[i] = x >> 8 * (n - 1 - i);
+  buf[n] = n;
+
+  return n + 1;
+}
+
+/*************************************************
+ * Name:        absorb_encode_string
+ *
+ * Description: Absorb encode_string(x) = left_encode(bit length) || x
+ *
+ * Arguments:   - keccak_inc_state *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes
+ *              - const uint8_t *x: pointer to the string
+ *              - size_t xlen: length of the string in bytes
+ **************************************************/
+static void absorb_encode_string(keccak_inc_state *state,
+                                 unsigned int r,
+                                 const uint8_t *x,
+                                 size_t xlen)
+{
+  uint8_t buf[9];
+
+  keccak_inc_absorb(state, r, buf, left_encode(buf, 8 * (uint64_t)xlen));
+  keccak_inc_absorb(state, r, x, xlen);
+}
+
+/*************************************************
+ * Name:        absorb_bytepad_end
+ *
+ * Description: Zero-pad what was absorbed since the last left_encode(r)
+ *              to a whole block, the end of bytepad
+ *
+ * Arguments:   - keccak_inc_state *state: pointer to input/output Keccak state
+ *              - unsigned int r: rate in bytes
+ **************************************************/
+static void absorb_bytepad_end(keccak_inc_state *state, unsigned int r)
+{
+  static const uint8_t zeros[SHAKE128_RATE] = {0};
+
+  if (state->pos != 0)
+    keccak_inc_absorb(state, r, zeros, r - state->pos);
+}
+
+/*************************************************
+ * Name:        cshake_init
+ *
+ * Description: Absorb bytepad(encode_string(N) || encode_string(S), r),
+ *              the cSHAKE prefix
+ *
+ * Arguments:   - keccak_inc_state *state: pointer to output Keccak state
+ *              - unsigned int r: rate in bytes
+ *              - const uint8_t *name: function-name string N
+ *              - size_t namelen: length of N in bytes
+ *              - const uint8_t *custom: customization string S
+ *              - size_t customlen: length of S in bytes
+ **************************************************/
+static void cshake_init(keccak_inc_state *state,
+                        unsigned int r,
+                        const uint8_t *name,
+                        size_t namelen,
+                        const uint8_t *custom,
+                        size_t customlen)
+{
+  uint8_t buf[9];
+
+  keccak_inc_init(state);
+
+  keccak_inc_absorb(state, r, buf, left_encode(buf, r));
+  absorb_encode_string(state, r, name, namelen);
+  absorb_encode_string(state, r, custom, customlen);
+  absorb_bytepad_end(state, r);
+}
+
+/*************************************************
+ * Name:        cshake
+ *
+ * Description: cSHAKE, SHAKE when N and S are both empty
+ *
+ * Arguments:   - uint8_t *out: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - unsigned int r: rate in bytes
+ *              - const uint8_t *in: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - const uint8_t *name, *custom: N and S
+ *              - size_t namelen, customlen: length of N and S in bytes
+ **************************************************/
+static void cshake(uint8_t *out,
+                   size_t outlen,
+                   unsigned int r,
+                   const uint8_t *in,
+                   size_t inlen,
+                   const uint8_t *name,
+                   size_t namelen,
+                   const uint8_t *custom,
+                   size_t customlen)
+{
+  keccak_inc_state state;
+
+  if (namelen == 0 && customlen == 0)
+  {
+    keccak_inc_init(&state);
+    keccak_inc_absorb(&state, r, in, inlen);
+    keccak_inc_finalize(&state, r, 0x1F);
+    keccak_inc_squeeze(out, outlen, &state, r);
+    return;
+  }
+
+  cshake_init(&state, r, name, namelen, custom, customlen);
+  keccak_inc_absorb(&state, r, in, inlen);
+  keccak_inc_finalize(&state, r, 0x04);
+  keccak_inc_squeeze(out, outlen, &state, r);
+}
+
+/*************************************************
+ * Name:        parallelhash
+ *
+ * Description: ParallelHash. Block i is SHAKE (cSHAKE with empty N
+ *              and S) of in[i * blocklen ..], hashed in pairs with
+ *              shake128x2/shake256x2; the last pair may be one full
+ *              and one short block, an odd block out goes through
+ *              fips202.c. The chaining values are absorbed straight
+ *              into the outer cSHAKE.
+ *
+ * Arguments:   - uint8_t *out: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - unsigned int r: rate in bytes, 168 or 136
+ *              - const uint8_t *in: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - size_t blocklen: block size B in bytes, not 0
+ *              - const uint8_t *custom: customization string S
+ *              - size_t customlen: length of S in bytes
+ *              - int xof: 1 for ParallelHashXOF
+ **************************************************/
+static void parallelhash(uint8_t *out,
+                         size_t outlen,
+                         unsigned int r,
+                         const uint8_t *in,
+                         size_t inlen,
+                         size_t blocklen,
+                         const uint8_t *custom,
+                         size_t customlen,
+                         int xof)
+{
+  size_t i, n, len1;
+  // 2 * security strength
+  const size_t cvlen = r == SHAKE128_RATE ? 32 : 64;
+  uint8_t buf[9], cv[2][64];
+  const uint8_t *b0, *b1;
+  keccak_inc_state state;
+
+  cshake_init(&state, r, parallelhash_name, sizeof(parallelhash_name),
+              custom, customlen);
+  keccak_inc_absorb(&state, r, buf, left_encode(buf, blocklen));
+
+  n = (inlen + blocklen - 1) / blocklen;
+  for (i = 0; i + 2 <= n; i += 2)
+  {
+    b0 = &in[i * blocklen];
+    b1 = b0 + blocklen;
+    len1 = inlen - (i + 1) * blocklen;
+    if (len1 > blocklen)
+      len1 = blocklen;
+
+    if (r == SHAKE128_RATE)
+    {
+      if (len1 == blocklen)
+        shake128x2(cv[0], cv[1], cvlen, b0, b1, blocklen);
+      else
+        shake128x2_var(cv[0], cv[1], cvlen, b0, b1, blocklen, len1);
+    }
+    else
+    {
+      if (len1 == blocklen)
+        shake256x2(cv[0], cv[1], cvlen, b0, b1, blocklen);
+      else
+        shake256x2_var(cv[0], cv[1], cvlen, b0, b1, blocklen, len1);
+    }
+
+    keccak_inc_absorb(&state, r, cv[0], cvlen);
+    keccak_inc_absorb(&state, r, cv[1], cvlen);
+  }
+
+  if (i < n)
+  {
+    b0 = &in[i * blocklen];
+    if (r == SHAKE128_RATE)
+      shake128(cv[0], cvlen, b0, inlen - i * blocklen);
+    else
+      shake256(cv[0], cvlen, b0, inlen - i * blocklen);
+    keccak_inc_absorb(&state, r, cv[0], cvlen);
+  }
+
+  keccak_inc_absorb(&state, r, buf, right_encode(buf, n));
+  keccak_inc_absorb(&state, r, buf,
+                    right_encode(buf, xof ? 0 : 8 * (uint64_t)outlen));
+  keccak_inc_finalize(&state, r, 0x04);
+  keccak_inc_squeeze(out, outlen, &state, r);
+}
+
+/*************************************************
+ * Name:        cshakex2
+ *
+ * Description: cSHAKE on two inputs of the same length, the prefix is
+ *              absorbed once on the scalar state and copied to both lanes
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - unsigned int r: rate in bytes
+ *              - const uint8_t *in0, *in1: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - const uint8_t *name, *custom: N and S
+ *              - size_t namelen, customlen: length of N and S in bytes
+ **************************************************/
+static void cshakex2(uint8_t *out0,
+                     uint8_t *out1,
+                     size_t outlen,
+                     unsigned int r,
+                     const uint8_t *in0,
+                     const uint8_t *in1,
+                     size_t inlen,
+                     const uint8_t *name,
+                     size_t namelen,
+                     const uint8_t *custom,
+                     size_t customlen)
+{
+  unsigned int i, pos;
+  v128 s[25];
+  keccak_inc_state prefix;
+
+  if (namelen == 0 && customlen == 0)
+  {
+    keccakx2_absorb(s, r, in0, in1, inlen, 0x1F);
+    keccakx2_squeeze(out0, out1, outlen, r, s);
+    return;
+  }
+
+  cshake_init(&prefix, r, name, namelen, custom, customlen);
+  for (i = 0; i < 25; ++i)
+    s[i] = v128_dup(prefix.s[i]);
+
+  pos = keccakx2_inc_absorb(s, 0, r, in0, in1, inlen);
+  keccakx2_inc_finalize(s, pos, r, 0x04);
+  keccakx2_squeeze(out0, out1, outlen, r, s);
+}
+
+/*************************************************
+ * Name:        kmac_init_key
+ *
+ * Description: Absorb the cSHAKE prefix for N = "KMAC" and S, then
+ *              bytepad(encode_string(K), r)
+ *
+ * Arguments:   - kmac_key *key: pointer to output key schedule
+ *              - unsigned int r: rate in bytes
+ *              - const uint8_t *k: pointer to key
+ *              - size_t klen: length of key in bytes
+ *              - const uint8_t *custom: customization string S
+ *              - size_t customlen: length of S in bytes
+ **************************************************/
+static void kmac_init_key(kmac_key *key,
+                          unsigned int r,
+                          const uint8_t *k,
+                          size_t klen,
+                          const uint8_t *custom,
+                          size_t customlen)
+{
+  unsigned int i;
+  uint8_t buf[9];
+  keccak_inc_state state;
+
+  cshake_init(&state, r, kmac_name, sizeof(kmac_name), custom, customlen);
+
+  keccak_inc_absorb(&state, r, buf, left_encode(buf, r));
+  absorb_encode_string(&state, r, k, klen);
+  absorb_bytepad_end(&state, r);
+
+  for (i = 0; i < 25; ++i)
+    key->s[i] = state.s[i];
+  key->r = r;
+}
+
+/*************************************************
+ * Name:        kmacx2
+ *
+ * Description: KMAC of two messages of the same length under one key,
+ *              from the precomputed key schedule
+ *
+ * Arguments:   - const kmac_key *key: pointer to the key schedule
+ *              - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in0, *in1: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - int xof: 1 for KMACXOF
+ **************************************************/
+static void kmacx2(const kmac_key *key,
+                   uint8_t *out0,
+                   uint8_t *out1,
+                   size_t outlen,
+                   const uint8_t *in0,
+                   const uint8_t *in1,
+                   size_t inlen,
+                   int xof)
+{
+  unsigned int i, n, pos;
+  const unsigned int r = key->r;
+  uint8_t buf[9];
+  v128 s[25];
+
+  for (i = 0; i < 25; ++i)
+    s[i] = v128_dup(key->s[i]);
+
+  pos = keccakx2_inc_absorb(s, 0, r, in0, in1, inlen);
+  n = right_encode(buf, xof ? 0 : 8 * (uint64_t)outlen);
+  pos = keccakx2_inc_absorb(s, pos, r, buf, buf, n);
+  keccakx2_inc_finalize(s, pos, r, 0x04);
+  keccakx2_squeeze(out0, out1, outlen, r, s);
+}
+
+/*************************************************
+ * Name:        cshake128
+ *
+ * Description: cSHAKE128 XOF
+ *
+ * Arguments:   - uint8_t *out: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - const uint8_t *name, *custom: N and S
+ *              - size_t namelen, customlen: length of N and S in bytes
+ **************************************************/
+void cshake128(uint8_t *out,
+               size_t outlen,
+               const uint8_t *in,
+               size_t inlen,
+               const uint8_t *name,
+               size_t namelen,
+               const uint8_t *custom,
+               size_t customlen)
+{
+  cshake(out, outlen, SHAKE128_RATE, in, inlen,
+         name, namelen, custom, customlen);
+}
+
+/*************************************************
+ * Name:        cshake256
+ *
+ * Description: cSHAKE256 XOF
+ *
+ * Arguments:   - uint8_t *out: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - const uint8_t *name, *custom: N and S
+ *              - size_t namelen, customlen: length of N and S in bytes
+ **************************************************/
+void cshake256(uint8_t *out,
+               size_t outlen,
+               const uint8_t *in,
+               size_t inlen,
+               const uint8_t *name,
+               size_t namelen,
+               const uint8_t *custom,
+               size_t customlen)
+{
+  cshake(out, outlen, SHAKE256_RATE, in, inlen,
+         name, namelen, custom, customlen);
+}
+
+/*************************************************
+ * Name:        parallelhash128
+ *
+ * Description: ParallelHash128
+ *
+ * Arguments:   - uint8_t *out: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - size_t blocklen: block size B in bytes, not 0
+ *              - const uint8_t *custom: customization string S
+ *              - size_t customlen: length of S in bytes
+ **************************************************/
+void parallelhash128(uint8_t *out,
+                     size_t outlen,
+                     const uint8_t *in,
+                     size_t inlen,
+                     size_t blocklen,
+                     const uint8_t *custom,
+                     size_t customlen)
+{
+  parallelhash(out, outlen, SHAKE128_RATE, in, inlen, blocklen,
+               custom, customlen, 0);
+}
+
+/*************************************************
+ * Name:        parallelhash256
+ *
+ * Description: ParallelHash256
+ *
+ * Arguments:   - uint8_t *out: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - size_t blocklen: block size B in bytes, not 0
+ *              - const uint8_t *custom: customization string S
+ *              - size_t customlen: length of S in bytes
+ **************************************************/
+void parallelhash256(uint8_t *out,
+                     size_t outlen,
+                     const uint8_t *in,
+                     size_t inlen,
+                     size_t blocklen,
+                     const uint8_t *custom,
+                     size_t customlen)
+{
+  parallelhash(out, outlen, SHAKE256_RATE, in, inlen, blocklen,
+               custom, customlen, 0);
+}
+
+/*************************************************
+ * Name:        parallelhash128_xof
+ *
+ * Description: ParallelHashXOF128
+ *
+ * Arguments:   - uint8_t *out: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - size_t blocklen: block size B in bytes, not 0
+ *              - const uint8_t *custom: customization string S
+ *              - size_t customlen: length of S in bytes
+ **************************************************/
+void parallelhash128_xof(uint8_t *out,
+                         size_t outlen,
+                         const uint8_t *in,
+                         size_t inlen,
+                         size_t blocklen,
+                         const uint8_t *custom,
+                         size_t customlen)
+{
+  parallelhash(out, outlen, SHAKE128_RATE, in, inlen, blocklen,
+               custom, customlen, 1);
+}
+
+/*************************************************
+ * Name:        parallelhash256_xof
+ *
+ * Description: ParallelHashXOF256
+ *
+ * Arguments:   - uint8_t *out: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - size_t blocklen: block size B in bytes, not 0
+ *              - const uint8_t *custom: customization string S
+ *              - size_t customlen: length of S in bytes
+ **************************************************/
+void parallelhash256_xof(uint8_t *out,
+                         size_t outlen,
+                         const uint8_t *in,
+                         size_t inlen,
+                         size_t blocklen,
+                         const uint8_t *custom,
+                         size_t customlen)
+{
+  parallelhash(out, outlen, SHAKE256_RATE, in, inlen, blocklen,
+               custom, customlen, 1);
+}
+
+/*************************************************
+ * Name:        cshake128x2
+ *
+ * Description: cSHAKE128 XOF on two inputs of the same length
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in0, *in1: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - const uint8_t *name, *custom: N and S
+ *              - size_t namelen, customlen: length of N and S in bytes
+ **************************************************/
+void cshake128x2(uint8_t *out0,
+                 uint8_t *out1,
+                 size_t outlen,
+                 const uint8_t *in0,
+                 const uint8_t *in1,
+                 size_t inlen,
+                 const uint8_t *name,
+                 size_t namelen,
+                 const uint8_t *custom,
+                 size_t customlen)
+{
+  cshakex2(out0, out1, outlen, SHAKE128_RATE, in0, in1, inlen,
+           name, namelen, custom, customlen);
+}
+
+/*************************************************
+ * Name:        cshake256x2
+ *
+ * Description: cSHAKE256 XOF on two inputs of the same length
+ *
+ * Arguments:   - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in0, *in1: pointer to input
+ *              - size_t inlen: length of input in bytes
+ *              - const uint8_t *name, *custom: N and S
+ *              - size_t namelen, customlen: length of N and S in bytes
+ **************************************************/
+void cshake256x2(uint8_t *out0,
+                 uint8_t *out1,
+                 size_t outlen,
+                 const uint8_t *in0,
+                 const uint8_t *in1,
+                 size_t inlen,
+                 const uint8_t *name,
+                 size_t namelen,
+                 const uint8_t *custom,
+                 size_t customlen)
+{
+  cshakex2(out0, out1, outlen, SHAKE256_RATE, in0, in1, inlen,
+           name, namelen, custom, customlen);
+}
+
+/*************************************************
+ * Name:        kmac128_init_key
+ *
+ * Description: Key schedule for KMAC128 and KMACXOF128
+ *
+ * Arguments:   - kmac_key *key: pointer to output key schedule
+ *              - const uint8_t *k: pointer to key
+ *              - size_t klen: length of key in bytes
+ *              - const uint8_t *custom: customization string S
+ *              - size_t customlen: length of S in bytes
+ **************************************************/
+void kmac128_init_key(kmac_key *key,
+                      const uint8_t *k,
+                      size_t klen,
+                      const uint8_t *custom,
+                      size_t customlen)
+{
+  kmac_init_key(key, SHAKE128_RATE, k, klen, custom, customlen);
+}
+
+/*************************************************
+ * Name:        kmac256_init_key
+ *
+ * Description: Key schedule for KMAC256 and KMACXOF256
+ *
+ * Arguments:   - kmac_key *key: pointer to output key schedule
+ *              - const uint8_t *k: pointer to key
+ *              - size_t klen: length of key in bytes
+ *              - const uint8_t *custom: customization string S
+ *              - size_t customlen: length of S in bytes
+ **************************************************/
+void kmac256_init_key(kmac_key *key,
+                      const uint8_t *k,
+                      size_t klen,
+                      const uint8_t *custom,
+                      size_t customlen)
+{
+  kmac_init_key(key, SHAKE256_RATE, k, klen, custom, customlen);
+}
+
+/*************************************************
+ * Name:        kmac128x2
+ *
+ * Description: KMAC128 of two messages of the same length
+ *
+ * Arguments:   - const kmac_key *key: from kmac128_init_key
+ *              - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in0, *in1: pointer to input
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void kmac128x2(const kmac_key *key,
+               uint8_t *out0,
+               uint8_t *out1,
+               size_t outlen,
+               const uint8_t *in0,
+               const uint8_t *in1,
+               size_t inlen)
+{
+  kmacx2(key, out0, out1, outlen, in0, in1, inlen, 0);
+}
+
+/*************************************************
+ * Name:        kmac256x2
+ *
+ * Description: KMAC256 of two messages of the same length
+ *
+ * Arguments:   - const kmac_key *key: from kmac256_init_key
+ *              - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in0, *in1: pointer to input
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void kmac256x2(const kmac_key *key,
+               uint8_t *out0,
+               uint8_t *out1,
+               size_t outlen,
+               const uint8_t *in0,
+               const uint8_t *in1,
+               size_t inlen)
+{
+  kmacx2(key, out0, out1, outlen, in0, in1, inlen, 0);
+}
+
+/*************************************************
+ * Name:        kmacxof128x2
+ *
+ * Description: KMACXOF128 of two messages of the same length
+ *
+ * Arguments:   - const kmac_key *key: from kmac128_init_key
+ *              - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in0, *in1: pointer to input
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void kmacxof128x2(const kmac_key *key,
+                  uint8_t *out0,
+                  uint8_t *out1,
+                  size_t outlen,
+                  const uint8_t *in0,
+                  const uint8_t *in1,
+                  size_t inlen)
+{
+  kmacx2(key, out0, out1, outlen, in0, in1, inlen, 1);
+}
+
+/*************************************************
+ * Name:        kmacxof256x2
+ *
+ * Description: KMACXOF256 of two messages of the same length
+ *
+ * Arguments:   - const kmac_key *key: from kmac256_init_key
+ *              - uint8_t *out0, *out1: pointer to output
+ *              - size_t outlen: requested output length in bytes
+ *              - const uint8_t *in0, *in1: pointer to input
+ *              - size_t inlen: length of input in bytes
+ **************************************************/
+void kmacxof256x2(const kmac_key *key,
+                  uint8_t *out0,
+                  uint8_t *out1,
+                  size_t outlen,
+                  const uint8_t *in0,
+                  const uint8_t *in1,
+                  size_t inlen)
+{
+  kmacx2(key, out0, out1, outlen, in0, in1, inlen, 1);
+}
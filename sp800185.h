@@ -0,0 +1,161 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#ifndef SP800185_H
+#define SP800185_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * NIST SP 800-185 functions. name is the function-name string N,
+ * custom the customization string S, both may be empty.
+ */
+
+void cshake128(uint8_t *out,
+               size_t outlen,
+               const uint8_t *in,
+               size_t inlen,
+               const uint8_t *name,
+               size_t namelen,
+               const uint8_t *custom,
+               size_t customlen);
+
+void cshake256(uint8_t *out,
+               size_t outlen,
+               const uint8_t *in,
+               size_t inlen,
+               const uint8_t *name,
+               size_t namelen,
+               const uint8_t *custom,
+               size_t customlen);
+
+/*
+ * ParallelHash: blocks of blocklen > 0 bytes are hashed two at a time
+ * on the 2-way permutation, the chaining values by a scalar cSHAKE.
+ * The _xof variants do not bind the output length.
+ */
+void parallelhash128(uint8_t *out,
+                     size_t outlen,
+                     const uint8_t *in,
+                     size_t inlen,
+                     size_t blocklen,
+                     const uint8_t *custom,
+                     size_t customlen);
+
+void parallelhash256(uint8_t *out,
+                     size_t outlen,
+                     const uint8_t *in,
+                     size_t inlen,
+                     size_t blocklen,
+                     const uint8_t *custom,
+                     size_t customlen);
+
+void parallelhash128_xof(uint8_t *out,
+                         size_t outlen,
+                         const uint8_t *in,
+                         size_t inlen,
+                         size_t blocklen,
+                         const uint8_t *custom,
+                         size_t customlen);
+
+void parallelhash256_xof(uint8_t *out,
+                         size_t outlen,
+                         const uint8_t *in,
+                         size_t inlen,
+                         size_t blocklen,
+                         const uint8_t *custom,
+                         size_t customlen);
+
+/*
+ * Two inputs of the same length at once
+ */
+void cshake128x2(uint8_t *out0,
+                 uint8_t *out1,
+                 size_t outlen,
+                 const uint8_t *in0,
+                 const uint8_t *in1,
+                 size_t inlen,
+                 const uint8_t *name,
+                 size_t namelen,
+                 const uint8_t *custom,
+                 size_t customlen);
+
+void cshake256x2(uint8_t *out0,
+                 uint8_t *out1,
+                 size_t outlen,
+                 const uint8_t *in0,
+                 const uint8_t *in1,
+                 size_t inlen,
+                 const uint8_t *name,
+                 size_t namelen,
+                 const uint8_t *custom,
+                 size_t customlen);
+
+/*
+ * KMAC key schedule: the cSHAKE prefix for N = "KMAC" and S, then
+ * bytepad(encode_string(K)), absorbed once per key and copied to both
+ * lanes of every kmac*x2 call, which then only absorbs the messages
+ */
+typedef struct {
+  uint64_t s[25];
+  unsigned int r;
+} kmac_key;
+
+void kmac128_init_key(kmac_key *key,
+                      const uint8_t *k,
+                      size_t klen,
+                      const uint8_t *custom,
+                      size_t customlen);
+
+void kmac256_init_key(kmac_key *key,
+                      const uint8_t *k,
+                      size_t klen,
+                      const uint8_t *custom,
+                      size_t customlen);
+
+void kmac128x2(const kmac_key *key,
+               uint8_t *out0,
+               uint8_t *out1,
+               size_t outlen,
+               const uint8_t *in0,
+               const uint8_t *in1,
+               size_t inlen);
+
+void kmac256x2(const kmac_key *key,
+               uint8_t *out0,
+               uint8_t *out1,
+               size_t outlen,
+               const uint8_t *in0,
+               const uint8_t *in1,
+               size_t inlen);
+
+void kmacxof128x2(const kmac_key *key,
+                  uint8_t *out0,
+                  uint8_t *out1,
+                  size_t outlen,
+                  const uint8_t *in0,
+                  const uint8_t *in1,
+                  size_t inlen);
+
+void kmacxof256x2(const kmac_key *key,
+                  uint8_t *out0,
+                  uint8_t *out1,
+                  size_t outlen,
+                  const uint8_t *in0,
+                  const uint8_t *in1,
+                  size_t inlen);
+
+#endif
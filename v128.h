@@ -0,0 +1,367 @@
+/*=============================================================================
+ * Copyright (c) 2020 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=============================================================================*/
+#ifndef V128_H
+#define V128_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Two Keccak lanes, one per message: lane 0 is message 0, lane 1 is
+ * message 1, in memory as { lane 0, lane 1 }.
+ *
+ * The backend is chosen at compile time:
+ *  - NEON on AArch64, and on 32-bit Arm built with NEON (-mfpu=neon),
+ *    where V128_NEON_A32 is also defined: no vzip1q_u64/vzip2q_u64 or
+ *    lane copies there, the helpers recombine the d halves instead,
+ *  - SSE2 on x86-64 (part of the baseline ISA),
+ *  - portable C elsewhere.
+ * Defining one of V128_NEON, V128_SSE2 or V128_PORTABLE overrides it.
+ * The sponge code only uses the v128_* helpers below, the permutation
+ * kernels use the native intrinsics of their backend and the v128_*
+ * loads for the blocks they absorb.
+ */
+#if !defined(V128_NEON) && !defined(V128_SSE2) && !defined(V128_PORTABLE)
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define V128_NEON
+#elif defined(__arm__) && defined(__ARM_NEON)
+#define V128_NEON
+#elif defined(__x86_64__) || defined(_M_X64)
+#define V128_SSE2
+#else
+#define V128_PORTABLE
+#endif
+#endif
+
+#if defined(V128_NEON) && !defined(__aarch64__) && !defined(_M_ARM64)
+#define V128_NEON_A32
+#endif
+
+#if defined(V128_NEON)
+
+#include <arm_neon.h>
+
+typedef uint64x2_t v128;
+
+#elif defined(V128_SSE2)
+
+#include <emmintrin.h>
+
+typedef __m128i v128;
+
+#else
+
+typedef struct {
+  uint64_t v[2];
+} v128;
+
+#endif
+
+/*************************************************
+ * Name:        v128_load64
+ *
+ * Description: Load 8 bytes into uint64_t in little-endian order
+ *
+ * Arguments:   - const uint8_t *x: pointer to input byte array
+ *
+ * Returns the loaded 64-bit unsigned integer
+ **************************************************/
+static inline uint64_t v128_load64(const uint8_t *x)
+{
+#if defined(V128_PORTABLE)
+  unsigned int i;
+  uint64_t r = 0;
+
+  for (i = 0; i < 8; ++i)
+    r |= (uint64_t)x[i] << 8 * i;
+
+  return r;
+#else
+  uint64_t r;
+
+  memcpy(&r, x, 8);
+  return r;
+#endif
+}
+
+/*************************************************
+ * Name:        v128_store64
+ *
+ * Description: Store a 64-bit integer to 8 bytes in little-endian order
+ *
+ * Arguments:   - uint8_t *x: pointer to the output byte array
+ *              - uint64_t u: input 64-bit unsigned integer
+ **************************************************/
+static inline void v128_store64(uint8_t *x, uint64_t u)
+{
+#if defined(V128_PORTABLE)
+  unsigned int i;
+
+  for (i = 0; i < 8; ++i)
+    x[i] = u >> 8 * i;
+#else
+  memcpy(x, &u, 8);
+#endif
+}
+
+// { 0, 0 }
+static inline v128 v128_zero(void)
+{
+#if defined(V128_NEON)
+  return vdupq_n_u64(0);
+#elif defined(V128_SSE2)
+  return _mm_setzero_si128();
+#else
+  v128 r = {{0, 0}};
+  return r;
+#endif
+}
+
+// { a, a }
+static inline v128 v128_dup(uint64_t a)
+{
+#if defined(V128_NEON)
+  return vdupq_n_u64(a);
+#elif defined(V128_SSE2)
+  return _mm_set1_epi64x((long long)a);
+#else
+  v128 r = {{a, a}};
+  return r;
+#endif
+}
+
+// { a0, a1 }
+static inline v128 v128_set(uint64_t a0, uint64_t a1)
+{
+#if defined(V128_NEON)
+  return vcombine_u64(vcreate_u64(a0), vcreate_u64(a1));
+#elif defined(V128_SSE2)
+  return _mm_set_epi64x((long long)a1, (long long)a0);
+#else
+  v128 r = {{a0, a1}};
+  return r;
+#endif
+}
+
+// a0
+static inline uint64_t v128_lane0(v128 a)
+{
+#if defined(V128_NEON)
+  return vgetq_lane_u64(a, 0);
+#elif defined(V128_SSE2)
+  return (uint64_t)_mm_cvtsi128_si64(a);
+#else
+  return a.v[0];
+#endif
+}
+
+// a1
+static inline uint64_t v128_lane1(v128 a)
+{
+#if defined(V128_NEON)
+  return vgetq_lane_u64(a, 1);
+#elif defined(V128_SSE2)
+  return (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(a, a));
+#else
+  return a.v[1];
+#endif
+}
+
+// a ^ b
+static inline v128 v128_xor(v128 a, v128 b)
+{
+#if defined(V128_NEON)
+  return veorq_u64(a, b);
+#elif defined(V128_SSE2)
+  return _mm_xor_si128(a, b);
+#else
+  v128 r = {{a.v[0] ^ b.v[0], a.v[1] ^ b.v[1]}};
+  return r;
+#endif
+}
+
+// a & b
+static inline v128 v128_and(v128 a, v128 b)
+{
+#if defined(V128_NEON)
+  return vandq_u64(a, b);
+#elif defined(V128_SSE2)
+  return _mm_and_si128(a, b);
+#else
+  v128 r = {{a.v[0] & b.v[0], a.v[1] & b.v[1]}};
+  return r;
+#endif
+}
+
+// a | b
+static inline v128 v128_or(v128 a, v128 b)
+{
+#if defined(V128_NEON)
+  return vorrq_u64(a, b);
+#elif defined(V128_SSE2)
+  return _mm_or_si128(a, b);
+#else
+  v128 r = {{a.v[0] | b.v[0], a.v[1] | b.v[1]}};
+  return r;
+#endif
+}
+
+// { a0 << n, a1 << n }, n below 64 and not necessarily a constant
+static inline v128 v128_shl(v128 a, unsigned int n)
+{
+#if defined(V128_NEON)
+  return vshlq_u64(a, vdupq_n_s64((int64_t)n));
+#elif defined(V128_SSE2)
+  return _mm_sll_epi64(a, _mm_cvtsi32_si128((int)n));
+#else
+  v128 r = {{a.v[0] << n, a.v[1] << n}};
+  return r;
+#endif
+}
+
+// { a0 >> n, a1 >> n }, n below 64 and not necessarily a constant
+static inline v128 v128_shr(v128 a, unsigned int n)
+{
+#if defined(V128_NEON)
+  return vshlq_u64(a, vdupq_n_s64(-(int64_t)n));
+#elif defined(V128_SSE2)
+  return _mm_srl_epi64(a, _mm_cvtsi32_si128((int)n));
+#else
+  v128 r = {{a.v[0] >> n, a.v[1] >> n}};
+  return r;
+#endif
+}
+
+// a - b, 64-bit lanes
+static inline v128 v128_sub(v128 a, v128 b)
+{
+#if defined(V128_NEON)
+  return vsubq_u64(a, b);
+#elif defined(V128_SSE2)
+  return _mm_sub_epi64(a, b);
+#else
+  v128 r = {{a.v[0] - b.v[0], a.v[1] - b.v[1]}};
+  return r;
+#endif
+}
+
+// { a0, b1 }: lane 0 of a, lane 1 of b
+static inline v128 v128_merge(v128 a, v128 b)
+{
+#if defined(V128_NEON)
+#if defined(V128_NEON_A32)
+  return vcombine_u64(vget_low_u64(a), vget_high_u64(b));
+#else
+  return vcopyq_laneq_u64(a, 1, b, 1);
+#endif
+#elif defined(V128_SSE2)
+  return _mm_castpd_si128(_mm_move_sd(_mm_castsi128_pd(b),
+                                      _mm_castsi128_pd(a)));
+#else
+  v128 r = {{a.v[0], b.v[1]}};
+  return r;
+#endif
+}
+
+// { a0, b0 }, also the unzip of the first lanes
+static inline v128 v128_zip0(v128 a, v128 b)
+{
+#if defined(V128_NEON)
+#if defined(V128_NEON_A32)
+  return vcombine_u64(vget_low_u64(a), vget_low_u64(b));
+#else
+  return vzip1q_u64(a, b);
+#endif
+#elif defined(V128_SSE2)
+  return _mm_unpacklo_epi64(a, b);
+#else
+  v128 r = {{a.v[0], b.v[0]}};
+  return r;
+#endif
+}
+
+// { a1, b1 }, also the unzip of the second lanes
+static inline v128 v128_zip1(v128 a, v128 b)
+{
+#if defined(V128_NEON)
+#if defined(V128_NEON_A32)
+  return vcombine_u64(vget_high_u64(a), vget_high_u64(b));
+#else
+  return vzip2q_u64(a, b);
+#endif
+#elif defined(V128_SSE2)
+  return _mm_unpackhi_epi64(a, b);
+#else
+  v128 r = {{a.v[1], b.v[1]}};
+  return r;
+#endif
+}
+
+// Two consecutive little-endian words of one message: { x[0..7], x[8..15] }
+static inline v128 v128_load(const uint8_t *x)
+{
+#if defined(V128_NEON)
+  return vreinterpretq_u64_u8(vld1q_u8(x));
+#elif defined(V128_SSE2)
+  return _mm_loadu_si128((const __m128i *)x);
+#else
+  return v128_set(v128_load64(x), v128_load64(x + 8));
+#endif
+}
+
+// Store two consecutive words of one message
+static inline void v128_store(uint8_t *x, v128 a)
+{
+#if defined(V128_NEON)
+  vst1q_u8(x, vreinterpretq_u8_u64(a));
+#elif defined(V128_SSE2)
+  _mm_storeu_si128((__m128i *)x, a);
+#else
+  v128_store64(x, a.v[0]);
+  v128_store64(x + 8, a.v[1]);
+#endif
+}
+
+// One word of each message: { x0[0..7], x1[0..7] }
+static inline v128 v128_load2(const uint8_t *x0, const uint8_t *x1)
+{
+#if defined(V128_NEON)
+  return vcombine_u64(vreinterpret_u64_u8(vld1_u8(x0)),
+                      vreinterpret_u64_u8(vld1_u8(x1)));
+#elif defined(V128_SSE2)
+  return _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)x0),
+                            _mm_loadl_epi64((const __m128i *)x1));
+#else
+  return v128_set(v128_load64(x0), v128_load64(x1));
+#endif
+}
+
+// Lane 0 to x0, lane 1 to x1
+static inline void v128_store2(uint8_t *x0, uint8_t *x1, v128 a)
+{
+#if defined(V128_NEON)
+  vst1_u8(x0, vreinterpret_u8_u64(vget_low_u64(a)));
+  vst1_u8(x1, vreinterpret_u8_u64(vget_high_u64(a)));
+#elif defined(V128_SSE2)
+  _mm_storel_epi64((__m128i *)x0, a);
+  _mm_storel_epi64((__m128i *)x1, _mm_unpackhi_epi64(a, a));
+#else
+  v128_store64(x0, a.v[0]);
+  v128_store64(x1, a.v[1]);
+#endif
+}
+
+#endif